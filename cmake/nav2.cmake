@@ -0,0 +1,64 @@
+# ROS 2 / Nav2 build, included by CMakeLists.txt when ROS_VERSION is 2
+set(CMAKE_CXX_STANDARD 17)
+set(CMAKE_CXX_STANDARD_REQUIRED ON)
+
+find_package(ament_cmake REQUIRED)
+find_package(geometry_msgs REQUIRED)
+find_package(nav2_core REQUIRED)
+find_package(nav2_costmap_2d REQUIRED)
+find_package(nav2_util REQUIRED)
+find_package(nav_msgs REQUIRED)
+find_package(pluginlib REQUIRED)
+find_package(rclcpp REQUIRED)
+find_package(rclcpp_lifecycle REQUIRED)
+find_package(tf2 REQUIRED)
+find_package(tf2_ros REQUIRED)
+
+set(nav2_dependencies
+    geometry_msgs
+    nav2_core
+    nav2_costmap_2d
+    nav2_util
+    nav_msgs
+    pluginlib
+    rclcpp
+    rclcpp_lifecycle
+    tf2
+    tf2_ros
+    )
+
+include_directories(include)
+
+# The coverage engines and the plan conversion do not depend on ROS, only the plugin itself does
+add_library(nav2_${PROJECT_NAME} SHARED
+        src/common.cpp
+        src/contour_coverage.cpp
+        src/costmap_grid.cpp
+        src/grid_inflation.cpp
+        src/interval_grid.cpp
+        src/nav2_spiral_stc.cpp
+        src/spiral_coverage.cpp
+        src/stroke_joins.cpp
+        )
+ament_target_dependencies(nav2_${PROJECT_NAME} ${nav2_dependencies})
+
+pluginlib_export_plugin_description_file(nav2_core fcpp_nav2_plugin.xml)
+
+install(TARGETS nav2_${PROJECT_NAME}
+        ARCHIVE DESTINATION lib
+        LIBRARY DESTINATION lib
+        RUNTIME DESTINATION bin
+        )
+
+install(DIRECTORY include/
+        DESTINATION include/
+        )
+
+install(FILES launch/nav2_coverage.launch.py launch/nav2_coverage_params.yaml
+        DESTINATION share/${PROJECT_NAME}/launch
+        )
+
+ament_export_include_directories(include)
+ament_export_libraries(nav2_${PROJECT_NAME})
+ament_export_dependencies(${nav2_dependencies})
+ament_package()
@@ -0,0 +1,121 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <list>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_BENCHMARK_H
+#define FULL_COVERAGE_PATH_PLANNER_BENCHMARK_H
+
+#include "full_coverage_path_planner/common.h"
+#include "full_coverage_path_planner/perf_counters.h"
+#include "full_coverage_path_planner/stroke_joins.h"
+
+/*
+ * Helpers of the quality-versus-runtime benchmark (fcpp_benchmark): planner settings per run, plan quality metrics,
+ * hardware counters per phase, Pareto front and CSV/JSON output
+ */
+namespace full_coverage_path_planner
+{
+/**
+ * Planner settings of a benchmark run
+ */
+struct BenchmarkConfig
+{
+  std::string name;
+  std::string engine;  ///< Coverage engine, spiral_stc or contour
+  double robot_radius;
+  double tool_radius;
+  std::string footprint_model;  ///< square, circle
+  std::string join_style;  ///< none, half_circle, mwm
+};
+
+/**
+ * Phases of a run that hardware counters are reported for
+ */
+enum BenchmarkPhase
+{
+  ePhaseParse = 0,   ///< parseGrid
+  ePhaseCoverage,    ///< Coverage engine, including ePhaseAStar
+  ePhaseAStar,       ///< Escapes of spiral_stc with A* (a_star_to_open_space) and the bookkeeping around them
+  ePhaseConversion,  ///< parsePointlist2Plan and smoothPlan
+  ePhaseCount,
+};
+
+/** Name of a phase, as used in the output, e.g. "a_star" */
+char const* benchmarkPhaseName(int phase);
+
+/**
+ * Measurements of a single run. Plain data, so it can be passed from the process that ran it
+ */
+struct BenchmarkMetrics
+{
+  bool success;
+  double wall_time_s;  ///< Median over the repeats of the time from the map to the final plan
+  double parse_time_s;  ///< Median time of parseGrid
+  /** Peak resident memory of the process of the run, including the map */
+  long peak_memory_kb;  // NOLINT
+  double path_length_m;
+  double total_rotation_rad;  ///< Sum of the absolute heading changes along the plan
+  int turns;  ///< Direction changes of the tile walk
+  int waypoint_count;
+  int multiple_pass_counter;
+  int accessible_counter;
+  int grid_cells;  ///< Tiles of the grid, to report the counters per cell
+  /** Mean over the repeats per phase, all events -1 when the counters were not collected */
+  PerfCounts counts[ePhaseCount];
+};
+
+struct BenchmarkResult
+{
+  std::string map;
+  BenchmarkConfig config;
+  BenchmarkMetrics metrics;
+  bool pareto;  ///< Not dominated by another configuration on the same map
+};
+
+/**
+ * Parse a configuration, e.g. "name=fast,tool_radius=0.3,join_style=mwm". Unset fields keep their value
+ * @return false on unknown keys or values
+ */
+bool parseBenchmarkConfig(std::string const& spec, BenchmarkConfig& config);
+
+/**
+ * Default set of configurations: every engine, footprint model and join style
+ */
+std::vector<BenchmarkConfig> defaultBenchmarkConfigs(double robot_radius, double tool_radius);
+
+/**
+ * Number of direction changes of a tile walk
+ */
+int countTurns(std::list<Point_t> const& walk);
+
+/**
+ * Path length and total rotation of a plan
+ */
+void measurePlan(std::vector<Waypoint> const& plan, BenchmarkMetrics& metrics);
+
+/**
+ * Mark the results that are on the Pareto front of their map: no other successful result on that map is at least as
+ * good in wall time, peak memory, path length, turns, multiple passes and accessible cells, and better in one of them
+ */
+void markParetoFront(std::vector<BenchmarkResult>& results);
+
+void writeCsv(std::ostream& out, std::vector<BenchmarkResult> const& results);
+
+void writeJson(std::ostream& out, std::vector<BenchmarkResult> const& results);
+
+/**
+ * Human-readable summary of the Pareto front per map
+ */
+void writeParetoSummary(std::ostream& out, std::vector<BenchmarkResult> const& results);
+
+/**
+ * Human-readable table of the hardware counters per phase and per grid cell of every result that has them, next to
+ * its wall time
+ */
+void writeCounterSummary(std::ostream& out, std::vector<BenchmarkResult> const& results);
+}  // namespace full_coverage_path_planner
+#endif  // FULL_COVERAGE_PATH_PLANNER_BENCHMARK_H
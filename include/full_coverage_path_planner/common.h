@@ -3,6 +3,8 @@
 //
 // Created by nobleo on 6-9-18.
 //
+#include <stdint.h>
+
 #include <climits>
 #include <fstream>
 #include <list>
@@ -68,6 +70,7 @@ enum
  * @return Distance to the closest point (out of 'goals') to 'poi'
  */
 int distanceToClosestPoint(Point_t poi, std::list<Point_t> const &goals);
+int distanceToClosestPoint(Point_t poi, std::vector<Point_t> const &goals);
 
 /**
  * Calculate the distance between two points, squared
@@ -89,33 +92,40 @@ bool a_star_to_open_space(std::vector<std::vector<bool> > const &grid, gridNode_
                           std::list<gridNode_t> &pathNodes);
 
 /**
- * Print a grid according to the internal representation
- * @param grid
- * @param visited
- * @param fullPath
- */
-void printGrid(std::vector<std::vector<bool> > const& grid,
-               std::vector<std::vector<bool> > const& visited,
-               std::list<Point_t> const& path);
-
-/**
- * Print a grid according to the internal representation
- * @param grid
- * @param visited
- * @param fullPath
- * @param start
- * @param end
+ * Buffers of a_star_to_open_space that are kept between searches, so a search does not allocate once they have grown
+ * to the size of the grid
  */
-void printGrid(std::vector<std::vector<bool> > const& grid,
-               std::vector<std::vector<bool> > const& visited,
-               std::list<gridNode_t> const& path,
-               gridNode_t start,
-               gridNode_t end);
+struct AStarWorkspace
+{
+  AStarWorkspace() : generation(0), expansions(0)
+  {
+  }
+
+  std::vector<gridNode_t> nodes;  ///< Last node of every path that was opened
+  std::vector<int> parents;  ///< Per node, the index of the node before it on its path, -1 for the initial node
+  std::vector<int> open;  ///< Open paths, as the index of their last node
+  std::vector<uint32_t> closed;  ///< Row-major, a cell is closed when it holds the generation of the current search
+  uint32_t generation;
+  std::vector<gridNode_t> trace;
+  uint64_t expansions;  ///< Number of paths taken from the open list, summed over searches until reset by the caller
+};
 
 /**
- * Print a 2D array of bools to stdout
+ * Same as a_star_to_open_space above, without allocations once the workspace has grown to the size of the grid.
+ * Paths are stored as a tree of nodes instead of being copied, the search and its result are the same
+ * @param grid 2D grid of bools. true == occupied/blocked/obstacle
+ * @param init start position
+ * @param cost cost of traversing a free node
+ * @param visited grid 2D grid of bools. true == visited
+ * @param open_space Open space that A* need to find a path towards. Only used for the heuristic and directing search
+ * @param workspace buffers reused between searches
+ * @param pathNodes the path from init to open space is appended to it. When resigning, it is replaced by its last
+ *                  node and init
+ * @return whether we resign from finding a path or not. true is we resign and false if we found a path
  */
-void printGrid(std::vector<std::vector<bool> > const& grid);
+bool a_star_to_open_space(std::vector<std::vector<bool> > const &grid, gridNode_t init, int cost,
+                          std::vector<std::vector<bool> > const &visited, std::vector<Point_t> const &open_space,
+                          AStarWorkspace &workspace, std::vector<gridNode_t> &pathNodes);
 
 /**
  * Convert 2D grid of bools to a list of Point_t
@@ -124,4 +134,19 @@ void printGrid(std::vector<std::vector<bool> > const& grid);
  * @return a list of points that have the given value_to_search
  */
 std::list<Point_t> map_2_goals(std::vector<std::vector<bool> > const& grid, bool value_to_search);
+
+/**
+ * Same as map_2_goals above, into a vector that keeps its capacity between calls
+ * @param grid 2D grid representing a map
+ * @param value_to_search points matching this value will be returned
+ * @param goals output, the points that have the given value_to_search
+ */
+void map_2_goals(std::vector<std::vector<bool> > const& grid, bool value_to_search, std::vector<Point_t>& goals);
+
+/**
+ * Mark all cells of the grid whose center lies outside a polygon as blocked
+ * @param grid 2D grid of bools. true == occupied/blocked/obstacle
+ * @param polygon vertices of the polygon in grid coordinates, i.e. cell (x, y) spans [x, x + 1) x [y, y + 1)
+ */
+void maskOutsidePolygon(std::vector<std::vector<bool> >& grid, std::vector<fPoint_t> const& polygon);
 #endif  // FULL_COVERAGE_PATH_PLANNER_COMMON_H
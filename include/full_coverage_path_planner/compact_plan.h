@@ -0,0 +1,290 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_COMPACT_PLAN_H
+#define FULL_COVERAGE_PATH_PLANNER_COMPACT_PLAN_H
+
+/*
+ * Compact representation of a coverage plan: an axis-aligned walk over tiles, given as a start tile and a
+ * run-length encoded direction string, e.g. "R12U1L12U1R12" (R = +x, U = +y, L = -x, D = -y).
+ * See the CompactCoveragePlan message. Header-only, so consumers do not need to link the planner.
+ */
+namespace full_coverage_path_planner
+{
+const long kMaxRunLength = 1000000000;  // NOLINT
+
+/** Pose on a compact plan, in the frame of the CompactCoveragePlan message */
+struct CompactPose
+{
+  double x;
+  double y;
+  double yaw;
+};
+
+/**
+ * Run-length encode a walk over tiles
+ * @param begin, end tiles (anything with .x and .y) of the walk; repeated tiles are skipped and steps of more than
+ *        one tile are split in an x and a y run
+ * @return direction string, empty for a walk of a single tile
+ */
+template <class Iterator>
+std::string encodeDirections(Iterator begin, Iterator end)
+{
+  std::string directions;
+  if (begin == end)
+  {
+    return directions;
+  }
+  char run_direction = 0;
+  long run_length = 0;  // NOLINT
+  int x = begin->x, y = begin->y;
+  for (Iterator it = begin; it != end; ++it)
+  {
+    for (int axis = 0; axis < 2; ++axis)
+    {
+      int delta = axis == 0 ? it->x - x : it->y - y;
+      if (delta == 0)
+      {
+        continue;
+      }
+      char direction = axis == 0 ? (delta > 0 ? 'R' : 'L') : (delta > 0 ? 'U' : 'D');
+      if (direction != run_direction && run_length > 0)
+      {
+        directions += run_direction + std::to_string(run_length);
+        run_length = 0;
+      }
+      run_direction = direction;
+      run_length += std::abs(delta);
+    }
+    x = it->x;
+    y = it->y;
+  }
+  if (run_length > 0)
+  {
+    directions += run_direction + std::to_string(run_length);
+  }
+  return directions;
+}
+
+/**
+ * Lazy expansion of a compact plan into poses at the tile centers, one pose per call to next()
+ */
+class CompactPlanDecoder
+{
+public:
+  enum Mode
+  {
+    ePosesPerTile,  ///< One pose per tile of the walk
+    ePosesAtCorners  ///< Only the start, corners (twice: incoming and outgoing heading) and end, like the Path plan
+  };
+
+  /**
+   * @param origin_x, origin_y position of the corner of tile (0, 0) [m]
+   * @param tile_size size of a tile [m]
+   * @param start_x, start_y first tile of the walk
+   * @param directions run-length encoded direction string
+   * @param mode which poses are generated
+   */
+  CompactPlanDecoder(double origin_x, double origin_y, double tile_size, int start_x, int start_y,
+                     std::string const& directions, Mode mode = ePosesPerTile)
+    : origin_x_(origin_x), origin_y_(origin_y), tile_size_(tile_size), directions_(directions), mode_(mode)
+  {
+    reset(start_x, start_y);
+  }
+
+  /**
+   * Decode a CompactCoveragePlan message (or anything with the same fields)
+   */
+  template <class Message>
+  explicit CompactPlanDecoder(Message const& msg, Mode mode = ePosesPerTile)
+    : origin_x_(msg.origin_x), origin_y_(msg.origin_y), tile_size_(msg.tile_size), directions_(msg.directions),
+      mode_(mode)
+  {
+    reset(msg.start_x, msg.start_y);
+  }
+
+  /**
+   * Generate the next pose
+   * @return false at the end of the plan or when the direction string is malformed, see valid()
+   */
+  bool next(CompactPose& pose)
+  {
+    if (first_)
+    {
+      // Start tile, heading along the first run
+      first_ = false;
+      done_ = !readRun();
+      heading_ = run_yaw_;
+      makePose(heading_, pose);
+      return valid_;
+    }
+    if (pending_corner_)
+    {
+      // Second pose of a corner: same position, outgoing heading
+      pending_corner_ = false;
+      heading_ = run_yaw_;
+      makePose(heading_, pose);
+      return true;
+    }
+    while (!done_)
+    {
+      if (run_remaining_ > 0)
+      {
+        x_ += dx_;
+        y_ += dy_;
+        --run_remaining_;
+        if (mode_ == ePosesPerTile)
+        {
+          makePose(heading_, pose);
+          return true;
+        }
+        continue;
+      }
+
+      // End of a run: corners and the end of the plan get a pose in both modes
+      if (!readRun())
+      {
+        done_ = true;
+        if (mode_ == ePosesAtCorners && valid_)
+        {
+          makePose(heading_, pose);
+          return true;
+        }
+        return false;
+      }
+      if (mode_ == ePosesAtCorners && run_yaw_ != heading_)
+      {
+        pending_corner_ = true;
+        makePose(heading_, pose);
+        return true;
+      }
+      heading_ = run_yaw_;
+    }
+    return false;
+  }
+
+  /**
+   * Expand the whole plan at once
+   */
+  void expand(std::vector<CompactPose>& poses)
+  {
+    CompactPose pose;
+    while (next(pose))
+    {
+      poses.push_back(pose);
+    }
+  }
+
+  /**
+   * Whether the direction string read so far is well-formed
+   */
+  bool valid() const
+  {
+    return valid_;
+  }
+
+  /**
+   * Number of tiles in the walk (including the start tile) without expanding it, 0 when the string is malformed
+   */
+  static long tileCount(std::string const& directions)  // NOLINT
+  {
+    long count = 1;  // NOLINT
+    size_t position = 0;
+    while (position < directions.size())
+    {
+      char direction;
+      long length;  // NOLINT
+      if (!parseRun(directions, position, direction, length))
+      {
+        return 0;
+      }
+      count += length;
+    }
+    return count;
+  }
+
+private:
+  void reset(int start_x, int start_y)
+  {
+    x_ = start_x;
+    y_ = start_y;
+    dx_ = 0;
+    dy_ = 0;
+    position_ = 0;
+    run_remaining_ = 0;
+    run_yaw_ = 0.0;
+    heading_ = 0.0;
+    first_ = true;
+    done_ = false;
+    pending_corner_ = false;
+    valid_ = true;
+  }
+
+  static bool parseRun(std::string const& directions, size_t& position, char& direction, long& length)  // NOLINT
+  {
+    direction = directions[position++];
+    if (direction != 'R' && direction != 'U' && direction != 'L' && direction != 'D')
+    {
+      return false;
+    }
+    length = 0;
+    size_t digits = position;
+    while (position < directions.size() && directions[position] >= '0' && directions[position] <= '9')
+    {
+      length = length * 10 + (directions[position++] - '0');
+      if (length > kMaxRunLength)
+      {
+        return false;
+      }
+    }
+    return position > digits && length > 0;
+  }
+
+  bool readRun()
+  {
+    if (position_ >= directions_.size())
+    {
+      return false;
+    }
+    char direction;
+    if (!parseRun(directions_, position_, direction, run_remaining_))
+    {
+      valid_ = false;
+      return false;
+    }
+    dx_ = direction == 'R' ? 1 : direction == 'L' ? -1 : 0;
+    dy_ = direction == 'U' ? 1 : direction == 'D' ? -1 : 0;
+    run_yaw_ = std::atan2(static_cast<double>(dy_), static_cast<double>(dx_));
+    return true;
+  }
+
+  void makePose(double yaw, CompactPose& pose) const
+  {
+    pose.x = x_ * tile_size_ + origin_x_ + tile_size_ * 0.5;
+    pose.y = y_ * tile_size_ + origin_y_ + tile_size_ * 0.5;
+    pose.yaw = yaw;
+  }
+
+  double origin_x_;
+  double origin_y_;
+  double tile_size_;
+  std::string directions_;
+  Mode mode_;
+
+  int x_, y_, dx_, dy_;
+  size_t position_;
+  long run_remaining_;  // NOLINT
+  double run_yaw_;
+  double heading_;
+  bool first_;
+  bool done_;
+  bool pending_corner_;
+  bool valid_;
+};
+}  // namespace full_coverage_path_planner
+#endif  // FULL_COVERAGE_PATH_PLANNER_COMPACT_PLAN_H
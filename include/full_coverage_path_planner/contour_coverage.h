@@ -0,0 +1,57 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <stdint.h>
+
+#include <vector>
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_CONTOUR_COVERAGE_H
+#define FULL_COVERAGE_PATH_PLANNER_CONTOUR_COVERAGE_H
+
+#include "full_coverage_path_planner/common.h"
+
+/*
+ * Contour-parallel coverage engine, an alternative to Spiral-STC. One distance transform of the tile grid splits the
+ * free tiles into layers: layer k holds the tiles at k tiles (one tool width each) from the closest obstacle. Every
+ * layer is an iso-contour that is followed as a loop along the obstacles, after which the walk steps inwards to the
+ * next layer. Only when the walk gets stuck (a layer split into pockets), a breadth-first search finds a short
+ * connector to the closest tile that is not covered yet. This replaces the A* escape per leftover pocket of the
+ * spiral by a breadth-first search that stops at the first tile that is not covered. The layers take two linear
+ * passes over the grid of n tiles. A search visits at most the tiles closer than its target, so k stuck points cost
+ * up to O(k * n), usually far less because the pockets are close to where the walk gets stuck.
+ */
+namespace full_coverage_path_planner
+{
+/**
+ * Buffers of contourCoverage that are kept between plans
+ */
+struct ContourWorkspace
+{
+  std::vector<int> layers;  ///< Row-major, see contourLayers
+  std::vector<uint8_t> visited;  ///< Row-major, blocked tiles count as visited
+  std::vector<int> parents;  ///< Row-major, tile before every tile of the connector search
+  std::vector<int> queue;
+  std::vector<Point_t> connector;
+};
+
+/**
+ * Chessboard distance transform of a tile grid, in two passes: the number of tiles from every free tile to the
+ * closest blocked tile or the border of the grid (a free tile at the border is in layer 1). Blocked tiles get 0
+ * @param grid 2D grid of bools. true == occupied/blocked/obstacle
+ * @param layers output, row-major
+ */
+void contourLayers(std::vector<std::vector<bool> > const& grid, std::vector<int>& layers);
+
+/**
+ * Cover all free tiles that can be reached from init by following the contours of contourLayers, outer layers first
+ * @param grid 2D grid of bools. true == occupied/blocked/obstacle
+ * @param init start position
+ * @param workspace buffers reused between plans
+ * @param fullPath output: 4-connected walk over the tiles, starting at init. Keeps its capacity
+ * @param multiple_pass_counter output: number of tiles of the walk that were covered before (the connectors)
+ * @param visited_counter output: number of tiles of the walk
+ */
+void contourCoverage(std::vector<std::vector<bool> > const& grid, Point_t const& init, ContourWorkspace& workspace,
+                     std::vector<Point_t>& fullPath, int& multiple_pass_counter, int& visited_counter);
+}  // namespace full_coverage_path_planner
+#endif  // FULL_COVERAGE_PATH_PLANNER_CONTOUR_COVERAGE_H
@@ -0,0 +1,69 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_COSTMAP_GRID_H
+#define FULL_COVERAGE_PATH_PLANNER_COSTMAP_GRID_H
+
+#include "full_coverage_path_planner/common.h"
+#include "full_coverage_path_planner/grid_inflation.h"
+
+/*
+ * Conversion of a costmap or occupancy map into the tile grid of the coverage engines, without ROS, for the Nav2
+ * plugin (nav2_spiral_stc.h)
+ */
+namespace full_coverage_path_planner
+{
+/**
+ * Size and position of a tile grid on a map
+ */
+struct TileGeometry
+{
+  double tile_size;  ///< [m]
+  double origin_x;   ///< Position of the corner of tile (0, 0) [m]
+  double origin_y;
+  int columns;
+  int rows;
+};
+
+/**
+ * Occupancy values of costmap costs: lethal_cost becomes an obstacle (100), every other cost free (0), also the
+ * inscribed and unknown costs
+ * @param costs row-major costs, e.g. Costmap2D::getCharMap
+ * @param cells number of cells
+ * @param lethal_cost cost of an obstacle, LETHAL_OBSTACLE of the costmap
+ * @param occupancy output, keeps its capacity
+ */
+void costsToOccupancy(unsigned char const* costs, size_t cells, unsigned char lethal_cost,
+                      std::vector<int8_t>& occupancy);
+
+/**
+ * Inflate the obstacles of a map into a tile grid, like FullCoveragePathPlanner::parseGrid without a region of
+ * interest. A tile is as wide as the tool diameter and the footprint is the robot diameter
+ * @param data row-major occupancy values. Values higher than kOccupiedThreshold are obstacles
+ * @param resolution size of a map cell [m]
+ * @param origin_x, origin_y position of the corner of map cell (0, 0) [m]
+ * @param robot_radius, tool_radius [m]
+ * @param geometry output geometry of the grid
+ * @param grid output grid, its rows keep their storage on a map of the same size. true == blocked
+ * @return false when the map is empty
+ */
+bool occupancyToTiles(int8_t const* data, int width, int height, double resolution, double origin_x, double origin_y,
+                      double robot_radius, double tool_radius, FootprintModel model, TileGeometry& geometry,
+                      std::vector<std::vector<bool> >& grid);
+
+/**
+ * Tile that contains a position, clamped to the grid
+ */
+Point_t worldToTile(TileGeometry const& geometry, double x, double y);
+
+/**
+ * Center of a tile
+ */
+void tileToWorld(TileGeometry const& geometry, Point_t const& tile, double& x, double& y);
+}  // namespace full_coverage_path_planner
+#endif  // FULL_COVERAGE_PATH_PLANNER_COSTMAP_GRID_H
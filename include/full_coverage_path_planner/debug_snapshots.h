@@ -0,0 +1,164 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <stdint.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_DEBUG_SNAPSHOTS_H
+#define FULL_COVERAGE_PATH_PLANNER_DEBUG_SNAPSHOTS_H
+
+#include "full_coverage_path_planner/snapshot_sink.h"
+
+/*
+ * Debug snapshots of the spiral_stc search, written by a background thread so the planner only copies the tile
+ * states into a pooled buffer and enqueues it. Either one PNG per snapshot or a compact binary log:
+ *
+ * snapshots.fcppsnap is a sequence of records: SnapshotRecordHeader, (width * height + 3) / 4 bytes of tile states
+ * (SnapshotTile, 2 bits per tile, row-major, least significant bits first), segment_count times int32 x, y.
+ */
+namespace full_coverage_path_planner
+{
+const uint32_t kSnapshotMagic = 0x53505046;  // "FPPS"
+const uint32_t kSnapshotVersion = 1;
+
+enum SnapshotTile
+{
+  eSnapshotFree = 0,
+  eSnapshotBlocked = 1,
+  eSnapshotVisited = 2,
+};
+
+struct SnapshotRecordHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t plan;  ///< Number of the plan since the writer was opened
+  uint32_t sequence;  ///< Number of the snapshot within the plan
+  int32_t stage;  ///< SnapshotStage
+  uint32_t width;
+  uint32_t height;
+  uint32_t goals;
+  uint32_t segment_count;
+};
+
+struct DebugSnapshot
+{
+  SnapshotRecordHeader header;
+  std::vector<uint8_t> tiles;  ///< SnapshotTile per tile, row-major (one byte per tile)
+  std::vector<Point_t> segment;
+};
+
+/**
+ * Read all records of a snapshot log
+ * @return false when the file can not be read or is not a log of this version
+ */
+bool readSnapshotLog(std::string const& file, std::vector<DebugSnapshot>& snapshots);
+
+/**
+ * Snapshot sink that encodes on a background thread. A fixed number of snapshot buffers is cycled between the
+ * planner and the writer: when all of them are still queued the snapshot is dropped instead of blocking the planner.
+ * Once the buffers have grown to the grid size, capturing does not allocate
+ */
+class AsyncSnapshotWriter : public SnapshotSink
+{
+public:
+  enum Format
+  {
+    ePng = 0,  ///< <directory>/plan<plan>_<sequence>_<stage>.png, y up
+    eLog = 1,  ///< <directory>/snapshots.fcppsnap, appended
+  };
+
+  AsyncSnapshotWriter();
+
+  /**
+   * Writes the queued snapshots and stops the thread
+   */
+  ~AsyncSnapshotWriter();
+
+  /**
+   * Start the writer thread, snapshots are only taken once enabled
+   * @param directory is created when it does not exist
+   * @param buffers number of snapshots that can be queued
+   * @return false when the directory can not be created
+   */
+  bool open(std::string const& directory, Format format, int buffers);
+
+  /**
+   * Write the queued snapshots and stop the thread
+   */
+  void close();
+
+  bool isOpen() const
+  {
+    return thread_.joinable();
+  }
+
+  /**
+   * Switch capturing on and off at runtime, off by default
+   */
+  void setEnabled(bool enabled)
+  {
+    enabled_ = enabled;
+  }
+
+  bool enabled() const
+  {
+    return enabled_ && isOpen();
+  }
+
+  /**
+   * Wait until all queued snapshots are written
+   */
+  void flush();
+
+  /**
+   * Number of snapshots dropped because all buffers were queued
+   */
+  uint64_t dropped() const;
+
+  void beginPlan();
+
+  void capture(SnapshotStage stage, std::vector<std::vector<bool> > const& grid,
+               std::vector<std::vector<bool> > const& visited, std::vector<gridNode_t> const& segment, size_t goals);
+
+  void capture(SnapshotStage stage, IntervalGrid const& grid, std::vector<bool> const& visited,
+               std::vector<gridNode_t> const& segment, size_t goals);
+
+private:
+  AsyncSnapshotWriter(AsyncSnapshotWriter const&);
+  AsyncSnapshotWriter& operator=(AsyncSnapshotWriter const&);
+
+  /**
+   * Take a free buffer and fill the header, NULL when there is none
+   */
+  DebugSnapshot* acquire(SnapshotStage stage, int width, int height, std::vector<gridNode_t> const& segment,
+                         size_t goals);
+  void enqueue(DebugSnapshot* snapshot);
+  void run();
+  bool write(DebugSnapshot const& snapshot);
+
+  std::string directory_;
+  Format format_;
+  bool enabled_;
+  uint32_t plan_;
+  uint32_t sequence_;
+
+  std::vector<DebugSnapshot> buffers_;
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;  ///< Signals the writer: queued snapshot or stop
+  std::condition_variable idle_;  ///< Signals flush: queue empty
+  std::vector<DebugSnapshot*> free_;
+  std::deque<DebugSnapshot*> queue_;
+  bool writing_;
+  bool stop_;
+  uint64_t dropped_;
+  std::thread thread_;
+};
+}  // namespace full_coverage_path_planner
+#endif  // FULL_COVERAGE_PATH_PLANNER_DEBUG_SNAPSHOTS_H
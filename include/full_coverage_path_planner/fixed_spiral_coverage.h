@@ -0,0 +1,416 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <bitset>
+#include <climits>
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_FIXED_SPIRAL_COVERAGE_H
+#define FULL_COVERAGE_PATH_PLANNER_FIXED_SPIRAL_COVERAGE_H
+
+#include "full_coverage_path_planner/common.h"
+
+/*
+ * Spiral-STC for small grids without any dynamic allocation, for targets where the heap is not allowed while
+ * planning. All buffers are members sized by the maximum grid dimensions at compile time. Header-only, it only needs
+ * the types of common.h
+ */
+namespace full_coverage_path_planner
+{
+/**
+ * Spiral-STC on a grid of at most MaxWidth x MaxHeight tiles, with the same plan as spiralCoverage (spiral_coverage.h)
+ * on the same grid. Nothing is allocated, neither on construction nor while planning.
+ *
+ * The planner is large (about 70 bytes per tile of the maximum grid plus 8 bytes per pose of MaxPathLength, 5.5 MB
+ * for 256 x 256 tiles), so make it static or global instead of putting it on the stack:
+ *
+ *   static FixedSpiralPlanner<128, 128> planner;
+ *   planner.resize(width, height);
+ *   planner.setBlocked(x, y, true);
+ *   planner.plan(start, multiple_pass_counter, visited_counter);
+ *
+ * @tparam MaxWidth, MaxHeight maximum grid size in tiles
+ * @tparam MaxPathLength maximum number of tiles of a plan, including the tiles that are passed more than once
+ */
+template <int MaxWidth, int MaxHeight, size_t MaxPathLength = 2 * MaxWidth * MaxHeight>
+class FixedSpiralPlanner
+{
+public:
+  static const int kMaxCells = MaxWidth * MaxHeight;
+
+  // closed_ is not initialized, the generation wraps around at the first search, which clears it
+  FixedSpiralPlanner() : width_(0), height_(0), path_length_(0), generation_(UINT32_MAX), expansions_(0)
+  {
+  }
+
+  /**
+   * Set the size of the grid, all tiles free
+   * @return false when it is larger than the maximum
+   */
+  bool resize(int width, int height)
+  {
+    if (width <= 0 || height <= 0 || width > MaxWidth || height > MaxHeight)
+    {
+      return false;
+    }
+    width_ = width;
+    height_ = height;
+    grid_.reset();
+    path_length_ = 0;
+    return true;
+  }
+
+  int width() const
+  {
+    return width_;
+  }
+
+  int height() const
+  {
+    return height_;
+  }
+
+  /**
+   * @param blocked true == occupied/blocked/obstacle
+   */
+  void setBlocked(int x, int y, bool blocked)
+  {
+    grid_[cell(x, y)] = blocked;
+  }
+
+  bool isBlocked(int x, int y) const
+  {
+    return grid_[cell(x, y)];
+  }
+
+  /**
+   * Perform Spiral-STC coverage path planning on the grid, see spiralCoverage
+   * @param init start position
+   * @return false when init is outside of the grid or the plan is longer than MaxPathLength (the path then holds the
+   *         first MaxPathLength tiles)
+   */
+  bool plan(Point_t const& init, int& multiple_pass_counter, int& visited_counter)
+  {
+    multiple_pass_counter = 0;
+    visited_counter = 0;
+    path_length_ = 0;
+    expansions_ = 0;
+    if (init.x < 0 || init.x >= width_ || init.y < 0 || init.y >= height_)
+    {
+      return false;
+    }
+
+    visited_ = grid_;
+    gridNode_t new_node =
+    {
+      { init.x, init.y },  // Point: x,y
+      0,                   // Cost
+      0,                   // Heuristic
+    };
+    path_nodes_[0] = new_node;
+    path_node_count_ = 1;
+    visited_[cell(init.x, init.y)] = eNodeVisited;
+
+    spiralFill();  // First spiral fill
+    findGoals();  // Retrieve remaining goalpoints
+    if (!appendPathNodes(visited_counter))
+    {
+      return false;
+    }
+
+    while (goal_count_ > 0)
+    {
+      // Keep the last point only, A* extends the path from there on
+      path_nodes_[0] = path_nodes_[path_node_count_ - 1];
+      path_node_count_ = 1;
+      visited_counter--;  // First point is already counted as visited
+      if (aStarToOpenSpace(path_nodes_[0], 1))
+      {
+        break;
+      }
+
+      // Update visited grid
+      for (size_t i = 0; i < path_node_count_; ++i)
+      {
+        size_t c = cell(path_nodes_[i].pos.x, path_nodes_[i].pos.y);
+        if (visited_[c])
+        {
+          multiple_pass_counter++;
+        }
+        visited_[c] = eNodeVisited;
+      }
+      multiple_pass_counter--;  // First point is already counted as visited
+
+      // Spiral fill from current position
+      spiralFill();
+      findGoals();  // Retrieve remaining goalpoints
+      if (!appendPathNodes(visited_counter))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Tiles of the last plan
+   */
+  Point_t const* path() const
+  {
+    return path_;
+  }
+
+  size_t pathLength() const
+  {
+    return path_length_;
+  }
+
+  /**
+   * Number of A* expansions of the last plan
+   */
+  uint64_t expansions() const
+  {
+    return expansions_;
+  }
+
+private:
+  typedef std::bitset<kMaxCells> CellSet;
+
+  /**
+   * Same order as sort_gridNodePath_heuristic_desc, for paths given as the index of their last node
+   */
+  struct CompareHeuristicDesc
+  {
+    explicit CompareHeuristicDesc(gridNode_t const* nodes) : nodes_(nodes)
+    {
+    }
+
+    bool operator()(int first, int second) const
+    {
+      return nodes_[first].he > nodes_[second].he;
+    }
+
+    gridNode_t const* nodes_;
+  };
+
+  static size_t cell(int x, int y)
+  {
+    return static_cast<size_t>(y) * MaxWidth + x;
+  }
+
+  bool isFree(int x, int y) const
+  {
+    return x >= 0 && x < width_ && y >= 0 && y < height_ && !grid_[cell(x, y)];
+  }
+
+  /**
+   * See spiralFill in spiral_coverage.h, on path_nodes_ and visited_
+   */
+  void spiralFill()
+  {
+    int dx, dy, dx_prev;
+    bool has_direction = path_node_count_ > 2;
+    gridNode_t prev = path_nodes_[path_node_count_ > 1 ? path_node_count_ - 2 : 0];
+    bool done = false;
+    while (!done)
+    {
+      gridNode_t const& last = path_nodes_[path_node_count_ - 1];
+      if (has_direction)
+      {
+        // turn ccw
+        dx = last.pos.x - prev.pos.x;
+        dy = last.pos.y - prev.pos.y;
+        dx_prev = dx;
+        dx = -dy;
+        dy = dx_prev;
+      }
+      else
+      {
+        // Initialize spiral direction towards y-axis
+        dx = 0;
+        dy = 1;
+      }
+      done = true;
+
+      for (int i = 0; i < 4; ++i)
+      {
+        int x2 = last.pos.x + dx, y2 = last.pos.y + dy;
+        if (isFree(x2, y2) && visited_[cell(x2, y2)] == eNodeOpen)
+        {
+          gridNode_t new_node =
+          {
+            { x2, y2 },  // Point: x,y
+            0,           // Cost
+            0,           // Heuristic
+          };
+          prev = last;
+          path_nodes_[path_node_count_++] = new_node;
+          has_direction = true;
+          visited_[cell(x2, y2)] = eNodeVisited;  // Close node
+          done = false;
+          break;
+        }
+        // try next direction cw
+        dx_prev = dx;
+        dx = dy;
+        dy = -dx_prev;
+      }
+    }
+  }
+
+  /**
+   * See map_2_goals: the tiles that are not visited yet, row-major
+   */
+  void findGoals()
+  {
+    goal_count_ = 0;
+    for (int y = 0; y < height_; ++y)
+    {
+      for (int x = 0; x < width_; ++x)
+      {
+        if (visited_[cell(x, y)] == eNodeOpen)
+        {
+          Point_t p = { x, y };
+          goals_[goal_count_++] = p;
+        }
+      }
+    }
+  }
+
+  int distanceToClosestGoal(Point_t const& p) const
+  {
+    int min_dist = INT_MAX;
+    for (size_t i = 0; i < goal_count_; ++i)
+    {
+      int dx = goals_[i].x - p.x, dy = goals_[i].y - p.y;
+      min_dist = std::min(min_dist, dx * dx + dy * dy);
+    }
+    return min_dist;
+  }
+
+  bool appendPathNodes(int& visited_counter)
+  {
+    for (size_t i = 0; i < path_node_count_; ++i)
+    {
+      if (path_length_ == MaxPathLength)
+      {
+        return false;
+      }
+      visited_counter++;
+      path_[path_length_++] = path_nodes_[i].pos;
+    }
+    return true;
+  }
+
+  /**
+   * See the workspace version of a_star_to_open_space in common.h, towards the goals and appending to path_nodes_
+   * @return whether we resign from finding a path
+   */
+  bool aStarToOpenSpace(gridNode_t const& init, int cost)
+  {
+    if (++generation_ == 0)
+    {
+      std::fill(closed_, closed_ + kMaxCells, 0);
+      generation_ = 1;
+    }
+    nodes_[0] = init;
+    parents_[0] = -1;
+    size_t node_count = 1;
+    open_[0] = 0;
+    size_t open_count = 1;
+    closed_[cell(init.pos.x, init.pos.y)] = generation_;
+
+    while (open_count > 0)
+    {
+      // Same order of the open paths as the other versions, so the same path is found
+      std::sort(open_, open_ + open_count, CompareHeuristicDesc(nodes_));
+      int last = open_[--open_count];
+      gridNode_t const end = nodes_[last];
+      ++expansions_;
+
+      if (visited_[cell(end.pos.x, end.pos.y)] == eNodeOpen)
+      {
+        size_t length = 0;
+        for (int node = last; node >= 0; node = parents_[node])
+        {
+          ++length;
+        }
+        size_t index = path_node_count_ + length;
+        for (int node = last; node >= 0; node = parents_[node])
+        {
+          path_nodes_[--index] = nodes_[node];
+        }
+        path_node_count_ += length;
+        return false;  // We do not resign, we found a path
+      }
+
+      int dx, dy, dx_prev;
+      if (parents_[last] >= 0)
+      {
+        // Start looking around counter-clockwise of the direction the path arrived in
+        dx = end.pos.x - nodes_[parents_[last]].pos.x;
+        dy = end.pos.y - nodes_[parents_[last]].pos.y;
+        dx_prev = dx;
+        dx = -dy;
+        dy = dx_prev;
+      }
+      else
+      {
+        dx = 0;
+        dy = 1;
+      }
+
+      for (int i = 0; i < 4; ++i)
+      {
+        Point_t p2 = { end.pos.x + dx, end.pos.y + dy };
+        if (isFree(p2.x, p2.y) && closed_[cell(p2.x, p2.y)] != generation_)
+        {
+          gridNode_t new_node =
+          {
+            p2,                                               // Point: x,y
+            cost + end.cost,                                  // Cost
+            cost + end.cost + distanceToClosestGoal(p2) + i,  // Heuristic (+i so CCW turns are cheaper)
+          };
+          closed_[cell(p2.x, p2.y)] = generation_;
+          nodes_[node_count] = new_node;
+          parents_[node_count] = last;
+          open_[open_count++] = node_count++;
+        }
+        // Cycle around to next neighbor, CCW
+        dx_prev = dx;
+        dx = dy;
+        dy = -dx_prev;
+      }
+    }
+
+    // No open paths left, there's no place to go and we must resign
+    path_nodes_[path_node_count_++] = init;
+    return true;
+  }
+
+  int width_;
+  int height_;
+  CellSet grid_;     ///< true == blocked, indexed by cell()
+  CellSet visited_;  ///< true == visited
+
+  // spiral and escape paths since the last escape: at most one escape over all tiles and one spiral over all tiles
+  gridNode_t path_nodes_[2 * kMaxCells + 2];
+  size_t path_node_count_;
+  Point_t goals_[kMaxCells];
+  size_t goal_count_;
+  Point_t path_[MaxPathLength];
+  size_t path_length_;
+
+  // A* search: a path has at most one node per cell, so one node per cell
+  gridNode_t nodes_[kMaxCells + 1];
+  int parents_[kMaxCells + 1];
+  int open_[kMaxCells + 1];
+  uint32_t closed_[kMaxCells];  ///< A cell is closed when it holds the generation of the current search
+  uint32_t generation_;
+  uint64_t expansions_;
+};
+}  // namespace full_coverage_path_planner
+#endif  // FULL_COVERAGE_PATH_PLANNER_FIXED_SPIRAL_COVERAGE_H
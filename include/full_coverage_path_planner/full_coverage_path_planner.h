@@ -5,6 +5,7 @@
 /** for global path planner interface */
 #include <fstream>
 #include <list>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -16,10 +17,16 @@
 #include <nav_msgs/Path.h>
 #include <nav_msgs/GetMap.h>
 #include <geometry_msgs/PoseStamped.h>
+#include <map_msgs/OccupancyGridUpdate.h>
 #include <angles/angles.h>
 #include <base_local_planner/world_model.h>
 #include <base_local_planner/costmap_model.h>
 #include <tf/tf.h>
+#include <full_coverage_path_planner/ChangedTiles.h>
+#include <full_coverage_path_planner/CompactCoveragePlan.h>
+#include <full_coverage_path_planner/PlanProfile.h>
+#include <full_coverage_path_planner/PlanSegments.h>
+#include <full_coverage_path_planner/SharedPlanHandle.h>
 
 using std::string;
 
@@ -27,8 +34,17 @@ using std::string;
 #define FULL_COVERAGE_PATH_PLANNER_FULL_COVERAGE_PATH_PLANNER_H
 
 #include "full_coverage_path_planner/common.h"
-
-// #define DEBUG_PLOT
+#include "full_coverage_path_planner/compact_plan.h"
+#include "full_coverage_path_planner/grid_inflation.h"
+#include "full_coverage_path_planner/map_loader.h"
+#include "full_coverage_path_planner/path_resampling.h"
+#include "full_coverage_path_planner/plan_handoff.h"
+#include "full_coverage_path_planner/plan_segmentation.h"
+#include "full_coverage_path_planner/planning_atlas.h"
+#include "full_coverage_path_planner/request_recorder.h"
+#include "full_coverage_path_planner/shared_plan.h"
+#include "full_coverage_path_planner/stroke_joins.h"
+#include "full_coverage_path_planner/tile_walk.h"
 
 #ifndef dabs
 #define dabs(a)     ((a) >= 0 ? (a):-(a))
@@ -43,15 +59,6 @@ using std::string;
 #define clamp(a, lower, upper)    dmax(dmin(a, upper), lower)
 #endif
 
-enum
-{
-  eDirNone = 0,
-  eDirRight = 1,
-  eDirUp = 2,
-  eDirLeft = -1,
-  eDirDown = -2,
-};
-
 namespace full_coverage_path_planner
 {
 class FullCoveragePathPlanner
@@ -64,7 +71,7 @@ public:
   FullCoveragePathPlanner(std::string name, costmap_2d::Costmap2DROS* costmap_ros);
 
   /**
-   * @brief  Publish a path for visualization purposes
+   * @brief  Publish a path for visualization purposes and, when enabled, in shared memory for co-located consumers
    */
   void publishPlan(const std::vector<geometry_msgs::PoseStamped>& path);
 
@@ -86,10 +93,32 @@ protected:
                            std::vector<geometry_msgs::PoseStamped>& plan);
 
   /**
-   * Convert ROS Occupancy grid to internal grid representation, given the size of a single tile
+   * Publish the tile walk as a CompactCoveragePlan: start tile plus run-length encoded directions
+   * @param start Start pose of robot, for the stamp
+   * @param goalpoints Goal points from Spiral Algorithm
+   */
+  void publishCompactPlan(const geometry_msgs::PoseStamped& start, std::list<Point_t> const& goalpoints);
+
+  /**
+   * Replace the tile-corner turns of a plan by smooth joins between the strokes, see smoothStrokeJoins
+   * @param plan Plan from parsePointlist2Plan, modified in place
+   */
+  void smoothPlan(std::vector<geometry_msgs::PoseStamped>& plan);
+
+  /**
+   * Resample a plan at a fixed spacing and publish its curvature and speed limits, see resamplePath
+   * @param plan Plan to resample, modified in place
+   */
+  void resamplePlan(std::vector<geometry_msgs::PoseStamped>& plan);
+
+  /**
+   * Convert ROS Occupancy grid to internal grid representation, given the size of a single tile.
+   * When a region of interest is set, only its bounding box is converted and tiles outside of it are blocked
    * @param cpp_grid_ ROS occupancy grid representation. Cells higher that 65 are considered occupied
    * @param grid internal map representation
-   * @param tileSize size (in meters) of a cell. This can be the robot's size
+   * @param robotRadius size (in meters) of the robot, i.e. twice robot_radius_: the width of the square footprint
+   *                    window, or the diameter of the circle footprint. See tileFootprint
+   * @param toolRadius size (in meters) of a cell. This can be the robot's size
    * @param realStart Start position of the robot (in meters)
    * @param scaledStart Start position of the robot on the grid
    * @return success
@@ -100,16 +129,224 @@ protected:
                  float toolRadius,
                  geometry_msgs::PoseStamped const& realStart,
                  Point_t& scaledStart);
+
+  /**
+   * Same as parseGrid, on the tiles of the whole map from loadTileGrid (map_loader.h) instead of the map.
+   * With a region of interest the tiles in its bounding box are copied out, which are the tiles parseGrid gives:
+   * inflating a tile only reads the map cells of its footprint window, whether the grid is cropped or not.
+   * The grid can not be updated with updateGrid
+   * @param metadata metadata of the map from loadTileGrid
+   * @param footprint footprint the tiles were inflated with, see tileFootprint
+   * @param tiles tiles of the whole map from loadTileGrid
+   * @param realStart Start position of the robot (in meters)
+   * @param grid output grid
+   * @param scaledStart Start position of the robot on the grid
+   * @return success
+   */
+  bool parseTileGrid(MapMetadata const& metadata, TileFootprint const& footprint,
+                     std::vector<std::vector<bool> > const& tiles, geometry_msgs::PoseStamped const& realStart,
+                     std::vector<std::vector<bool> >& grid, Point_t& scaledStart);
+
+  /**
+   * Load a map_server map file into file_tiles_ with loadTileGrid, for parseTileGrid. The tiles are inflated like
+   * parseGrid does, without having the whole map in memory
+   * @param map_file path of the map_server yaml file
+   * @param robotRadius, toolRadius sizes (in meters) of the robot and of a cell, as for parseGrid
+   * @return success
+   */
+  bool loadMapFile(std::string const& map_file, float robotRadius, float toolRadius);
+
+  /**
+   * Tile size and footprint of parseGrid on a map with the given resolution: tiles of toolRadius, a footprint
+   * window of robotRadius, and a circle radius of half robotRadius or the inscribed or circumscribed radius of the
+   * costmap footprint, depending on footprint_model_
+   */
+  TileFootprint tileFootprint(float robotRadius, float toolRadius, double resolution) const;
+
+  /**
+   * Update a grid from parseGrid after the cells in [cx0, cx1) x [cy0, cy1) of the map changed (e.g. the bounds of a
+   * costmap update or of a map_msgs/OccupancyGridUpdate applied to the map). Only the tiles whose footprint overlaps
+   * the changed cells are recomputed, in place; tiles outside of the region of interest stay blocked
+   * @param cpp_grid_ the updated map, with the size, resolution and origin (within a hundredth of a cell) of the map
+   *                  given to parseGrid
+   * @param grid grid from the last parseGrid, updated in place
+   * @param changed output: tiles whose state changed, for replanning
+   * @return false when the map does not match the last parseGrid, then parse it again
+   */
+  bool updateGrid(nav_msgs::OccupancyGrid const& cpp_grid_, int cx0, int cy0, int cx1, int cy1,
+                  std::vector<std::vector<bool> >& grid, std::vector<Point_t>& changed);
+
+  /**
+   * Start tile on a grid from parseGrid: the tile of realStart, clamped to the grid, or the closest accessible tile
+   * when that is outside of the region of interest
+   * @param grid grid from parseGrid
+   * @param realStart Start position of the robot (in meters)
+   * @param scaledStart output start tile
+   * @return false when the region of interest contains no accessible tiles
+   */
+  bool startTile(std::vector<std::vector<bool> > const& grid, geometry_msgs::PoseStamped const& realStart,
+                 Point_t& scaledStart);
+
+  /**
+   * Tiles to parse: the bounding box of the region of interest, or all tiles without one. Moves grid_origin_ to the
+   * corner of the bounding box
+   * @param nTileCols, nTileRows size of the tile grid of the whole map
+   * @param tx0, ty0, tx1, ty1 output tiles [tx0, tx1) x [ty0, ty1)
+   * @return false when the region of interest does not overlap with the map
+   */
+  bool roiTiles(int nTileCols, int nTileRows, int& tx0, int& ty0, int& tx1, int& ty1);
+
+  /**
+   * Block the tiles of a (cropped) grid outside of the region of interest, and keep them in roi_blocked_
+   */
+  void maskRoi(std::vector<std::vector<bool> >& grid);
+
+  /**
+   * Grid to plan on and the start tile on it. With a map file (map_file_) the grid is cropped from its tiles.
+   * Otherwise, without map updates, the map is requested from the map server and parsed for every plan. With map
+   * updates (map_updates_) the map and its grid are kept, and the grid is reused as long as every map update since it
+   * was parsed could be applied to it (see applyMapUpdate)
+   * @param start Start pose of robot
+   * @param grid output grid, a copy so that map updates can be applied while planning
+   * @param startPoint output start tile
+   * @return false when the map can not be retrieved or parsed
+   */
+  bool planningGrid(const geometry_msgs::PoseStamped& start, std::vector<std::vector<bool> >& grid,
+                    Point_t& startPoint);
+
+  /**
+   * Take a new map, e.g. from the map topic, to parse for the next plan
+   */
+  void setMap(nav_msgs::OccupancyGrid const& map);
+
+  /**
+   * Apply a map update to the kept map and update its grid in place with updateGrid. The changed tiles are published
+   * on changed_tiles when it is advertised
+   * @param update cells of the map that changed
+   * @param changed output: tiles (in grid coordinates) whose state changed
+   * @return false when there is no parsed grid to update; the map is then parsed again for the next plan, and
+   *         requested from the map server again when the update does not fit in it
+   */
+  bool applyMapUpdate(map_msgs::OccupancyGridUpdate const& update, std::vector<Point_t>& changed);
+
+  /**
+   * Parse a parameter given as a list of [x, y] points
+   * @param value parameter value
+   * @param points output points, cleared when the value is not a valid list of points
+   * @return whether the value is a list of [x, y] points
+   */
+  static bool parsePoints(XmlRpc::XmlRpcValue& value, std::vector<fPoint_t>& points);
+
+  /**
+   * Parse a polygon parameter, given as a list of [x, y] points
+   * @param value parameter value
+   * @param polygon output polygon, cleared when the value is not a valid polygon
+   * @return whether the value is a list of at least 3 [x, y] points
+   */
+  static bool parsePolygon(XmlRpc::XmlRpcValue& value, std::vector<fPoint_t>& polygon);
+
+  /**
+   * Assemble the tile walk from the atlas, for the zones in the atlas_zones parameter, starting at the docking
+   * station where the robot is. Sets the grid origin and tile size to those of the atlas, the caller restores those of
+   * the map once the plan is converted. The walk is not split into segments (plan_segments)
+   * @param start Start pose of robot
+   * @param goalpoints Output tile walk
+   * @return false when the robot is not at a docking station or the zones can not be stitched
+   */
+  bool planFromAtlas(const geometry_msgs::PoseStamped& start, std::list<Point_t>& goalpoints);
+
+  /**
+   * Split the tile walk into segments that each fit the budget of one charge (see plan_segmentation.h) and publish
+   * them. The dock is at dock_x, dock_y, or at the start when those are not set
+   * @param start Start pose of robot
+   * @param grid grid the walk was planned on
+   * @param startPoint start position on the grid
+   * @param goalpoints tile walk
+   * @return false when a part of the walk does not fit in the budget
+   */
+  bool publishPlanSegments(const geometry_msgs::PoseStamped& start, std::vector<std::vector<bool> > const& grid,
+                           Point_t const& startPoint, std::vector<Point_t> const& goalpoints);
+
+  /**
+   * Write a path into the shared-memory ring buffer and publish a SharedPlanHandle pointing at it
+   * @param path plan to share
+   * @return false when the plan does not fit in a slot of the ring buffer
+   */
+  bool publishSharedPlan(const std::vector<geometry_msgs::PoseStamped>& path);
+
+  /**
+   * Hand a plan off to consumers in this process, together with the tile of each pose (see plan_handoff.h). Does
+   * nothing when plans are not handed off
+   * @param plan plan as published
+   * @param goalpoints tile walk the plan was made from
+   */
+  void handOffPlan(const std::vector<geometry_msgs::PoseStamped>& plan, std::list<Point_t> const& goalpoints);
+
+  /**
+   * Record the inputs of a planning request (map, start pose and planner settings, coverage engine included) in the
+   * rolling request buffer
+   * @param map map as received from the map server
+   * @param start Start pose of robot
+   */
+  void recordRequest(nav_msgs::OccupancyGrid const& map, const geometry_msgs::PoseStamped& start);
+
+  /**
+   * Restore the planner settings of a recorded request, for replaying it
+   * @param request recorded request
+   * @param map output map of the request
+   * @param start output start pose of the request
+   */
+  void restoreRequest(RecordedRequest const& request, nav_msgs::OccupancyGrid& map,
+                      geometry_msgs::PoseStamped& start);
+
   ros::Publisher plan_pub_;
+  ros::Publisher profile_pub_;
+  ros::Publisher shared_plan_pub_;
+  ros::Publisher compact_plan_pub_;
+  ros::Publisher segments_pub_;  // Only advertised when the plan is segmented
+  ros::Publisher changed_tiles_pub_;  // Only advertised with map updates
   ros::ServiceClient cpp_grid_client_;
   nav_msgs::OccupancyGrid cpp_grid_;
   float robot_radius_;
   float tool_radius_;
   float plan_resolution_;
   float tile_size_;
+  FootprintModel footprint_model_;  // Shape that obstacles are inflated with in parseGrid
+  float footprint_inscribed_radius_;  // Of the costmap footprint polygon, for eFootprintInscribed
+  float footprint_circumscribed_radius_;  // Of the costmap footprint polygon, for eFootprintCircumscribed
+  bool contour_engine_;  // Plan with contourCoverage instead of spiral_stc
+  bool sparse_grid_;  // Plan the spiral on an IntervalGrid instead of the dense grid
+  std::vector<fPoint_t> roi_;  // Polygon (in map coordinates) to cover, empty to cover the whole map
+  StrokeJoinParams join_params_;
+  bool resample_plan_;
+  ResamplingParams resampling_params_;
+  SegmentationParams segmentation_params_;
+  bool has_dock_;  // Whether dock_ is set, otherwise the robot starts at the dock
+  fPoint_t dock_;
+  SharedPlanWriter shared_plan_writer_;  // Only open when the plan is shared through shared memory
+  PlanHandoff* plan_handoff_;  // Only set when plans are handed off to consumers in this process
+  bool publish_plan_topic_;
+  PlanningAtlas atlas_;  // Only open when plans are looked up in a precomputed atlas
+  std::string atlas_zones_param_;
+  RequestRecorder request_recorder_;  // Only open when planning requests are recorded
   fPoint_t grid_origin_;
+  // The last parseGrid, for updateGrid
+  nav_msgs::MapMetaData parsed_map_info_;
+  TileFootprint parsed_footprint_;
+  Point_t parsed_tile_origin_;  // Tile of the map at grid[0][0]
+  std::vector<std::vector<bool> > roi_blocked_;  // Tiles outside of the region of interest, empty without one
+  // The map and its grid, kept between plans with map updates. Guarded by map_mutex_ against the map callbacks
+  bool map_updates_;  // Keep the map and grid up to date with map updates instead of getting the map for every plan
+  bool has_map_;  // Whether cpp_grid_ holds the current map
+  bool grid_valid_;  // Whether grid_ is cpp_grid_ parsed, with all map updates applied
+  std::vector<std::vector<bool> > grid_;
+  std::mutex map_mutex_;
+  // Map file to plan on instead of the map of the map server, loaded once into the tiles of the whole map
+  std::string map_file_;
+  MapMetadata file_metadata_;
+  TileFootprint file_footprint_;
+  std::vector<std::vector<bool> > file_tiles_;
   bool initialized_;
-  geometry_msgs::PoseStamped previous_goal_;
 
   struct spiral_cpp_metrics_type
   {
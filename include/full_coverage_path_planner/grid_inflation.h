@@ -0,0 +1,129 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <stdint.h>
+#include <vector>
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_GRID_INFLATION_H
+#define FULL_COVERAGE_PATH_PLANNER_GRID_INFLATION_H
+
+#include "full_coverage_path_planner/common.h"
+
+namespace full_coverage_path_planner
+{
+/**
+ * Cells with an occupancy value higher than this are considered obstacles
+ */
+const int kOccupiedThreshold = 65;
+
+/**
+ * How the robot footprint is used to decide whether a tile is blocked
+ */
+enum FootprintModel
+{
+  eFootprintSquare = 0,         ///< Square window of footprint_size cells centered on the tile (legacy behaviour)
+  eFootprintCircle = 1,         ///< Circle with the robot radius
+  eFootprintInscribed = 2,      ///< Inscribed radius of the costmap footprint polygon
+  eFootprintCircumscribed = 3,  ///< Circumscribed radius of the costmap footprint polygon
+};
+
+/**
+ * Footprint used to inflate obstacles into the tile grid
+ */
+struct TileFootprint
+{
+  FootprintModel model;
+
+  /** Size of a (square) tile in map cells */
+  int node_size;
+
+  /** Side of the square footprint window in map cells, used by eFootprintSquare */
+  int footprint_size;
+
+  /** Radius in map cells, used by the circular models */
+  float radius;
+};
+
+/**
+ * Squared euclidean distance transform of a row-major obstacle mask, in linear time
+ * (Felzenszwalb & Huttenlocher, Distance Transforms of Sampled Functions)
+ * @param obstacles row-major mask, nonzero == obstacle
+ * @param width number of columns
+ * @param height number of rows
+ * @param dist2 output: squared distance (in cells) from every cell to the closest obstacle.
+ *              Cells without any obstacle in the mask get a very large value.
+ */
+void distanceTransform(std::vector<uint8_t> const& obstacles, int width, int height, std::vector<float>& dist2);
+
+/**
+ * Number of tiles needed to cover a map of the given size (partial tiles at the border included)
+ */
+inline int tileCount(int cells, int node_size)
+{
+  return (cells + node_size - 1) / node_size;
+}
+
+/**
+ * Mark tiles of the grid as blocked when the footprint placed on them overlaps an obstacle.
+ * Obstacles are inflated once per call, so the cost is linear in the number of map cells touched
+ * and does not depend on the footprint size.
+ * Only tiles in [tx0, tx1) x [ty0, ty1) are written, the rest of the grid is left untouched.
+ * @param data row-major ROS occupancy data. Values higher than kOccupiedThreshold are obstacles
+ * @param width number of map columns
+ * @param height number of map rows
+ * @param footprint footprint and tile size
+ * @param tx0 first tile column to compute
+ * @param ty0 first tile row to compute
+ * @param tx1 one past the last tile column to compute
+ * @param ty1 one past the last tile row to compute
+ * @param grid tile grid, tile (tx, ty) is written to grid[ty - grid_y0][tx - grid_x0]. true == blocked
+ * @param grid_x0 tile column of the first column of grid, to fill a grid that covers only part of the map
+ * @param grid_y0 tile row of the first row of grid
+ */
+void inflateTiles(int8_t const* data, int width, int height, TileFootprint const& footprint,
+                  int tx0, int ty0, int tx1, int ty1, std::vector<std::vector<bool> >& grid,
+                  int grid_x0 = 0, int grid_y0 = 0);
+
+/**
+ * Map rows [cy0, cy1) that inflateTiles reads for the tile rows [ty0, ty1), clamped to the map
+ * @param height number of map rows
+ */
+void tileCellRows(int height, TileFootprint const& footprint, int ty0, int ty1, int& cy0, int& cy1);
+
+/**
+ * inflateTiles on a band of consecutive map rows instead of the whole map, e.g. while the map is being decoded.
+ * The band must hold at least the rows tileCellRows gives for [ty0, ty1)
+ * @param band row-major ROS occupancy data of map rows band_y0, band_y0 + 1, ...
+ * @param band_y0 map row of the first row of band
+ * @param width number of map columns
+ * @param height number of rows of the whole map
+ */
+void inflateTileBand(int8_t const* band, int band_y0, int width, int height, TileFootprint const& footprint,
+                     int tx0, int ty0, int tx1, int ty1, std::vector<std::vector<bool> >& grid,
+                     int grid_x0 = 0, int grid_y0 = 0);
+
+/**
+ * Tiles whose state can depend on the map cells in [cx0, cx1) x [cy0, cy1): those whose footprint window (square
+ * model) or footprint radius around the tile center (circular models) overlaps them. Conservative by a tile
+ * @param width number of map columns
+ * @param height number of map rows
+ * @param tx0, ty0, tx1, ty1 output tile window, clamped to the tiles of the map, empty when the cells are outside it
+ */
+void dirtyTileWindow(int width, int height, TileFootprint const& footprint, int cx0, int cy0, int cx1, int cy1,
+                     int& tx0, int& ty0, int& tx1, int& ty1);
+
+/**
+ * Update a tile grid from inflateTiles after the map cells in [cx0, cx1) x [cy0, cy1) changed, e.g. the bounds of a
+ * costmap update or a map_msgs/OccupancyGridUpdate. Only the tiles in dirtyTileWindow are recomputed, in place, so
+ * the cost depends on the size of the change and not on the size of the map
+ * @param data the updated row-major ROS occupancy data, of the same size as before
+ * @param grid tile grid to update, tile (tx, ty) is grid[ty - grid_y0][tx - grid_x0]. true == blocked
+ * @param blocked tiles (in grid coordinates) that stay blocked whatever the map says, e.g. outside of the region of
+ *                interest. NULL for none
+ * @param changed output: tiles (in grid coordinates) whose state changed
+ */
+void updateTiles(int8_t const* data, int width, int height, TileFootprint const& footprint,
+                 int cx0, int cy0, int cx1, int cy1, std::vector<std::vector<bool> >& grid, int grid_x0, int grid_y0,
+                 std::vector<std::vector<bool> > const* blocked, std::vector<Point_t>& changed);
+}  // namespace full_coverage_path_planner
+#endif  // FULL_COVERAGE_PATH_PLANNER_GRID_INFLATION_H
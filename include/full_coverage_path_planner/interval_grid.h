@@ -0,0 +1,130 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <vector>
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_INTERVAL_GRID_H
+#define FULL_COVERAGE_PATH_PLANNER_INTERVAL_GRID_H
+
+#include "full_coverage_path_planner/common.h"
+
+/*
+ * Sparse representation of a tile grid for maps that are mostly obstacle, e.g. a narrow path through a large
+ * outdoor bounding box: per row, the sorted runs of free tiles. Memory and the cost of scanning the grid scale with
+ * the free tiles instead of the bounding box. Per-tile state (visited, closed) is kept in arrays over the free tiles,
+ * indexed by index().
+ */
+namespace full_coverage_path_planner
+{
+/**
+ * Run [start, end) of free tiles in a row
+ */
+struct FreeInterval
+{
+  int start;
+  int end;
+  int offset;  ///< Index of the tile at start, free tiles are numbered row-major
+};
+
+class IntervalGrid
+{
+public:
+  IntervalGrid();
+
+  /**
+   * @param grid 2D grid of bools. true == occupied/blocked/obstacle
+   */
+  explicit IntervalGrid(std::vector<std::vector<bool> > const& grid);
+
+  /**
+   * Rebuild from a dense grid, keeping the storage
+   * @param grid 2D grid of bools. true == occupied/blocked/obstacle
+   */
+  void assign(std::vector<std::vector<bool> > const& grid);
+
+  /**
+   * Convert back to a dense grid. true == occupied/blocked/obstacle
+   */
+  void toGrid(std::vector<std::vector<bool> >& grid) const;
+
+  int width() const
+  {
+    return width_;
+  }
+
+  int height() const
+  {
+    return height_;
+  }
+
+  /**
+   * Number of free tiles, the size of arrays indexed by index()
+   */
+  int freeCount() const
+  {
+    return free_count_;
+  }
+
+  int intervalCount() const
+  {
+    return intervals_.size();
+  }
+
+  /**
+   * Free runs of row y, sorted on start. y must be in [0, height())
+   */
+  FreeInterval const* rowBegin(int y) const
+  {
+    return intervals_.data() + row_begin_[y];
+  }
+
+  FreeInterval const* rowEnd(int y) const
+  {
+    return intervals_.data() + row_begin_[y + 1];
+  }
+
+  /**
+   * Index of a free tile in [0, freeCount()), by binary search over the runs of its row
+   * @return -1 when the tile is blocked or outside the grid
+   */
+  int index(int x, int y) const;
+
+  bool isFree(int x, int y) const
+  {
+    return index(x, y) >= 0;
+  }
+
+private:
+  int width_;
+  int height_;
+  int free_count_;
+  std::vector<int> row_begin_;  ///< Per row, the index of its first run in intervals_, height_ + 1 entries
+  std::vector<FreeInterval> intervals_;
+};
+
+/**
+ * Same as map_2_goals on a dense visited grid: all free tiles that are not visited, in row-major order
+ * @param grid free tiles
+ * @param visited per free tile, true == visited
+ * @param goals output, keeps its capacity
+ */
+void map_2_goals(IntervalGrid const& grid, std::vector<bool> const& visited, std::vector<Point_t>& goals);
+
+/**
+ * Same as the workspace version of a_star_to_open_space, on the free tiles of an interval grid. The search and its
+ * result are the same as on the dense grid. workspace.closed is indexed by IntervalGrid::index()
+ * @param grid free tiles
+ * @param init start position
+ * @param cost cost of traversing a free node
+ * @param visited per free tile, true == visited. Blocked tiles count as visited
+ * @param open_space Open space that A* need to find a path towards. Only used for the heuristic and directing search
+ * @param workspace buffers reused between searches
+ * @param pathNodes the path from init to open space is appended to it. When resigning, it is replaced by its last
+ *                  node and init
+ * @return whether we resign from finding a path or not. true is we resign and false if we found a path
+ */
+bool a_star_to_open_space(IntervalGrid const& grid, gridNode_t init, int cost, std::vector<bool> const& visited,
+                          std::vector<Point_t> const& open_space, AStarWorkspace& workspace,
+                          std::vector<gridNode_t>& pathNodes);
+}  // namespace full_coverage_path_planner
+#endif  // FULL_COVERAGE_PATH_PLANNER_INTERVAL_GRID_H
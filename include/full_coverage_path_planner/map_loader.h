@@ -0,0 +1,68 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <string>
+#include <vector>
+
+#include <nav_msgs/OccupancyGrid.h>
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_MAP_LOADER_H
+#define FULL_COVERAGE_PATH_PLANNER_MAP_LOADER_H
+
+#include "full_coverage_path_planner/grid_inflation.h"
+
+namespace full_coverage_path_planner
+{
+/**
+ * Metadata of a map_server map file
+ */
+struct MapMetadata
+{
+  std::string image;  ///< Image file, relative paths are relative to the directory of the yaml file
+  double resolution;
+  double origin_x;
+  double origin_y;
+  double origin_yaw;
+  bool negate;
+  double occupied_thresh;
+  double free_thresh;
+};
+
+/**
+ * Read the metadata of a map in the map_server yaml format (image, resolution, origin, negate and thresholds)
+ * @param yaml_file path of the yaml file
+ * @param metadata output, the image path is made absolute
+ * @return whether the file could be read and contains at least image and resolution
+ */
+bool readMapMetadata(std::string const& yaml_file, MapMetadata& metadata);
+
+/**
+ * Load a map like map_server does in trinary mode: the average of the color channels decides whether a cell is
+ * occupied (100), free (0) or unknown (-1). The bottom row of the image is the first row of the map.
+ * Supports PNG and binary PGM (P5) images
+ * @param yaml_file path of the map_server yaml file
+ * @param map output occupancy grid
+ * @return success, false for a rotated map (an origin with a yaw), which the planner can not tile
+ */
+bool loadMap(std::string const& yaml_file, nav_msgs::OccupancyGrid& map);
+
+/**
+ * Load a map straight into a tile grid, the same grid as inflateTiles gives on the map of loadMap. The image is
+ * decoded row by row and the tile rows are inflated as soon as their footprint window is complete, so only that
+ * window of map rows is in memory: O(width x footprint) instead of O(width x height) for large maps.
+ * Interlaced PNGs can only be decoded as a whole and do not have this bound.
+ * The whole map is loaded, also when the planner only plans on the bounding box of a region of interest: that crop
+ * is taken from these tiles afterwards (FullCoveragePathPlanner::parseTileGrid). A tile only depends on the map cells
+ * in its footprint window, so the cropped tiles equal the ones parseGrid gives on the bounding box
+ * @param yaml_file path of the map_server yaml file
+ * @param footprint footprint and tile size
+ * @param metadata output metadata of the map
+ * @param grid output tile grid of the whole map, tile (tx, ty) is grid[ty][tx] with tile row 0 at the bottom.
+ *             true == blocked
+ * @param band_rows output: number of map rows kept in memory, NULL if not needed
+ * @return success, false for a rotated map like loadMap
+ */
+bool loadTileGrid(std::string const& yaml_file, TileFootprint const& footprint, MapMetadata& metadata,
+                  std::vector<std::vector<bool> >& grid, int* band_rows = NULL);
+}  // namespace full_coverage_path_planner
+#endif  // FULL_COVERAGE_PATH_PLANNER_MAP_LOADER_H
@@ -0,0 +1,102 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <geometry_msgs/msg/pose_stamped.hpp>
+#include <nav2_core/global_planner.hpp>
+#include <nav2_costmap_2d/costmap_2d_ros.hpp>
+#include <nav_msgs/msg/occupancy_grid.hpp>
+#include <nav_msgs/msg/path.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <rclcpp_lifecycle/lifecycle_node.hpp>
+#include <rclcpp_lifecycle/lifecycle_publisher.hpp>
+#include <tf2_ros/buffer.h>
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_NAV2_SPIRAL_STC_H
+#define FULL_COVERAGE_PATH_PLANNER_NAV2_SPIRAL_STC_H
+
+#include "full_coverage_path_planner/contour_coverage.h"
+#include "full_coverage_path_planner/costmap_grid.h"
+#include "full_coverage_path_planner/grid_inflation.h"
+#include "full_coverage_path_planner/interval_grid.h"
+#include "full_coverage_path_planner/spiral_coverage.h"
+#include "full_coverage_path_planner/stroke_joins.h"
+
+namespace full_coverage_path_planner
+{
+/**
+ * Nav2 planner server plugin with the same coverage engines and plan conversion as the ROS 1 SpiralSTC plugin.
+ *
+ * Meant to run in a component container with intra-process communication, next to the controller server and the
+ * tracker: the lethal cells of the global costmap of the planner server are copied into a reused buffer while the
+ * costmap is locked, and tiled after the lock is released (a map of map_topic is taken by shared pointer instead). The
+ * plan is published on coverage_plan as a unique pointer, which intra-process subscribers in the same container
+ * receive without a copy.
+ */
+class Nav2SpiralSTC : public nav2_core::GlobalPlanner
+{
+public:
+  Nav2SpiralSTC();
+
+  void configure(const rclcpp_lifecycle::LifecycleNode::WeakPtr& parent, std::string name,
+                 std::shared_ptr<tf2_ros::Buffer> tf,
+                 std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros) override;
+
+  void cleanup() override;
+
+  void activate() override;
+
+  void deactivate() override;
+
+  /**
+   * Plan a path that covers all tiles reachable from start, the goal is not used
+   */
+  nav_msgs::msg::Path createPlan(const geometry_msgs::msg::PoseStamped& start,
+                                 const geometry_msgs::msg::PoseStamped& goal) override;
+
+private:
+  /**
+   * Keep the last map of map_topic, without copying it
+   */
+  void mapCallback(nav_msgs::msg::OccupancyGrid::ConstSharedPtr map);
+
+  /**
+   * Inflate the obstacles of a map into grid_ and geometry_, see occupancyToTiles
+   * @return false when the map is empty
+   */
+  bool parseGrid(int8_t const* data, int width, int height, double resolution, double origin_x, double origin_y);
+
+  rclcpp::Logger logger_;
+  rclcpp::Clock::SharedPtr clock_;
+  std::string name_;
+  std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros_;
+  rclcpp::Subscription<nav_msgs::msg::OccupancyGrid>::SharedPtr map_sub_;
+  nav_msgs::msg::OccupancyGrid::ConstSharedPtr map_;
+  rclcpp_lifecycle::LifecyclePublisher<nav_msgs::msg::Path>::SharedPtr plan_pub_;
+
+  // Parameters
+  double robot_radius_;
+  double tool_radius_;
+  FootprintModel footprint_model_;
+  bool contour_engine_;  ///< Plan with contourCoverage instead of spiralCoverage
+  bool sparse_grid_;  ///< Plan the spiral on an IntervalGrid
+  StrokeJoinParams join_params_;
+
+  // Buffers reused between plans
+  std::vector<int8_t> occupancy_;  ///< Costmap converted to occupancy values
+  std::vector<std::vector<bool> > grid_;
+  TileGeometry geometry_;
+  SpiralWorkspace spiral_workspace_;
+  IntervalGrid interval_grid_;
+  IntervalSpiralWorkspace interval_workspace_;
+  ContourWorkspace contour_workspace_;
+  std::vector<Point_t> walk_;
+  std::vector<Waypoint> waypoints_;
+};
+}  // namespace full_coverage_path_planner
+#endif  // FULL_COVERAGE_PATH_PLANNER_NAV2_SPIRAL_STC_H
@@ -0,0 +1,52 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <vector>
+
+#include "full_coverage_path_planner/stroke_joins.h"
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_PATH_RESAMPLING_H
+#define FULL_COVERAGE_PATH_PLANNER_PATH_RESAMPLING_H
+
+namespace full_coverage_path_planner
+{
+struct ResamplingParams
+{
+  /** Maximum distance between two resampled poses [m] */
+  double spacing;
+
+  /** Speed limit on straights [m/s] */
+  double max_velocity;
+
+  /** Maximum longitudinal acceleration and deceleration [m/s^2] */
+  double max_acceleration;
+
+  /** Maximum lateral acceleration, limits the speed in turns [m/s^2] */
+  double max_lateral_acceleration;
+};
+
+/**
+ * Resampled path with, per pose, the values a controller would otherwise compute online
+ */
+struct PathProfile
+{
+  std::vector<Waypoint> poses;
+  std::vector<double> arc_length;    ///< Distance along the path from the first pose [m]
+  std::vector<double> curvature;     ///< Signed curvature [1/m], infinite for a turn on the spot
+  std::vector<double> max_velocity;  ///< Trapezoidal speed limit [m/s]
+};
+
+/**
+ * Resample a path at (at most) a fixed arc-length spacing and compute the curvature and a speed limit per pose.
+ *
+ * The corners of the path are kept, segments in between are divided in equal parts of at most params.spacing.
+ * Turns on the spot (consecutive poses at the same position) are kept and get a speed limit of 0.
+ * The speed limit respects the lateral acceleration in turns and the longitudinal acceleration everywhere,
+ * starting and ending at standstill.
+ * @param path waypoints of the plan
+ * @param params spacing and limits
+ * @param profile output
+ */
+void resamplePath(std::vector<Waypoint> const& path, ResamplingParams const& params, PathProfile& profile);
+}  // namespace full_coverage_path_planner
+#endif  // FULL_COVERAGE_PATH_PLANNER_PATH_RESAMPLING_H
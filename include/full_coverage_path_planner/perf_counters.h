@@ -0,0 +1,83 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <stdint.h>
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_PERF_COUNTERS_H
+#define FULL_COVERAGE_PATH_PLANNER_PERF_COUNTERS_H
+
+/*
+ * Hardware performance counters of the calling thread through Linux perf_event_open, to tell whether a part of the
+ * planning is bound by cache misses or branch mispredictions rather than by the number of instructions
+ */
+namespace full_coverage_path_planner
+{
+enum PerfEvent
+{
+  ePerfCycles = 0,
+  ePerfInstructions,
+  ePerfL1dMisses,    ///< Level 1 data cache read misses
+  ePerfLlcMisses,    ///< Last level cache misses
+  ePerfBranchMisses,
+  ePerfEventCount,
+};
+
+/** Name of an event, as used in the benchmark output, e.g. "l1d_misses" */
+char const* perfEventName(int event);
+
+/**
+ * Counts of all events. Plain data, so it can be passed from the process that counted them
+ */
+struct PerfCounts
+{
+  int64_t values[ePerfEventCount];  ///< -1 for events that are not counted
+};
+
+/** All events not counted */
+PerfCounts noPerfCounts();
+
+/** Counts from a to b, -1 for events that are not counted in either */
+PerfCounts perfDifference(PerfCounts const& a, PerfCounts const& b);
+
+/** Add the counts of b to a, events not counted in b are left as they are */
+void perfAccumulate(PerfCounts& a, PerfCounts const& b);
+
+/**
+ * One group of counters on the calling thread, in user space only, running from open() on. A part of the code is
+ * measured by the difference of read() before and after it. When the kernel multiplexes the counters, the counts are
+ * scaled to the time they were enabled
+ */
+class PerfCounters
+{
+public:
+  PerfCounters();
+  ~PerfCounters();
+  PerfCounters(PerfCounters const&) = delete;
+  PerfCounters& operator=(PerfCounters const&) = delete;
+
+  /**
+   * Start counting. Events the CPU does not have (e.g. in a virtual machine) are left out
+   * @return false when no counters are available at all (e.g. perf_event_paranoid above 2 or no PMU), errno is set
+   */
+  bool open();
+
+  void close();
+
+  bool isOpen() const
+  {
+    return fds_[ePerfCycles] >= 0;
+  }
+
+  /**
+   * Counts since open()
+   * @return false when the counters could not be read or have not run on the PMU yet
+   */
+  bool read(PerfCounts& counts) const;
+
+private:
+  int fds_[ePerfEventCount];    ///< -1 for events that are not counted, the cycles are the group leader
+  int slots_[ePerfEventCount];  ///< Position of each event in the group read
+  int event_count_;             ///< Number of events in the group
+};
+}  // namespace full_coverage_path_planner
+#endif  // FULL_COVERAGE_PATH_PLANNER_PERF_COUNTERS_H
@@ -0,0 +1,102 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_PLAN_HANDOFF_H
+#define FULL_COVERAGE_PATH_PLANNER_PLAN_HANDOFF_H
+
+#include "full_coverage_path_planner/common.h"
+#include "full_coverage_path_planner/stroke_joins.h"
+
+/*
+ * In-process handoff of completed plans to consumers in the same process as the planner (e.g. an executor that runs
+ * in move_base), without copies and without the planner thread ever waiting for a reader.
+ *
+ * Every plan is an immutable HandoffPlan behind a shared_ptr. The planner fills a plan and swaps it in, readers take
+ * the current one and keep it for as long as they track it, while the planner goes on replanning. Only the pointer
+ * swap is shared between them; it never waits for a plan to be built or read.
+ */
+namespace full_coverage_path_planner
+{
+struct HandoffPlan
+{
+  uint64_t sequence;     ///< 1 for the first plan of a PlanHandoff, increasing by one per plan
+  std::string frame_id;
+  double stamp;          ///< [s]
+  double origin_x;       ///< Position of the corner of tile (0, 0) [m]
+  double origin_y;
+  double tile_size;      ///< [m]
+  std::vector<Waypoint> poses;
+  std::vector<Point_t> tiles;        ///< Tile walk the poses were made from
+  std::vector<uint32_t> pose_tiles;  ///< Per pose, the index in tiles of the tile it is on, for tracking progress
+};
+
+/**
+ * Map the poses of a plan to the tile walk it was made from. Poses follow the walk, so each pose is matched with
+ * the first tile at or after the tile of the previous pose that it lies on; a pose beside the walk (e.g. on a
+ * smoothed corner, or driving to the start) keeps the tile of the previous pose. Linear in the size of the plan, as
+ * long as few consecutive poses lie beside the walk
+ * @param poses poses of the plan
+ * @param tiles tile walk
+ * @param origin_x, origin_y position of the corner of tile (0, 0) [m]
+ * @param tile_size size of a tile [m]
+ * @param pose_tiles output, per pose the index in tiles
+ */
+void mapPosesToTiles(std::vector<Waypoint> const& poses, std::vector<Point_t> const& tiles, double origin_x,
+                     double origin_y, double tile_size, std::vector<uint32_t>& pose_tiles);
+
+/**
+ * Publication point of the plans of one planner. beginWrite() and commit() are for a single writer thread, any number
+ * of threads may read
+ */
+class PlanHandoff
+{
+public:
+  PlanHandoff();
+  PlanHandoff(PlanHandoff const&) = delete;
+  PlanHandoff& operator=(PlanHandoff const&) = delete;
+
+  /**
+   * Buffer for the next plan: the plan before the current one when no reader holds it anymore, so the vectors keep
+   * their capacity, otherwise a new one
+   */
+  std::shared_ptr<HandoffPlan> beginWrite();
+
+  /**
+   * Publish a plan from beginWrite() to readers and set its sequence. The plan must not be changed afterwards
+   */
+  void commit(std::shared_ptr<HandoffPlan> const& plan);
+
+  /**
+   * The most recent plan, NULL before the first one. Stays valid (and unchanged) while it is held
+   */
+  std::shared_ptr<HandoffPlan const> latest() const;
+
+  /**
+   * Sequence of the most recent plan, 0 before the first one. Cheap enough to poll every control cycle, to only take
+   * the plan when it changed
+   */
+  uint64_t sequence() const
+  {
+    return sequence_.load(std::memory_order_acquire);
+  }
+
+private:
+  std::shared_ptr<HandoffPlan const> current_;  ///< Only accessed through std::atomic_load and std::atomic_store
+  std::shared_ptr<HandoffPlan> previous_;       ///< Writer only
+  std::atomic<uint64_t> sequence_;
+};
+
+/**
+ * The handoff point of the planner with the given name (the name it is initialized with), created on first use and
+ * kept until the process exits, so the planner and its consumers can be started in any order
+ */
+PlanHandoff& planHandoff(std::string const& name);
+}  // namespace full_coverage_path_planner
+#endif  // FULL_COVERAGE_PATH_PLANNER_PLAN_HANDOFF_H
@@ -0,0 +1,99 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <stddef.h>
+
+#include <vector>
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_PLAN_SEGMENTATION_H
+#define FULL_COVERAGE_PATH_PLANNER_PLAN_SEGMENTATION_H
+
+#include "full_coverage_path_planner/common.h"
+
+/*
+ * Split a coverage walk over tiles into segments that each fit the energy or time of one battery charge: the robot
+ * drives from the dock to the start of a segment, covers it and drives back to the dock
+ */
+namespace full_coverage_path_planner
+{
+struct SegmentationParams
+{
+  /** Energy or time available per segment, in the unit of the costs below. 0 to not split */
+  double budget;
+
+  /** Cost of driving a meter, e.g. 1 / velocity for a budget in seconds */
+  double cost_per_meter;
+
+  /** Cost of turning a radian, e.g. 1 / yaw velocity for a budget in seconds */
+  double cost_per_radian;
+};
+
+struct PlanSegment
+{
+  size_t begin;  ///< Index of the first tile of the segment in the walk
+  size_t end;    ///< Index of the last tile, the next segment starts there
+  double cost;   ///< Including driving from the dock to begin and from end back to the dock
+  int approach;  ///< Distance from the dock to begin [tiles], 0 for the first segment
+  int retreat;   ///< Distance from end back to the dock [tiles]
+};
+
+/**
+ * Prefix sums of the length and the turns along a walk, so the cost of any part of it takes two lookups
+ */
+class PathCostTable
+{
+public:
+  void assign(std::vector<Point_t> const& path);
+
+  size_t size() const
+  {
+    return length_.size();
+  }
+
+  /**
+   * Distance along the walk from tile begin to tile end [tiles]
+   */
+  double length(size_t begin, size_t end) const
+  {
+    return length_[end] - length_[begin];
+  }
+
+  /**
+   * Sum of the absolute turns at the tiles strictly between begin and end [rad]
+   */
+  double turn(size_t begin, size_t end) const
+  {
+    return end > begin ? turn_[end - 1] - turn_[begin] : 0.0;
+  }
+
+private:
+  std::vector<double> length_;  ///< Distance from tile 0 to tile i
+  std::vector<double> turn_;    ///< Turns at the tiles 1 up to and including i
+};
+
+/**
+ * Breadth-first distance from the dock to every tile over the free tiles, 4-connected. The dock itself may be blocked
+ * (e.g. by the inflation of the wall it stands against)
+ * @param grid 2D grid of bools. true == occupied/blocked/obstacle
+ * @param dock position of the dock on the grid
+ * @param distance output, per tile (index y * width + x) the number of steps from the dock, -1 when unreachable
+ */
+void dockDistanceField(std::vector<std::vector<bool> > const& grid, Point_t const& dock, std::vector<int>& distance);
+
+/**
+ * Split a walk greedily into the longest segments that fit the budget. A segment can only end at a tile from which
+ * the dock is reachable. Linear in the length of the walk, apart from the tiles after each cut that are looked at
+ * before the budget runs out
+ * @param path tile walk
+ * @param table prefix sums of path
+ * @param distance dock distance field of the grid of the walk
+ * @param width width of the grid
+ * @param tile_size size of a tile [m]
+ * @param params budget and costs
+ * @param segments output, covering the whole walk
+ * @return false when a part of the walk does not fit in the budget (segments then holds the parts that do)
+ */
+bool segmentPath(std::vector<Point_t> const& path, PathCostTable const& table, std::vector<int> const& distance,
+                 int width, double tile_size, SegmentationParams const& params, std::vector<PlanSegment>& segments);
+}  // namespace full_coverage_path_planner
+#endif  // FULL_COVERAGE_PATH_PLANNER_PLAN_SEGMENTATION_H
@@ -0,0 +1,153 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <stdint.h>
+
+#include <list>
+#include <string>
+#include <vector>
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_PLANNING_ATLAS_H
+#define FULL_COVERAGE_PATH_PLANNER_PLANNING_ATLAS_H
+
+#include "full_coverage_path_planner/common.h"
+
+/*
+ * Precomputed plans for a fixed site: a coverage walk per zone, plus connector walks from every docking station to
+ * every zone and from the end of every zone to the start of every zone. The atlas is built offline
+ * (see build_atlas) and stored in a file that is memory-mapped at runtime, so a plan for a (dock, zone list) request
+ * is assembled by lookup and stitching instead of planning.
+ *
+ * File layout: AtlasFileHeader, dock_count AtlasTile, walkCount() AtlasWalkRecord, point_count AtlasTile.
+ */
+namespace full_coverage_path_planner
+{
+const uint32_t kAtlasMagic = 0x53414350;  // "PCAS"
+const uint32_t kAtlasVersion = 1;
+
+struct AtlasFileHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  double origin_x;  ///< Position of the corner of tile (0, 0) [m]
+  double origin_y;
+  double tile_size;  ///< [m]
+  int32_t width;  ///< Size of the tile grid
+  int32_t height;
+  uint32_t dock_count;
+  uint32_t zone_count;
+  uint64_t point_count;  ///< Total number of tiles of all walks
+};
+
+struct AtlasWalkRecord
+{
+  uint64_t offset;  ///< Index of the first tile of the walk
+  uint64_t length;  ///< Number of tiles, 0 when there is no walk (e.g. unreachable zone)
+};
+
+struct AtlasTile
+{
+  int32_t x;
+  int32_t y;
+};
+
+/**
+ * Contents of an atlas while it is being built
+ */
+struct AtlasContent
+{
+  double origin_x;
+  double origin_y;
+  double tile_size;
+  int width;
+  int height;
+  std::vector<Point_t> docks;
+  std::vector<std::list<Point_t> > zones;  ///< Coverage walk per zone, empty when a zone has no accessible tiles
+  std::vector<std::list<Point_t> > dock_connectors;  ///< [dock * zone_count + zone], from a dock to a zone start
+  std::vector<std::list<Point_t> > zone_connectors;  ///< [from * zone_count + to], from a zone end to a zone start
+};
+
+/**
+ * Shortest (4-connected) walks over free tiles from one tile to several others
+ * @param grid 2D grid of bools. true == occupied/blocked/obstacle. The source itself may be blocked
+ * @param source first tile of all walks
+ * @param targets last tiles of the walks
+ * @param walks output, one walk per target including both ends, empty when the target is unreachable
+ */
+void shortestWalks(std::vector<std::vector<bool> > const& grid, Point_t source, std::vector<Point_t> const& targets,
+                   std::vector<std::list<Point_t> >& walks);
+
+/**
+ * Compute the dock and zone connectors of an atlas of which the docks and zone walks are set
+ * @param grid tile grid the zone walks were planned on
+ * @param content atlas, dock_connectors and zone_connectors are overwritten
+ */
+void connectAtlas(std::vector<std::vector<bool> > const& grid, AtlasContent& content);
+
+/**
+ * Write an atlas to a file that can be opened with PlanningAtlas
+ * @return success
+ */
+bool writeAtlas(std::string const& file, AtlasContent const& content);
+
+/**
+ * Read-only, memory-mapped atlas
+ */
+class PlanningAtlas
+{
+public:
+  PlanningAtlas();
+  ~PlanningAtlas();
+  PlanningAtlas(PlanningAtlas const&) = delete;
+  PlanningAtlas& operator=(PlanningAtlas const&) = delete;
+
+  /**
+   * Map an atlas file
+   * @return whether the file exists and is a valid atlas
+   */
+  bool open(std::string const& file);
+
+  void close();
+
+  bool isOpen() const
+  {
+    return header_ != NULL;
+  }
+
+  AtlasFileHeader const& header() const
+  {
+    return *header_;
+  }
+
+  /**
+   * Closest docking station to a tile
+   * @param tile position on the tile grid
+   * @param distance_squared output squared distance to the dock [tiles^2]
+   * @return index of the dock, -1 when the atlas has no docks
+   */
+  int nearestDock(Point_t tile, int& distance_squared) const;
+
+  /**
+   * Stitch the plan from a dock over a list of zones
+   * @param dock index of the dock to start from
+   * @param zones indices of the zones to cover, in order
+   * @param walk output walk over tiles, without repeating the tiles where the pieces are stitched
+   * @return false when an index is invalid or a zone or connector does not exist
+   */
+  bool assemble(int dock, std::vector<int> const& zones, std::list<Point_t>& walk) const;
+
+private:
+  /**
+   * Append a walk, skipping its first tile when it continues the walk
+   */
+  bool append(uint64_t index, std::list<Point_t>& walk) const;
+
+  void* base_;
+  size_t size_;
+  AtlasFileHeader const* header_;
+  AtlasTile const* docks_;
+  AtlasWalkRecord const* walks_;
+  AtlasTile const* tiles_;
+};
+}  // namespace full_coverage_path_planner
+#endif  // FULL_COVERAGE_PATH_PLANNER_PLANNING_ATLAS_H
@@ -0,0 +1,146 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <nav_msgs/OccupancyGrid.h>
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_REQUEST_RECORDER_H
+#define FULL_COVERAGE_PATH_PLANNER_REQUEST_RECORDER_H
+
+#include "full_coverage_path_planner/common.h"
+#include "full_coverage_path_planner/grid_inflation.h"
+#include "full_coverage_path_planner/path_resampling.h"
+#include "full_coverage_path_planner/stroke_joins.h"
+
+/*
+ * Recording of the inputs of planning requests, so a slow plan from the field can be replayed offline
+ * (see fcpp_replay). Only whether a map cell is an obstacle matters to the planner, so the map is stored as one bit
+ * per cell.
+ *
+ * File layout: RecordedRequestHeader, roi_count fPoint_t, (width * height + 7) / 8 bytes of obstacle bits
+ * (row-major, least significant bit first).
+ */
+namespace full_coverage_path_planner
+{
+const uint32_t kRequestMagic = 0x51525046;  // "FPRQ"
+const uint32_t kRequestVersion = 2;  // 2: coverage engine and sparse grid
+
+/**
+ * Coverage engine of a recorded request
+ */
+enum RecordedEngine
+{
+  eRecordedSpiralStc = 0,
+  eRecordedContour = 1,
+};
+
+struct RecordedRequestHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  uint64_t sequence;  ///< Number of the request since recording started in the directory
+  double stamp;  ///< Wall time of the request [s since epoch]
+
+  // Map
+  uint32_t width;
+  uint32_t height;
+  double resolution;
+  double origin_x;
+  double origin_y;
+
+  // Start pose of the robot
+  double start_x;
+  double start_y;
+  double start_yaw;
+
+  // Planner settings
+  double robot_radius;
+  double tool_radius;
+  int32_t footprint_model;  ///< FootprintModel
+  double footprint_inscribed_radius;
+  double footprint_circumscribed_radius;
+  int32_t join_style;  ///< JoinStyle
+  double join_turn_radius;
+  double join_u_turn_width;
+  double join_spacing;
+  double join_v_depth;
+  double join_v_bottom_off_center;
+  int32_t resample_plan;
+  double resample_spacing;
+  double max_velocity;
+  double max_acceleration;
+  double max_lateral_acceleration;
+  int32_t coverage_engine;  ///< RecordedEngine
+  int32_t sparse_grid;  ///< Spiral on an IntervalGrid (spiral_stc engine only)
+  uint32_t roi_count;
+};
+
+/**
+ * Inputs of a planning request
+ */
+struct RecordedRequest
+{
+  RecordedRequestHeader header;
+  std::vector<fPoint_t> roi;
+  std::vector<uint8_t> obstacles;  ///< Obstacle bits of the map
+};
+
+/**
+ * Store the obstacle bits and the size of a map in a request
+ */
+void packMap(nav_msgs::OccupancyGrid const& map, RecordedRequest& request);
+
+/**
+ * Rebuild the map of a request, with 100 for obstacles and 0 for all other cells
+ */
+void unpackMap(RecordedRequest const& request, nav_msgs::OccupancyGrid& map);
+
+bool writeRequest(std::string const& file, RecordedRequest const& request);
+
+/**
+ * @return false when the file can not be read or is not a request of this version
+ */
+bool readRequest(std::string const& file, RecordedRequest& request);
+
+/**
+ * Rolling on-disk buffer of the last requests: request_<i>.fcppreq in a directory, for i in [0, capacity).
+ * After a restart, recording continues after the most recently written file.
+ */
+class RequestRecorder
+{
+public:
+  RequestRecorder();
+
+  /**
+   * @param directory is created when it does not exist
+   * @param capacity number of requests that are kept
+   * @return false when the directory can not be created
+   */
+  bool open(std::string const& directory, int capacity);
+
+  bool isOpen() const
+  {
+    return capacity_ > 0;
+  }
+
+  /**
+   * Overwrite the oldest request. The file is written under a temporary name first, so a reader never sees a
+   * partial request
+   * @param request request to record, gets the next sequence number
+   * @return the file the request was written to, empty on failure
+   */
+  std::string record(RecordedRequest& request);
+
+private:
+  std::string fileName(int index) const;
+
+  std::string directory_;
+  int capacity_;
+  uint64_t sequence_;  ///< Sequence number of the next request
+};
+}  // namespace full_coverage_path_planner
+#endif  // FULL_COVERAGE_PATH_PLANNER_REQUEST_RECORDER_H
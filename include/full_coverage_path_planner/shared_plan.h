@@ -0,0 +1,286 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_SHARED_PLAN_H
+#define FULL_COVERAGE_PATH_PLANNER_SHARED_PLAN_H
+
+/*
+ * Shared-memory transport for (very large) coverage plans.
+ *
+ * The planner writes every plan into a slot of a POSIX shared-memory ring buffer and publishes a small
+ * SharedPlanHandle message (shm name, slot, sequence, pose count) that points at it. Co-located consumers map
+ * the segment once with SharedPlanReader and read the poses in place, without deserializing a nav_msgs/Path.
+ *
+ * Layout of the segment: SharedPlanHeader, slot_count SharedPlanSlot records, slot_count * slot_capacity poses.
+ * A slot is overwritten after slot_count newer plans; its sequence number tells readers whether it still holds
+ * the plan they were pointed at (seqlock: check valid() again after reading).
+ */
+namespace full_coverage_path_planner
+{
+const uint32_t kSharedPlanMagic = 0x46435050;  // "FCPP"
+const uint32_t kSharedPlanVersion = 1;
+
+/** Pose of a shared plan, in the frame of the SharedPlanHandle message */
+struct SharedPlanPose
+{
+  double x;
+  double y;
+  double yaw;
+};
+
+struct SharedPlanHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t slot_count;
+  uint32_t slot_capacity;  ///< Maximum number of poses per slot
+  std::atomic<uint64_t> last_sequence;  ///< Sequence of the last committed plan, 0 when none
+};
+
+struct SharedPlanSlot
+{
+  std::atomic<uint64_t> sequence;  ///< Sequence of the plan in this slot, 0 while it is being written
+  uint64_t pose_count;
+};
+
+/** Where a plan is stored in the ring buffer */
+struct SharedPlanSlotRef
+{
+  uint32_t slot;
+  uint64_t sequence;
+  uint32_t pose_count;
+};
+
+inline size_t sharedPlanSize(uint32_t slot_count, uint32_t slot_capacity)
+{
+  return sizeof(SharedPlanHeader) + slot_count * sizeof(SharedPlanSlot) +
+         static_cast<size_t>(slot_count) * slot_capacity * sizeof(SharedPlanPose);
+}
+
+inline SharedPlanSlot* sharedPlanSlot(void* base, uint32_t slot)
+{
+  return reinterpret_cast<SharedPlanSlot*>(static_cast<char*>(base) + sizeof(SharedPlanHeader)) + slot;
+}
+
+inline SharedPlanPose* sharedPlanPoses(void* base, uint32_t slot)
+{
+  SharedPlanHeader* header = static_cast<SharedPlanHeader*>(base);
+  return reinterpret_cast<SharedPlanPose*>(sharedPlanSlot(base, header->slot_count)) +
+         static_cast<size_t>(slot) * header->slot_capacity;
+}
+
+/**
+ * Owner of the shared-memory segment: creates it on open() and removes it on close()
+ */
+class SharedPlanWriter
+{
+public:
+  SharedPlanWriter();
+  ~SharedPlanWriter();
+  SharedPlanWriter(SharedPlanWriter const&) = delete;
+  SharedPlanWriter& operator=(SharedPlanWriter const&) = delete;
+
+  /**
+   * Create (or recreate) the shared-memory segment
+   * @param name POSIX shm name, e.g. "/fcpp_plan"
+   * @param slot_count number of plans kept in the ring buffer
+   * @param slot_capacity maximum number of poses of a plan
+   * @return success, errno is set on failure
+   */
+  bool open(std::string const& name, uint32_t slot_count, uint32_t slot_capacity);
+
+  /**
+   * Unmap and unlink the segment
+   */
+  void close();
+
+  bool isOpen() const
+  {
+    return base_ != NULL;
+  }
+
+  std::string const& name() const
+  {
+    return name_;
+  }
+
+  /**
+   * Claim the next slot of the ring buffer; readers see it as invalid until commit()
+   * @param pose_count number of poses that will be written
+   * @param ref output slot and sequence
+   * @return poses to fill in, NULL when the segment is not open or the plan does not fit in a slot
+   */
+  SharedPlanPose* beginWrite(uint32_t pose_count, SharedPlanSlotRef& ref);
+
+  /**
+   * Publish a slot claimed by beginWrite() to readers
+   */
+  void commit(SharedPlanSlotRef const& ref);
+
+private:
+  std::string name_;
+  void* base_;
+  size_t size_;
+};
+
+/**
+ * Read-only view on a segment created by SharedPlanWriter. Header-only, so consumers do not need to link the planner
+ */
+class SharedPlanReader
+{
+public:
+  SharedPlanReader() : base_(NULL), size_(0)
+  {
+  }
+
+  ~SharedPlanReader()
+  {
+    close();
+  }
+
+  SharedPlanReader(SharedPlanReader const&) = delete;
+  SharedPlanReader& operator=(SharedPlanReader const&) = delete;
+
+  /**
+   * Map an existing segment
+   * @param name POSIX shm name from the SharedPlanHandle message
+   * @return whether the segment exists and has the expected layout
+   */
+  bool open(std::string const& name)
+  {
+    close();
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+    {
+      return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SharedPlanHeader))
+    {
+      ::close(fd);
+      return false;
+    }
+    void* base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED)
+    {
+      return false;
+    }
+    SharedPlanHeader const* header = static_cast<SharedPlanHeader const*>(base);
+    if (header->magic != kSharedPlanMagic || header->version != kSharedPlanVersion ||
+        static_cast<size_t>(st.st_size) < sharedPlanSize(header->slot_count, header->slot_capacity))
+    {
+      munmap(base, st.st_size);
+      return false;
+    }
+    base_ = base;
+    size_ = st.st_size;
+    name_ = name;
+    return true;
+  }
+
+  void close()
+  {
+    if (base_ != NULL)
+    {
+      munmap(base_, size_);
+    }
+    base_ = NULL;
+    size_ = 0;
+    name_.clear();
+  }
+
+  bool isOpen() const
+  {
+    return base_ != NULL;
+  }
+
+  std::string const& name() const
+  {
+    return name_;
+  }
+
+  /**
+   * Whether the slot (still) holds the plan with the given sequence number
+   */
+  bool valid(SharedPlanSlotRef const& ref) const
+  {
+    if (base_ == NULL || ref.slot >= header()->slot_count)
+    {
+      return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return sharedPlanSlot(base_, ref.slot)->sequence.load(std::memory_order_acquire) == ref.sequence;
+  }
+
+  /**
+   * Zero-copy access to the poses of a plan. The writer may overwrite them after slot_count newer plans,
+   * so check valid() again after reading
+   * @return ref.pose_count poses, NULL when the slot does not hold this plan (anymore)
+   */
+  SharedPlanPose const* poses(SharedPlanSlotRef const& ref) const
+  {
+    if (!valid(ref) || ref.pose_count > sharedPlanSlot(base_, ref.slot)->pose_count)
+    {
+      return NULL;
+    }
+    return sharedPlanPoses(base_, ref.slot);
+  }
+
+  /**
+   * Copy the poses of a plan
+   * @return false when the slot does not hold this plan (anymore), also when it was overwritten while copying
+   */
+  bool copy(SharedPlanSlotRef const& ref, std::vector<SharedPlanPose>& out) const
+  {
+    SharedPlanPose const* poses = this->poses(ref);
+    if (poses == NULL)
+    {
+      return false;
+    }
+    out.assign(poses, poses + ref.pose_count);
+    return valid(ref);
+  }
+
+  /**
+   * Slot of the most recent plan, for consumers that do not subscribe to the handle topic
+   */
+  bool latest(SharedPlanSlotRef& ref) const
+  {
+    if (base_ == NULL)
+    {
+      return false;
+    }
+    uint64_t sequence = header()->last_sequence.load(std::memory_order_acquire);
+    if (sequence == 0)
+    {
+      return false;
+    }
+    ref.slot = sequence % header()->slot_count;
+    ref.sequence = sequence;
+    ref.pose_count = sharedPlanSlot(base_, ref.slot)->pose_count;
+    return valid(ref);
+  }
+
+private:
+  SharedPlanHeader const* header() const
+  {
+    return static_cast<SharedPlanHeader const*>(base_);
+  }
+
+  std::string name_;
+  void* base_;
+  size_t size_;
+};
+}  // namespace full_coverage_path_planner
+#endif  // FULL_COVERAGE_PATH_PLANNER_SHARED_PLAN_H
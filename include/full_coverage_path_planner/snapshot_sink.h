@@ -0,0 +1,62 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <stddef.h>
+
+#include <vector>
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_SNAPSHOT_SINK_H
+#define FULL_COVERAGE_PATH_PLANNER_SNAPSHOT_SINK_H
+
+#include "full_coverage_path_planner/common.h"
+#include "full_coverage_path_planner/interval_grid.h"
+
+namespace full_coverage_path_planner
+{
+/**
+ * Moment of the spiral_stc search a snapshot is taken at
+ */
+enum SnapshotStage
+{
+  eSnapshotStart = 0,   ///< Before the first spiral, the segment is the start tile
+  eSnapshotSpiral = 1,  ///< After a spiral, the segment is the path since the previous spiral
+  eSnapshotEscape = 2,  ///< After an A* escape to open space, the segment is the escape path
+};
+
+/**
+ * Receiver of the state of the spiral_stc search, to debug it on real maps at runtime (see AsyncSnapshotWriter).
+ * The search calls capture only while enabled() is true and does not wait for the snapshot to be processed
+ */
+class SnapshotSink
+{
+public:
+  virtual ~SnapshotSink()
+  {
+  }
+
+  virtual bool enabled() const = 0;
+
+  /**
+   * Called at the start of every search, the snapshots that follow belong to a new plan
+   */
+  virtual void beginPlan() = 0;
+
+  /**
+   * @param grid 2D grid of bools. true == occupied/blocked/obstacle
+   * @param visited visited tiles so far, true == visited
+   * @param segment path of the last spiral or escape
+   * @param goals number of open tiles that are left, 0 at the start
+   */
+  virtual void capture(SnapshotStage stage, std::vector<std::vector<bool> > const& grid,
+                       std::vector<std::vector<bool> > const& visited, std::vector<gridNode_t> const& segment,
+                       size_t goals) = 0;
+
+  /**
+   * Same as capture above, on the free tiles of an interval grid
+   * @param visited per free tile, true == visited
+   */
+  virtual void capture(SnapshotStage stage, IntervalGrid const& grid, std::vector<bool> const& visited,
+                       std::vector<gridNode_t> const& segment, size_t goals) = 0;
+};
+}  // namespace full_coverage_path_planner
+#endif  // FULL_COVERAGE_PATH_PLANNER_SNAPSHOT_SINK_H
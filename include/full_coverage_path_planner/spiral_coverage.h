@@ -0,0 +1,84 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <vector>
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_SPIRAL_COVERAGE_H
+#define FULL_COVERAGE_PATH_PLANNER_SPIRAL_COVERAGE_H
+
+#include "full_coverage_path_planner/common.h"
+#include "full_coverage_path_planner/interval_grid.h"
+#include "full_coverage_path_planner/snapshot_sink.h"
+
+/*
+ * Spiral-STC engine without any ROS dependency, shared by the ROS 1 plugin (SpiralSTC, which exposes these as static
+ * members) and the Nav2 plugin (Nav2SpiralSTC)
+ */
+namespace full_coverage_path_planner
+{
+/**
+ * Buffers of spiral_stc that are kept between plans, so planning again on a grid of the same size does not allocate
+ */
+struct SpiralWorkspace
+{
+  SpiralWorkspace() : snapshots(NULL)
+  {
+  }
+
+  std::vector<std::vector<bool> > visited;
+  std::vector<gridNode_t> pathNodes;
+  std::vector<Point_t> goals;
+  AStarWorkspace a_star;
+  SnapshotSink* snapshots;  ///< Optional, not owned
+};
+
+/**
+ * Buffers of spiral_stc on an IntervalGrid, the per-tile state only covers the free tiles
+ */
+struct IntervalSpiralWorkspace
+{
+  IntervalSpiralWorkspace() : snapshots(NULL)
+  {
+  }
+
+  std::vector<bool> visited;  ///< Indexed by IntervalGrid::index()
+  std::vector<gridNode_t> pathNodes;
+  std::vector<Point_t> goals;
+  AStarWorkspace a_star;
+  SnapshotSink* snapshots;  ///< Optional, not owned
+};
+
+/**
+ * Find a path that spirals inwards from the end of pathNodes until an obstacle is seen in the grid
+ * @param grid 2D grid of bools. true == occupied/blocked/obstacle
+ * @param pathNodes start of the spiral, the nodes of the spiral are appended
+ * @param visited all the nodes visited by the spiral
+ */
+void spiralFill(std::vector<std::vector<bool> > const& grid, std::vector<gridNode_t>& pathNodes,
+                std::vector<std::vector<bool> >& visited);
+
+/**
+ * Perform Spiral-STC (Spanning Tree Coverage) coverage path planning, with all buffers in a workspace that is reused
+ * between plans. Once the workspace and fullPath have grown to the size of the grid, planning does not allocate.
+ * Afterwards workspace.a_star.expansions holds the number of A* expansions of the plan
+ * @param grid 2D grid of bools. true == occupied/blocked/obstacle
+ * @param init start position
+ * @param workspace buffers reused between plans
+ * @param fullPath output path, keeps its capacity
+ */
+void spiralCoverage(std::vector<std::vector<bool> > const& grid, Point_t const& init, SpiralWorkspace& workspace,
+                    std::vector<Point_t>& fullPath, int& multiple_pass_counter, int& visited_counter);
+
+/**
+ * Same as spiralFill above, on the free tiles of an interval grid
+ * @param visited per free tile, true == visited
+ */
+void spiralFill(IntervalGrid const& grid, std::vector<gridNode_t>& pathNodes, std::vector<bool>& visited);
+
+/**
+ * Same as spiralCoverage above, on the free tiles of an interval grid, with the same result
+ */
+void spiralCoverage(IntervalGrid const& grid, Point_t const& init, IntervalSpiralWorkspace& workspace,
+                    std::vector<Point_t>& fullPath, int& multiple_pass_counter, int& visited_counter);
+}  // namespace full_coverage_path_planner
+#endif  // FULL_COVERAGE_PATH_PLANNER_SPIRAL_COVERAGE_H
@@ -9,6 +9,7 @@
 #include <pluginlib/class_list_macros.h>
 #include <costmap_2d/costmap_2d_ros.h>
 #include <costmap_2d/costmap_2d.h>
+#include <costmap_2d/footprint.h>
 #include <nav_core/base_global_planner.h>
 #include <nav_msgs/Path.h>
 #include <nav_msgs/GetMap.h>
@@ -23,7 +24,11 @@ using std::string;
 #ifndef FULL_COVERAGE_PATH_PLANNER_SPIRAL_STC_H
 #define FULL_COVERAGE_PATH_PLANNER_SPIRAL_STC_H
 
+#include "full_coverage_path_planner/contour_coverage.h"
+#include "full_coverage_path_planner/debug_snapshots.h"
 #include "full_coverage_path_planner/full_coverage_path_planner.h"
+#include "full_coverage_path_planner/interval_grid.h"
+#include "full_coverage_path_planner/spiral_coverage.h"
 namespace full_coverage_path_planner
 {
 class SpiralSTC : public nav_core::BaseGlobalPlanner, private full_coverage_path_planner::FullCoveragePathPlanner
@@ -52,6 +57,77 @@ public:
                                         int &multiple_pass_counter,
                                         int &visited_counter);
 
+  /**
+   * Same as spiral above, extending pathNodes in place
+   * @param grid 2D grid of bools. true == occupied/blocked/obstacle
+   * @param pathNodes start of the spiral, the nodes of the spiral are appended
+   * @param visited all the nodes visited by the spiral
+   */
+  static void spiral(std::vector<std::vector<bool> > const &grid, std::vector<gridNode_t> &pathNodes,
+                     std::vector<std::vector<bool> > &visited);
+
+  /**
+   * Same as spiral_stc above, but with all buffers in a workspace that is reused between plans. Once the workspace
+   * and fullPath have grown to the size of the grid, planning does not allocate.
+   * Afterwards workspace.a_star.expansions holds the number of A* expansions of the plan
+   * @param grid 2D grid of bools. true == occupied/blocked/obstacle
+   * @param init start position
+   * @param workspace buffers reused between plans
+   * @param fullPath output path, keeps its capacity
+   */
+  static void spiral_stc(std::vector<std::vector<bool> > const &grid,
+                         Point_t const &init,
+                         SpiralWorkspace &workspace,
+                         std::vector<Point_t> &fullPath,
+                         int &multiple_pass_counter,
+                         int &visited_counter);
+
+  /**
+   * Same as spiral above, on the free tiles of an interval grid
+   * @param grid free tiles
+   * @param pathNodes start of the spiral, the nodes of the spiral are appended
+   * @param visited per free tile, true == visited
+   */
+  static void spiral(IntervalGrid const &grid, std::vector<gridNode_t> &pathNodes, std::vector<bool> &visited);
+
+  /**
+   * Same as the workspace version of spiral_stc above, on the free tiles of an interval grid, with the same result.
+   * For maps that are mostly obstacle: memory and the scans for open space scale with the free tiles instead of the
+   * bounding box of the grid
+   * @param grid free tiles
+   * @param init start position
+   * @param workspace buffers reused between plans
+   * @param fullPath output path, keeps its capacity
+   */
+  static void spiral_stc(IntervalGrid const &grid,
+                         Point_t const &init,
+                         IntervalSpiralWorkspace &workspace,
+                         std::vector<Point_t> &fullPath,
+                         int &multiple_pass_counter,
+                         int &visited_counter);
+
+  /**
+   * Build a planning atlas for a fixed site: a spiral per zone and connectors from the docks to the zones and
+   * between the zones, see planning_atlas.h. Uses the same parameters as makePlan to parse the map
+   * @param map map of the site
+   * @param zones polygons of the zones (in map coordinates), each entered at its free tile closest to its first point
+   * @param docks positions of the docking stations (in map coordinates)
+   * @param file output file
+   * @return success
+   */
+  bool buildAtlas(nav_msgs::OccupancyGrid const& map, std::vector<std::vector<fPoint_t> > const& zones,
+                  std::vector<fPoint_t> const& docks, std::string const& file);
+
+  /**
+   * Same as buildAtlas above, on a map_server map file that is read straight into tiles (see loadTileGrid)
+   * @param map_file path of the map_server yaml file of the site
+   */
+  bool buildAtlas(std::string const& map_file, std::vector<std::vector<fPoint_t> > const& zones,
+                  std::vector<fPoint_t> const& docks, std::string const& file);
+
+  using FullCoveragePathPlanner::parsePoints;
+  using FullCoveragePathPlanner::parsePolygon;
+
 private:
   /**
    * @brief Given a goal pose in the world, compute a plan
@@ -69,6 +145,32 @@ private:
    * @param  costmap A pointer to the ROS wrapper of the costmap to use for planning
    */
   void initialize(std::string name, costmap_2d::Costmap2DROS* costmap_ros);
+
+  /**
+   * Build and write the atlas on a grid from parseGrid or parseTileGrid, see buildAtlas
+   */
+  bool buildAtlasOnGrid(std::vector<std::vector<bool> > const& grid, std::vector<std::vector<fPoint_t> > const& zones,
+                        std::vector<fPoint_t> const& docks, std::string const& file);
+
+  /**
+   * New map, parsed at the next plan
+   */
+  void mapCallback(const nav_msgs::OccupancyGrid::ConstPtr& map);
+
+  /**
+   * Map update, applied to the grid of the previous plan
+   */
+  void mapUpdateCallback(const map_msgs::OccupancyGridUpdate::ConstPtr& update);
+
+  SpiralWorkspace spiral_workspace_;
+  std::vector<Point_t> spiral_path_;
+  IntervalGrid interval_grid_;
+  IntervalSpiralWorkspace interval_workspace_;
+  ContourWorkspace contour_workspace_;
+  AsyncSnapshotWriter snapshot_writer_;
+  std::string debug_snapshots_param_;  ///< Resolved name of the debug_snapshots parameter, read every plan
+  ros::Subscriber map_sub_;  ///< Only subscribed with map_updates
+  ros::Subscriber map_update_sub_;
 };
 
 }  // namespace full_coverage_path_planner
@@ -0,0 +1,61 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <vector>
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_STROKE_JOINS_H
+#define FULL_COVERAGE_PATH_PLANNER_STROKE_JOINS_H
+
+namespace full_coverage_path_planner
+{
+/**
+ * Position (in meters) and heading (in radians) along a plan
+ */
+struct Waypoint
+{
+  double x, y, yaw;
+};
+
+/**
+ * How two strokes of a coverage path are joined
+ */
+enum JoinStyle
+{
+  eJoinNone = 0,        ///< Keep the tile corners: stop and turn on the spot
+  eJoinHalfCircle = 1,  ///< Circular arcs: a fillet for 90 degree turns, a half circle for 180 degree turns
+  eJoinMwm = 2,         ///< Fillet for 90 degree turns, a V for 180 degree turns (the strokes then form an M or W)
+};
+
+struct StrokeJoinParams
+{
+  JoinStyle style;
+
+  /** Radius of the fillet that replaces a 90 degree corner [m] */
+  double turn_radius;
+
+  /** Two successive 90 degree turns in the same direction at most this far apart form a 180 degree turn [m] */
+  double u_turn_width;
+
+  /** Distance between the poses emitted on an arc [m] */
+  double spacing;
+
+  /** Depth of the V of an M/W join, relative to the distance between the strokes */
+  double v_depth;
+
+  /** Sideways shift of the bottom of the V, relative to half of the distance between the strokes */
+  double v_bottom_off_center;
+};
+
+/**
+ * Replace the 90 and 180 degree tile-corner turns of a plan by smooth joins (port of stroke_joins.py).
+ *
+ * Consecutive waypoints at the same position are merged, corners that are not joined keep the stop-and-turn
+ * behaviour of the original plan: the corner is emitted with both the incoming and the outgoing heading.
+ * The heading of the first waypoint is kept, so the plan still starts at the robot pose.
+ * @param path waypoints of the plan
+ * @param params how to join the strokes
+ * @return smoothed waypoints
+ */
+std::vector<Waypoint> smoothStrokeJoins(std::vector<Waypoint> const& path, StrokeJoinParams const& params);
+}  // namespace full_coverage_path_planner
+#endif  // FULL_COVERAGE_PATH_PLANNER_STROKE_JOINS_H
@@ -0,0 +1,111 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <cmath>
+#include <vector>
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_TILE_WALK_H
+#define FULL_COVERAGE_PATH_PLANNER_TILE_WALK_H
+
+#include "full_coverage_path_planner/stroke_joins.h"
+
+/*
+ * Conversion of the walk over tiles that the coverage engines produce into poses, without any ROS dependency so the
+ * ROS 1 and the Nav2 plugin build the same plan
+ */
+enum
+{
+  eDirNone = 0,
+  eDirRight = 1,
+  eDirUp = 2,
+  eDirLeft = -1,
+  eDirDown = -2,
+};
+
+namespace full_coverage_path_planner
+{
+/**
+ * Poses at the centers of the tiles where a walk starts, changes direction or ends, heading in the direction of
+ * movement. At a change of direction the previous pose is repeated with the new heading, so a follower turns on the
+ * spot before the next stroke
+ * @param begin, end tiles (anything with .x and .y) of the walk, bidirectional iterators
+ * @param tile_size size of a tile [m]
+ * @param origin_x, origin_y position of the corner of tile (0, 0) [m]
+ * @param waypoints the poses are appended
+ */
+template <class Iterator>
+void tileWalkToWaypoints(Iterator begin, Iterator end, double tile_size, double origin_x, double origin_y,
+                         std::vector<Waypoint>& waypoints)
+{
+  if (begin == end)
+  {
+    return;
+  }
+  Iterator last = end;
+  --last;
+  if (begin == last)
+  {
+    Waypoint only = { (begin->x + 0.5) * tile_size + origin_x, (begin->y + 0.5) * tile_size + origin_y, 0.0 };
+    waypoints.push_back(only);
+    return;
+  }
+
+  double yaw = 0.0;
+  Waypoint previous = { 0.0, 0.0, 0.0 };
+  for (Iterator it = begin; it != end; ++it)
+  {
+    // Direction of movement into this tile and out of it, dx + dy * 2 is unique for each of the four directions
+    Iterator next = it;
+    ++next;
+    int move_dir_now, move_dir_next = eDirNone;
+    if (it == begin)
+    {
+      move_dir_now = (next->x - it->x) + (next->y - it->y) * 2;
+    }
+    else
+    {
+      Iterator prev = it;
+      --prev;
+      move_dir_now = (it->x - prev->x) + (it->y - prev->y) * 2;
+      if (next != end)
+      {
+        move_dir_next = (next->x - it->x) + (next->y - it->y) * 2;
+      }
+    }
+
+    // Only the first and last tile and changes of direction become a pose
+    if (it != begin && next != end && move_dir_next == move_dir_now)
+    {
+      continue;
+    }
+    switch (move_dir_now)
+    {
+    case eDirRight:
+      yaw = 0;
+      break;
+    case eDirUp:
+      yaw = M_PI / 2;
+      break;
+    case eDirLeft:
+      yaw = M_PI;
+      break;
+    case eDirDown:
+      yaw = M_PI * 1.5;
+      break;
+    default:
+      // Keep orientation
+      break;
+    }
+    Waypoint pose = { (it->x + 0.5) * tile_size + origin_x, (it->y + 0.5) * tile_size + origin_y, yaw };
+    if (it != begin)
+    {
+      // Repeat the previous pose with the new heading to indicate the change of direction
+      previous.yaw = yaw;
+      waypoints.push_back(previous);
+    }
+    waypoints.push_back(pose);
+    previous = pose;
+  }
+}
+}  // namespace full_coverage_path_planner
+#endif  // FULL_COVERAGE_PATH_PLANNER_TILE_WALK_H
@@ -0,0 +1,41 @@
+# Planner server with the coverage plugin and the controller server in one component container. With intra-process
+# communication the plan published on Coverage/coverage_plan is handed to subscribers in the same container without
+# serialization or a copy.
+import os
+
+from ament_index_python.packages import get_package_share_directory
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument
+from launch.substitutions import LaunchConfiguration
+from launch_ros.actions import ComposableNodeContainer
+from launch_ros.descriptions import ComposableNode
+
+
+def generate_launch_description():
+    default_params = os.path.join(get_package_share_directory('full_coverage_path_planner'), 'launch',
+                                  'nav2_coverage_params.yaml')
+    params_file = LaunchConfiguration('params_file')
+    extra_arguments = [{'use_intra_process_comms': True}]
+
+    container = ComposableNodeContainer(
+        name='coverage_container',
+        namespace='',
+        package='rclcpp_components',
+        executable='component_container_isolated',
+        composable_node_descriptions=[
+            ComposableNode(package='nav2_planner', plugin='nav2_planner::PlannerServer', name='planner_server',
+                           parameters=[params_file], extra_arguments=extra_arguments),
+            ComposableNode(package='nav2_controller', plugin='nav2_controller::ControllerServer',
+                           name='controller_server', parameters=[params_file], extra_arguments=extra_arguments),
+            ComposableNode(package='nav2_lifecycle_manager', plugin='nav2_lifecycle_manager::LifecycleManager',
+                           name='lifecycle_manager_coverage',
+                           parameters=[{'autostart': True, 'node_names': ['planner_server', 'controller_server']}]),
+        ],
+        output='screen',
+    )
+
+    return LaunchDescription([
+        DeclareLaunchArgument('params_file', default_value=default_params,
+                              description='Parameters of the planner and controller server'),
+        container,
+    ])
@@ -0,0 +1,329 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <cmath>
+#include <cstdlib>
+#include <list>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <full_coverage_path_planner/benchmark.h>
+
+namespace full_coverage_path_planner
+{
+namespace
+{
+/**
+ * Whether a is at least as good as b in every objective and better in at least one
+ */
+bool dominates(BenchmarkMetrics const& a, BenchmarkMetrics const& b)
+{
+  bool no_worse = a.wall_time_s <= b.wall_time_s && a.peak_memory_kb <= b.peak_memory_kb &&
+                  a.path_length_m <= b.path_length_m && a.turns <= b.turns &&
+                  a.multiple_pass_counter <= b.multiple_pass_counter && a.accessible_counter >= b.accessible_counter;
+  bool better = a.wall_time_s < b.wall_time_s || a.peak_memory_kb < b.peak_memory_kb ||
+                a.path_length_m < b.path_length_m || a.turns < b.turns ||
+                a.multiple_pass_counter < b.multiple_pass_counter || a.accessible_counter > b.accessible_counter;
+  return no_worse && better;
+}
+
+std::string jsonString(std::string const& s)
+{
+  std::string quoted = "\"";
+  for (size_t i = 0; i < s.size(); ++i)
+  {
+    if (s[i] == '"' || s[i] == '\\')
+    {
+      quoted += '\\';
+    }
+    quoted += s[i];
+  }
+  return quoted + "\"";
+}
+
+/**
+ * Whether any counter of the run was collected
+ */
+bool counted(BenchmarkMetrics const& metrics)
+{
+  return metrics.counts[ePhaseCoverage].values[ePerfCycles] >= 0;
+}
+
+/**
+ * Count per grid cell, n/a when the event was not counted
+ */
+std::string perCell(int64_t count, int cells)
+{
+  if (count < 0 || cells <= 0)
+  {
+    return "n/a";
+  }
+  std::stringstream value;
+  value << static_cast<double>(count) / cells;
+  return value.str();
+}
+}  // namespace
+
+char const* benchmarkPhaseName(int phase)
+{
+  static char const* names[ePhaseCount] = { "parse", "coverage", "a_star", "conversion" };
+  return phase >= 0 && phase < ePhaseCount ? names[phase] : "";
+}
+
+bool parseBenchmarkConfig(std::string const& spec, BenchmarkConfig& config)
+{
+  std::stringstream fields(spec);
+  std::string field;
+  while (std::getline(fields, field, ','))
+  {
+    size_t equals = field.find('=');
+    if (equals == std::string::npos)
+    {
+      return false;
+    }
+    std::string key = field.substr(0, equals), value = field.substr(equals + 1);
+    if (key == "name")
+    {
+      config.name = value;
+    }
+    else if (key == "engine" && (value == "spiral_stc" || value == "contour"))
+    {
+      config.engine = value;
+    }
+    else if (key == "robot_radius" && atof(value.c_str()) > 0.0)
+    {
+      config.robot_radius = atof(value.c_str());
+    }
+    else if (key == "tool_radius" && atof(value.c_str()) > 0.0)
+    {
+      config.tool_radius = atof(value.c_str());
+    }
+    else if (key == "footprint_model" && (value == "square" || value == "circle"))
+    {
+      config.footprint_model = value;
+    }
+    else if (key == "join_style" && (value == "none" || value == "half_circle" || value == "mwm"))
+    {
+      config.join_style = value;
+    }
+    else
+    {
+      return false;
+    }
+  }
+  if (config.name.empty())
+  {
+    config.name = spec;
+  }
+  return true;
+}
+
+std::vector<BenchmarkConfig> defaultBenchmarkConfigs(double robot_radius, double tool_radius)
+{
+  char const* engines[] = { "spiral_stc", "contour" };
+  char const* footprint_models[] = { "square", "circle" };
+  char const* join_styles[] = { "none", "half_circle", "mwm" };
+  std::vector<BenchmarkConfig> configs;
+  for (int e = 0; e < 2; ++e)
+  {
+    for (int f = 0; f < 2; ++f)
+    {
+      for (int j = 0; j < 3; ++j)
+      {
+        BenchmarkConfig config;
+        config.engine = engines[e];
+        config.robot_radius = robot_radius;
+        config.tool_radius = tool_radius;
+        config.footprint_model = footprint_models[f];
+        config.join_style = join_styles[j];
+        config.name = config.engine + "/" + config.footprint_model + "/" + config.join_style;
+        configs.push_back(config);
+      }
+    }
+  }
+  return configs;
+}
+
+int countTurns(std::list<Point_t> const& walk)
+{
+  int turns = 0, dx_prev = 0, dy_prev = 0;
+  std::list<Point_t>::const_iterator prev = walk.begin();
+  for (std::list<Point_t>::const_iterator it = walk.begin(); it != walk.end(); prev = it++)
+  {
+    int dx = it->x - prev->x, dy = it->y - prev->y;
+    if (dx == 0 && dy == 0)
+    {
+      continue;
+    }
+    turns += (dx_prev != 0 || dy_prev != 0) && (dx != dx_prev || dy != dy_prev);
+    dx_prev = dx;
+    dy_prev = dy;
+  }
+  return turns;
+}
+
+void measurePlan(std::vector<Waypoint> const& plan, BenchmarkMetrics& metrics)
+{
+  metrics.path_length_m = 0.0;
+  metrics.total_rotation_rad = 0.0;
+  metrics.waypoint_count = plan.size();
+  for (size_t i = 1; i < plan.size(); ++i)
+  {
+    metrics.path_length_m += std::hypot(plan[i].x - plan[i - 1].x, plan[i].y - plan[i - 1].y);
+    metrics.total_rotation_rad += std::fabs(std::remainder(plan[i].yaw - plan[i - 1].yaw, 2 * M_PI));
+  }
+}
+
+void markParetoFront(std::vector<BenchmarkResult>& results)
+{
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    results[i].pareto = results[i].metrics.success;
+    for (size_t j = 0; j < results.size() && results[i].pareto; ++j)
+    {
+      results[i].pareto = !(j != i && results[j].map == results[i].map && results[j].metrics.success &&
+                            dominates(results[j].metrics, results[i].metrics));
+    }
+  }
+}
+
+void writeCsv(std::ostream& out, std::vector<BenchmarkResult> const& results)
+{
+  out << "map,config,engine,robot_radius,tool_radius,footprint_model,join_style,success,wall_time_s,parse_time_s,"
+         "peak_memory_kb,path_length_m,total_rotation_rad,turns,waypoint_count,multiple_pass_counter,"
+         "accessible_counter,pareto,grid_cells";
+  for (int p = 0; p < ePhaseCount; ++p)
+  {
+    for (int e = 0; e < ePerfEventCount; ++e)
+    {
+      out << "," << benchmarkPhaseName(p) << "_" << perfEventName(e);
+    }
+  }
+  out << "\n";
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    BenchmarkResult const& r = results[i];
+    out << r.map << "," << r.config.name << "," << r.config.engine << "," << r.config.robot_radius << ","
+        << r.config.tool_radius << "," << r.config.footprint_model << "," << r.config.join_style << ","
+        << r.metrics.success << "," << r.metrics.wall_time_s << "," << r.metrics.parse_time_s << ","
+        << r.metrics.peak_memory_kb << "," << r.metrics.path_length_m << "," << r.metrics.total_rotation_rad << ","
+        << r.metrics.turns << "," << r.metrics.waypoint_count << "," << r.metrics.multiple_pass_counter << ","
+        << r.metrics.accessible_counter << "," << r.pareto << "," << r.metrics.grid_cells;
+    for (int p = 0; p < ePhaseCount; ++p)
+    {
+      for (int e = 0; e < ePerfEventCount; ++e)
+      {
+        out << "," << r.metrics.counts[p].values[e];
+      }
+    }
+    out << "\n";
+  }
+}
+
+void writeJson(std::ostream& out, std::vector<BenchmarkResult> const& results)
+{
+  out << "[\n";
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    BenchmarkResult const& r = results[i];
+    out << "  {\"map\": " << jsonString(r.map) << ", \"config\": " << jsonString(r.config.name)
+        << ", \"engine\": " << jsonString(r.config.engine) << ", \"robot_radius\": " << r.config.robot_radius
+        << ", \"tool_radius\": " << r.config.tool_radius
+        << ", \"footprint_model\": " << jsonString(r.config.footprint_model)
+        << ", \"join_style\": " << jsonString(r.config.join_style)
+        << ", \"success\": " << (r.metrics.success ? "true" : "false")
+        << ", \"wall_time_s\": " << r.metrics.wall_time_s << ", \"parse_time_s\": " << r.metrics.parse_time_s
+        << ", \"peak_memory_kb\": " << r.metrics.peak_memory_kb << ", \"path_length_m\": " << r.metrics.path_length_m
+        << ", \"total_rotation_rad\": " << r.metrics.total_rotation_rad << ", \"turns\": " << r.metrics.turns
+        << ", \"waypoint_count\": " << r.metrics.waypoint_count
+        << ", \"multiple_pass_counter\": " << r.metrics.multiple_pass_counter
+        << ", \"accessible_counter\": " << r.metrics.accessible_counter
+        << ", \"pareto\": " << (r.pareto ? "true" : "false") << ", \"grid_cells\": " << r.metrics.grid_cells
+        << ", \"counters\": ";
+    if (counted(r.metrics))
+    {
+      out << "{";
+      for (int p = 0; p < ePhaseCount; ++p)
+      {
+        out << (p > 0 ? ", " : "") << jsonString(benchmarkPhaseName(p)) << ": {";
+        for (int e = 0; e < ePerfEventCount; ++e)
+        {
+          out << (e > 0 ? ", " : "") << jsonString(perfEventName(e)) << ": ";
+          if (r.metrics.counts[p].values[e] < 0)
+          {
+            out << "null";
+          }
+          else
+          {
+            out << r.metrics.counts[p].values[e];
+          }
+        }
+        out << "}";
+      }
+      out << "}";
+    }
+    else
+    {
+      out << "null";
+    }
+    out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  out << "]\n";
+}
+
+void writeParetoSummary(std::ostream& out, std::vector<BenchmarkResult> const& results)
+{
+  std::map<std::string, std::vector<BenchmarkResult const*> > fronts;
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    fronts[results[i].map];
+    if (results[i].pareto)
+    {
+      fronts[results[i].map].push_back(&results[i]);
+    }
+  }
+  for (std::map<std::string, std::vector<BenchmarkResult const*> >::const_iterator it = fronts.begin();
+       it != fronts.end(); ++it)
+  {
+    out << it->first << ": " << it->second.size() << " Pareto-optimal configuration(s)\n";
+    for (size_t i = 0; i < it->second.size(); ++i)
+    {
+      BenchmarkMetrics const& m = it->second[i]->metrics;
+      out << "  " << it->second[i]->config.name << ": " << m.wall_time_s * 1000 << " ms, " << m.peak_memory_kb
+          << " kB, " << m.path_length_m << " m, " << m.turns << " turns, " << m.waypoint_count << " waypoints, "
+          << m.multiple_pass_counter << " multiple passes, " << m.accessible_counter << " accessible\n";
+    }
+  }
+}
+
+void writeCounterSummary(std::ostream& out, std::vector<BenchmarkResult> const& results)
+{
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    BenchmarkMetrics const& m = results[i].metrics;
+    if (!m.success || !counted(m))
+    {
+      continue;
+    }
+    out << results[i].map << " " << results[i].config.name << ": " << m.wall_time_s * 1000 << " ms ("
+        << m.parse_time_s * 1000 << " ms parse), " << m.grid_cells << " cells, per cell:\n";
+    for (int p = 0; p < ePhaseCount; ++p)
+    {
+      PerfCounts const& c = m.counts[p];
+      out << "  " << benchmarkPhaseName(p) << ":";
+      for (int e = 0; e < ePerfEventCount; ++e)
+      {
+        out << (e > 0 ? ", " : " ") << perCell(c.values[e], m.grid_cells) << " " << perfEventName(e);
+      }
+      if (c.values[ePerfCycles] > 0 && c.values[ePerfInstructions] >= 0)
+      {
+        out << ", IPC " << static_cast<double>(c.values[ePerfInstructions]) / c.values[ePerfCycles];
+      }
+      out << "\n";
+    }
+  }
+}
+}  // namespace full_coverage_path_planner
@@ -0,0 +1,88 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * Offline builder of a planning atlas for a fixed site, see planning_atlas.h.
+ *
+ * Parameters (private):
+ * - atlas_file: output file
+ * - docks: list of [x, y] positions of the docking stations
+ * - zones: list of zones, each a list of at least 3 [x, y] points
+ * - planner_name: namespace of the SpiralSTC parameters (robot_radius, tool_radius, ...), default SpiralSTC
+ * - map_file: map_server yaml file of the site, read straight into tiles. Default: the planner's map_file
+ * Without a map file, the map is requested from the static_map service, like the planner does.
+ */
+#include <string>
+#include <vector>
+
+#include <ros/ros.h>
+#include <nav_msgs/GetMap.h>
+
+#include "full_coverage_path_planner/spiral_stc.h"
+
+using full_coverage_path_planner::SpiralSTC;
+
+int main(int argc, char** argv)
+{
+  ros::init(argc, argv, "build_atlas");
+  ros::NodeHandle nh, private_nh("~");
+
+  std::string atlas_file, planner_name;
+  if (!private_nh.getParam("atlas_file", atlas_file))
+  {
+    ROS_ERROR("Parameter atlas_file is required");
+    return 1;
+  }
+  private_nh.param<std::string>("planner_name", planner_name, "SpiralSTC");
+
+  std::vector<fPoint_t> docks;
+  XmlRpc::XmlRpcValue docks_param;
+  if (!private_nh.getParam("docks", docks_param) || !SpiralSTC::parsePoints(docks_param, docks) || docks.empty())
+  {
+    ROS_ERROR("Parameter docks must be a list of [x, y] points");
+    return 1;
+  }
+
+  std::vector<std::vector<fPoint_t> > zones;
+  XmlRpc::XmlRpcValue zones_param;
+  if (!private_nh.getParam("zones", zones_param) || zones_param.getType() != XmlRpc::XmlRpcValue::TypeArray)
+  {
+    ROS_ERROR("Parameter zones must be a list of polygons");
+    return 1;
+  }
+  for (int i = 0; i < zones_param.size(); ++i)
+  {
+    std::vector<fPoint_t> zone;
+    if (!SpiralSTC::parsePolygon(zones_param[i], zone))
+    {
+      ROS_ERROR("Zone %d must be a list of at least 3 [x, y] points", i);
+      return 1;
+    }
+    zones.push_back(zone);
+  }
+
+  // Same parameters as the planner that will use the atlas, so the tiles line up
+  SpiralSTC planner;
+  static_cast<nav_core::BaseGlobalPlanner&>(planner).initialize(planner_name, NULL);
+
+  std::string map_file;
+  if (!private_nh.getParam("map_file", map_file))
+  {
+    private_nh.param<std::string>(planner_name + "/map_file", map_file, "");
+  }
+  if (!map_file.empty())
+  {
+    return planner.buildAtlas(map_file, zones, docks, atlas_file) ? 0 : 1;
+  }
+
+  nav_msgs::GetMap grid_req_srv;
+  ros::service::waitForService("static_map");
+  if (!ros::service::call("static_map", grid_req_srv))
+  {
+    ROS_ERROR("Could not retrieve grid from map_server");
+    return 1;
+  }
+
+  return planner.buildAtlas(grid_req_srv.response.map, zones, docks, atlas_file) ? 0 : 1;
+}
@@ -2,7 +2,7 @@
 // Copyright [2020] Nobleo Technology"  [legal/copyright]
 //
 #include <algorithm>
-#include <iostream>
+#include <cmath>
 #include <limits>
 #include <list>
 #include <vector>
@@ -58,6 +58,36 @@ bool sort_gridNodePath_heuristic_desc(const std::vector<gridNode_t> &first, cons
   return (first.back().he > second.back().he);
 }
 
+namespace
+{
+/**
+ * Same order as sort_gridNodePath_heuristic_desc, for paths given as the index of their last node
+ */
+struct CompareLastNodeHeuristicDesc
+{
+  explicit CompareLastNodeHeuristicDesc(std::vector<gridNode_t> const &nodes) : nodes_(nodes)
+  {
+  }
+
+  bool operator()(int first, int second) const
+  {
+    return nodes_[first].he > nodes_[second].he;
+  }
+
+  std::vector<gridNode_t> const &nodes_;
+};
+}  // namespace
+
+int distanceToClosestPoint(Point_t poi, std::vector<Point_t> const &goals)
+{
+  int min_dist = INT_MAX;
+  for (std::vector<Point_t>::const_iterator it = goals.begin(); it != goals.end(); ++it)
+  {
+    min_dist = std::min(min_dist, distanceSquared(*it, poi));
+  }
+  return min_dist;
+}
+
 bool a_star_to_open_space(std::vector<std::vector<bool> > const &grid, gridNode_t init, int cost,
                           std::vector<std::vector<bool> > &visited, std::list<Point_t> const &open_space,
                           std::list<gridNode_t> &pathNodes)
@@ -68,18 +98,11 @@ bool a_star_to_open_space(std::vector<std::vector<bool> > const &grid, gridNode_
   // All nodes in the closest list are currently still open
 
   closed[init.pos.y][init.pos.x] = eNodeVisited;  // Of course we have visited the current/initial location
-#ifdef DEBUG_PLOT
-  std::cout << "A*: Marked init " << init << " as eNodeVisited (true)" << std::endl;
-  printGrid(closed);
-#endif
 
   std::vector<std::vector<gridNode_t> > open1(1, std::vector<gridNode_t>(1, init));  // open1 is a *vector* of paths
 
   while (true)
   {
-#ifdef DEBUG_PLOT
-    std::cout << "A*: open1.size() = " << open1.size() << std::endl;
-#endif
     if (open1.size() == 0)  // If there are no open paths, there's no place to go and we must resign
     {
       // Empty end_node list and add init as only element
@@ -94,10 +117,6 @@ bool a_star_to_open_space(std::vector<std::vector<bool> > const &grid, gridNode_
 
       std::vector<gridNode_t> nn = open1.back();  // Get the *path* with the lowest heuristic cost
       open1.pop_back();  // The last element is no longer open because we use it here, so remove from open list
-#ifdef DEBUG_PLOT
-      std::cout << "A*: Check out path from" << nn.front().pos << " to " << nn.back().pos
-      << " of length " << nn.size() << std::endl;
-#endif
 
       // Does the path nn end in open space?
       if (visited[nn.back().pos.y][nn.back().pos.x] == eNodeOpen)
@@ -141,10 +160,6 @@ bool a_star_to_open_space(std::vector<std::vector<bool> > const &grid, gridNode_
             nn.back().pos.y + dy,
           };
 
-#ifdef DEBUG_PLOT
-          std::cout << "A*: Look around " << i << " at p2=(" << p2 << std::endl;
-#endif
-
           if (p2.x >= 0 && p2.x < nCols && p2.y >= 0 && p2.y < nRows)  // Bounds check, do not sep out of map
           {
             // If the new node (a neighbor of the end of the path nn) is open, append it to newPath ( = nn)
@@ -153,9 +168,6 @@ bool a_star_to_open_space(std::vector<std::vector<bool> > const &grid, gridNode_
             // modified here, and then added back (if the condition above and below holds)
             if (closed[p2.y][p2.x] == eNodeOpen && grid[p2.y][p2.x] == eNodeOpen)
             {
-#ifdef DEBUG_PLOT
-              std::cout << "A*: p2=" << p2 << " is OPEN" << std::endl;
-#endif
               std::vector<gridNode_t> newPath = nn;
               // # heuristic  has to be designed to prefer a CCW turn
               Point_t new_point = { p2.x, p2.y };
@@ -169,28 +181,9 @@ bool a_star_to_open_space(std::vector<std::vector<bool> > const &grid, gridNode_
               newPath.push_back(new_node);
               closed[new_node.pos.y][new_node.pos.x] = eNodeVisited;  // New node is now used in a path and thus visited
 
-#ifdef DEBUG_PLOT
-              std::cout << "A*: Marked new_node " << new_node << " as eNodeVisited (true)" << std::endl;
-              std::cout << "A*: Add path from " << newPath.front().pos << " to " << newPath.back().pos
-              << " of length " << newPath.size() << " to open1" << std::endl;
-#endif
               open1.push_back(newPath);
             }
-#ifdef DEBUG_PLOT
-            else
-            {
-              std::cout << "A*: p2=" << p2 << " is not open: "
-                        "closed[" << p2.y << "][" << p2.x << "]=" << closed[p2.y][p2.x] << ", "
-                        "grid["  << p2.y << "][" << p2.x << "]=" << grid[p2.y][p2.x] << std::endl;
-            }
-#endif
-          }
-#ifdef DEBUG_PLOT
-          else
-          {
-            std::cout << "A*: p2=(" << p2.x << ", " << p2.y << ") is out of bounds" << std::endl;
           }
-#endif
           // Cycle around to next neighbor, CCW
           dx_prev = dx;
           dx = dy;
@@ -201,111 +194,186 @@ bool a_star_to_open_space(std::vector<std::vector<bool> > const &grid, gridNode_
   }
 }
 
-void printGrid(std::vector<std::vector<bool> > const& grid, std::vector<std::vector<bool> > const& visited,
-               std::list<Point_t> const& path)
+bool a_star_to_open_space(std::vector<std::vector<bool> > const &grid, gridNode_t init, int cost,
+                          std::vector<std::vector<bool> > const &visited, std::vector<Point_t> const &open_space,
+                          AStarWorkspace &workspace, std::vector<gridNode_t> &pathNodes)
 {
-  for (uint iy = grid.size() - 1; iy >= 0; --iy)
+  int dx, dy, dx_prev, nRows = grid.size(), nCols = grid[0].size();
+  size_t nCells = static_cast<size_t>(nRows) * nCols;
+
+  // A cell is closed when it holds the current generation, so the closed cells do not have to be cleared per search.
+  // A path has at most one node per cell, so the buffers never have to grow during a search
+  if (workspace.closed.size() != nCells || ++workspace.generation == 0)
   {
-    for (uint ix = 0; ix < grid[0].size(); ++ix)
+    workspace.closed.assign(nCells, 0);
+    workspace.generation = 1;
+    workspace.nodes.reserve(nCells + 1);
+    workspace.parents.reserve(nCells + 1);
+    workspace.open.reserve(nCells + 1);
+    workspace.trace.reserve(nCells + 1);
+  }
+  std::vector<gridNode_t> &nodes = workspace.nodes;
+  std::vector<int> &parents = workspace.parents;
+  std::vector<int> &open = workspace.open;
+  nodes.assign(1, init);
+  parents.assign(1, -1);
+  open.assign(1, 0);
+  workspace.closed[init.pos.y * nCols + init.pos.x] = workspace.generation;
+
+  while (!open.empty())
+  {
+    // Same order of the open paths as the copying version, so the same path is found
+    std::sort(open.begin(), open.end(), CompareLastNodeHeuristicDesc(nodes));
+    int last = open.back();
+    open.pop_back();
+    gridNode_t const end = nodes[last];
+    ++workspace.expansions;
+
+    if (visited[end.pos.y][end.pos.x] == eNodeOpen)
     {
-      if (visited[iy][ix])
+      workspace.trace.clear();
+      for (int node = last; node >= 0; node = parents[node])
       {
-        if (ix == path.front().x && iy == path.front().y)
-        {
-          std::cout << "\033[1;32m▓\033[0m";  // Show starting position in green color
-        }
-        else if (ix == path.back().x && iy == path.back().y)
-        {
-          std::cout << "\033[1;31m▓\033[0m";  // Show stopping position in red color
-        }
-        else if (visited[iy][ix] && grid[iy][ix])
-        {
-          std::cout << "\033[1;33m▓\033[0m";  // Show walls in yellow color
-        }
-        else
-        {
-          std::cout << "\033[1;36m▓\033[0m";
-        }
+        workspace.trace.push_back(nodes[node]);
       }
-      else
+      pathNodes.insert(pathNodes.end(), workspace.trace.rbegin(), workspace.trace.rend());
+      return false;  // We do not resign, we found a path
+    }
+
+    if (parents[last] >= 0)
+    {
+      // Start looking around counter-clockwise of the direction the path arrived in
+      dx = end.pos.x - nodes[parents[last]].pos.x;
+      dy = end.pos.y - nodes[parents[last]].pos.y;
+      dx_prev = dx;
+      dx = -dy;
+      dy = dx_prev;
+    }
+    else
+    {
+      dx = 0;
+      dy = 1;
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+      Point_t p2 = { end.pos.x + dx, end.pos.y + dy };
+      if (p2.x >= 0 && p2.x < nCols && p2.y >= 0 && p2.y < nRows &&
+          workspace.closed[p2.y * nCols + p2.x] != workspace.generation && grid[p2.y][p2.x] == eNodeOpen)
       {
-        std::cout << "\033[1;37m▓\033[0m";
+        gridNode_t new_node =
+        {
+          p2,                                                          // Point: x,y
+          cost + end.cost,                                             // Cost
+          cost + end.cost + distanceToClosestPoint(p2, open_space) + i,  // Heuristic (+i so CCW turns are cheaper)
+        };
+        workspace.closed[p2.y * nCols + p2.x] = workspace.generation;
+        nodes.push_back(new_node);
+        parents.push_back(last);
+        open.push_back(nodes.size() - 1);
       }
+      // Cycle around to next neighbor, CCW
+      dx_prev = dx;
+      dx = dy;
+      dy = -dx_prev;
     }
-    std::cout << "\n";
   }
+
+  // No open paths left, there's no place to go and we must resign
+  if (!pathNodes.empty())
+  {
+    pathNodes.erase(pathNodes.begin(), pathNodes.end() - 1);
+  }
+  pathNodes.push_back(init);
+  return true;
 }
 
-void printGrid(std::vector<std::vector<bool> > const& grid, std::vector<std::vector<bool> > const& visited,
-               std::list<gridNode_t> const& path, gridNode_t start, gridNode_t end)
+std::list<Point_t> map_2_goals(std::vector<std::vector<bool> > const& grid, bool value_to_search)
 {
-  for (uint iy = grid.size() - 1; iy >= 0; --iy)
+  std::list<Point_t> goals;
+  int ix, iy;
+  uint nRows = grid.size();
+  uint nCols = grid[0].size();
+  for (iy = 0; iy < nRows; ++(iy))
   {
-    for (uint ix = 0; ix < grid[0].size(); ++ix)
+    for (ix = 0; ix < nCols; ++(ix))
     {
-      if (visited[iy][ix])
-      {
-        if (ix == start.pos.x && iy == start.pos.y)
-        {
-          std::cout << "\033[1;32m▓\033[0m";  // Show starting position in green color
-        }
-        else if (ix == end.pos.x && iy == end.pos.y)
-        {
-          std::cout << "\033[1;31m▓\033[0m";  // Show stopping position in red color
-        }
-        else if (visited[iy][ix] && grid[iy][ix])
-        {
-          std::cout << "\033[1;33m▓\033[0m";  // Show walls in yellow color
-        }
-        else
-        {
-          std::cout << "\033[1;36m▓\033[0m";
-        }
-      }
-      else
+      if (grid[iy][ix] == value_to_search)
       {
-        std::cout << "\033[1;37m▓\033[0m";
+        Point_t p = { ix, iy };  // x, y
+        goals.push_back(p);
       }
     }
-    std::cout << "\n";
   }
+  return goals;
 }
 
-void printGrid(std::vector<std::vector<bool> > const& grid)
+void map_2_goals(std::vector<std::vector<bool> > const& grid, bool value_to_search, std::vector<Point_t>& goals)
 {
-  for (uint iy = grid.size() - 1; iy >= 0; --iy)
+  int nRows = grid.size();
+  int nCols = grid[0].size();
+  goals.clear();
+  goals.reserve(static_cast<size_t>(nRows) * nCols);
+  for (int iy = 0; iy < nRows; ++iy)
   {
-    for (uint ix = 0; ix < grid[0].size(); ++ix)
+    for (int ix = 0; ix < nCols; ++ix)
     {
-      if (grid[iy][ix])
-      {
-        std::cout << "\033[1;36m▓\033[0m";
-      }
-      else
+      if (grid[iy][ix] == value_to_search)
       {
-        std::cout << "\033[1;37m▓\033[0m";
+        Point_t p = { ix, iy };  // x, y
+        goals.push_back(p);
       }
     }
-    std::cout << "\n";
   }
 }
 
-std::list<Point_t> map_2_goals(std::vector<std::vector<bool> > const& grid, bool value_to_search)
+void maskOutsidePolygon(std::vector<std::vector<bool> >& grid, std::vector<fPoint_t> const& polygon)
 {
-  std::list<Point_t> goals;
-  int ix, iy;
   uint nRows = grid.size();
-  uint nCols = grid[0].size();
-  for (iy = 0; iy < nRows; ++(iy))
+  if (polygon.size() < 3)
   {
-    for (ix = 0; ix < nCols; ++(ix))
+    // A polygon needs at least 3 vertices, there is nothing inside it
+    for (uint iy = 0; iy < nRows; ++iy)
     {
-      if (grid[iy][ix] == value_to_search)
+      grid[iy].assign(grid[iy].size(), true);
+    }
+    return;
+  }
+
+  // Scanline fill: per row, intersect the horizontal line through the cell centers with all polygon edges.
+  // Cells between the 1st and 2nd crossing, 3rd and 4th etc. are inside the polygon (even-odd rule)
+  std::vector<float> crossings;
+  for (uint iy = 0; iy < nRows; ++iy)
+  {
+    float y = iy + 0.5f;
+    crossings.clear();
+    for (uint i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++)
+    {
+      fPoint_t const& a = polygon[i];
+      fPoint_t const& b = polygon[j];
+      if ((a.y <= y) != (b.y <= y))
       {
-        Point_t p = { ix, iy };  // x, y
-        goals.push_back(p);
+        crossings.push_back(a.x + (y - a.y) / (b.y - a.y) * (b.x - a.x));
+      }
+    }
+    std::sort(crossings.begin(), crossings.end());
+
+    int nCols = grid[iy].size();
+    int ix = 0;
+    for (uint k = 0; k + 1 < crossings.size(); k += 2)
+    {
+      // Cells with their center (ix + 0.5) in [crossings[k], crossings[k + 1]) are inside
+      int first = std::max(0, std::min(nCols, static_cast<int>(std::ceil(crossings[k] - 0.5f))));
+      int last = std::max(0, std::min(nCols, static_cast<int>(std::ceil(crossings[k + 1] - 0.5f))));
+      for (; ix < first; ++ix)
+      {
+        grid[iy][ix] = true;
       }
+      ix = std::max(ix, last);
+    }
+    for (; ix < nCols; ++ix)
+    {
+      grid[iy][ix] = true;
     }
   }
-  return goals;
 }
@@ -0,0 +1,198 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <algorithm>
+#include <vector>
+
+#include <full_coverage_path_planner/contour_coverage.h>
+
+namespace full_coverage_path_planner
+{
+namespace
+{
+// 4-connected directions in counter-clockwise order: +x, +y, -x, -y
+const int kDx[4] = { 1, 0, -1, 0 };
+const int kDy[4] = { 0, 1, 0, -1 };
+
+/**
+ * Layer of a tile, 0 for blocked tiles and tiles outside of the grid
+ */
+int layerAt(std::vector<int> const& layers, int nCols, int nRows, int x, int y)
+{
+  return x >= 0 && x < nCols && y >= 0 && y < nRows ? layers[y * nCols + x] : 0;
+}
+
+/**
+ * Direction of the step from a to its neighbour b
+ */
+int directionOf(Point_t a, Point_t b)
+{
+  return b.x > a.x ? 0 : b.y > a.y ? 1 : b.x < a.x ? 2 : 3;
+}
+
+/**
+ * Choose the next tile of the walk from p, arrived there in direction heading (-1 at the start).
+ * Stay on the layer of p if possible, else go to an outer layer that was missed and only then inwards. Among those,
+ * prefer keeping the outer layer on the right (a counter-clockwise loop along the obstacles) and going straight.
+ * @return direction of the next tile, -1 when all neighbours are covered
+ */
+int nextDirection(ContourWorkspace const& workspace, int nCols, int nRows, Point_t p, int heading)
+{
+  int layer = workspace.layers[p.y * nCols + p.x];
+  int best = -1, best_score = 0;
+  for (int d = 0; d < 4; ++d)
+  {
+    int x = p.x + kDx[d], y = p.y + kDy[d];
+    if (x < 0 || x >= nCols || y < 0 || y >= nRows || workspace.visited[y * nCols + x])
+    {
+      continue;
+    }
+    int next_layer = workspace.layers[y * nCols + x];
+    int layer_score = next_layer == layer ? 0 : next_layer < layer ? 1 : 2;
+    int right = (d + 3) % 4;
+    bool wall_on_right = layerAt(workspace.layers, nCols, nRows, x + kDx[right], y + kDy[right]) < next_layer;
+    int score = layer_score * 4 + (wall_on_right ? 0 : 2) + (d == heading ? 0 : 1);
+    if (best < 0 || score < best_score)
+    {
+      best = d;
+      best_score = score;
+    }
+  }
+  return best;
+}
+}  // namespace
+
+void contourLayers(std::vector<std::vector<bool> > const& grid, std::vector<int>& layers)
+{
+  int nRows = grid.size(), nCols = grid[0].size();
+  layers.resize(static_cast<size_t>(nRows) * nCols);
+
+  // Forward pass over the neighbours above and to the left, backward pass over those below and to the right
+  for (int y = 0; y < nRows; ++y)
+  {
+    for (int x = 0; x < nCols; ++x)
+    {
+      int& d = layers[y * nCols + x];
+      if (grid[y][x] == eNodeVisited)
+      {
+        d = 0;
+        continue;
+      }
+      int above = std::min(layerAt(layers, nCols, nRows, x - 1, y), layerAt(layers, nCols, nRows, x - 1, y - 1));
+      above = std::min(above, std::min(layerAt(layers, nCols, nRows, x, y - 1),
+                                       layerAt(layers, nCols, nRows, x + 1, y - 1)));
+      d = above + 1;
+    }
+  }
+  for (int y = nRows - 1; y >= 0; --y)
+  {
+    for (int x = nCols - 1; x >= 0; --x)
+    {
+      int& d = layers[y * nCols + x];
+      if (d == 0)
+      {
+        continue;
+      }
+      int below = std::min(layerAt(layers, nCols, nRows, x + 1, y), layerAt(layers, nCols, nRows, x + 1, y + 1));
+      below = std::min(below, std::min(layerAt(layers, nCols, nRows, x, y + 1),
+                                       layerAt(layers, nCols, nRows, x - 1, y + 1)));
+      d = std::min(d, below + 1);
+    }
+  }
+}
+
+void contourCoverage(std::vector<std::vector<bool> > const& grid, Point_t const& init, ContourWorkspace& workspace,
+                     std::vector<Point_t>& fullPath, int& multiple_pass_counter, int& visited_counter)
+{
+  int nRows = grid.size(), nCols = grid[0].size();
+  size_t nCells = static_cast<size_t>(nRows) * nCols;
+  contourLayers(grid, workspace.layers);
+
+  std::vector<uint8_t>& visited = workspace.visited;
+  visited.resize(nCells);
+  int remaining = 0;
+  for (size_t i = 0; i < nCells; ++i)
+  {
+    visited[i] = workspace.layers[i] == 0;
+    remaining += !visited[i];
+  }
+  workspace.parents.assign(nCells, -1);
+  workspace.queue.reserve(nCells);
+  fullPath.clear();
+  fullPath.reserve(nCells);
+  multiple_pass_counter = 0;
+
+  Point_t p = init;
+  int heading = -1;
+  fullPath.push_back(p);
+  if (!visited[p.y * nCols + p.x])
+  {
+    visited[p.y * nCols + p.x] = 1;
+    --remaining;
+  }
+
+  while (remaining > 0)
+  {
+    int d = nextDirection(workspace, nCols, nRows, p, heading);
+    if (d >= 0)
+    {
+      p.x += kDx[d];
+      p.y += kDy[d];
+      heading = d;
+      visited[p.y * nCols + p.x] = 1;
+      --remaining;
+      fullPath.push_back(p);
+      continue;
+    }
+
+    // Stuck: connect to the closest tile that is not covered yet, breadth-first over the free tiles
+    std::vector<int>& queue = workspace.queue;
+    std::vector<int>& parents = workspace.parents;
+    queue.assign(1, p.y * nCols + p.x);
+    parents[queue[0]] = queue[0];
+    int target = -1;
+    for (size_t head = 0; head < queue.size() && target < 0; ++head)
+    {
+      int cell = queue[head], cx = cell % nCols, cy = cell / nCols;
+      for (int n = 0; n < 4; ++n)
+      {
+        int x = cx + kDx[n], y = cy + kDy[n], next = y * nCols + x;
+        if (x < 0 || x >= nCols || y < 0 || y >= nRows || workspace.layers[next] == 0 || parents[next] >= 0)
+        {
+          continue;
+        }
+        parents[next] = cell;
+        queue.push_back(next);
+        if (!visited[next])
+        {
+          target = next;
+          break;
+        }
+      }
+    }
+
+    // Walk the connector, the tiles before the target are covered already
+    workspace.connector.clear();
+    for (int cell = target; target >= 0 && cell != queue[0]; cell = parents[cell])
+    {
+      Point_t c = { cell % nCols, cell / nCols };
+      workspace.connector.push_back(c);
+    }
+    for (size_t i = 0; i < queue.size(); ++i)
+    {
+      parents[queue[i]] = -1;  // Only reset what this search touched
+    }
+    if (target < 0)
+    {
+      break;  // The rest can not be reached
+    }
+    multiple_pass_counter += workspace.connector.size() - 1;
+    fullPath.insert(fullPath.end(), workspace.connector.rbegin(), workspace.connector.rend());
+    heading = directionOf(fullPath[fullPath.size() - 2], fullPath.back());
+    p = fullPath.back();
+    visited[target] = 1;
+    --remaining;
+  }
+  visited_counter = fullPath.size();
+}
+}  // namespace full_coverage_path_planner
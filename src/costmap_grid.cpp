@@ -0,0 +1,69 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "full_coverage_path_planner/costmap_grid.h"
+
+namespace full_coverage_path_planner
+{
+void costsToOccupancy(unsigned char const* costs, size_t cells, unsigned char lethal_cost,
+                      std::vector<int8_t>& occupancy)
+{
+  occupancy.resize(cells);
+  for (size_t i = 0; i < cells; ++i)
+  {
+    occupancy[i] = costs[i] == lethal_cost ? 100 : 0;
+  }
+}
+
+bool occupancyToTiles(int8_t const* data, int width, int height, double resolution, double origin_x, double origin_y,
+                      double robot_radius, double tool_radius, FootprintModel model, TileGeometry& geometry,
+                      std::vector<std::vector<bool> >& grid)
+{
+  if (width <= 0 || height <= 0 || resolution <= 0.0)
+  {
+    return false;
+  }
+  // The radii are doubled like in the ROS 1 plugin: a tile is as wide as the tool
+  int node_size = std::max(static_cast<int>(std::floor(2 * tool_radius / resolution)), 1);
+  int robot_node_size = std::max(static_cast<int>(std::floor(2 * robot_radius / resolution)), 1);
+  geometry.tile_size = node_size * resolution;
+  geometry.origin_x = origin_x;
+  geometry.origin_y = origin_y;
+  geometry.columns = tileCount(width, node_size);
+  geometry.rows = tileCount(height, node_size);
+
+  TileFootprint footprint;
+  footprint.model = model;
+  footprint.node_size = node_size;
+  footprint.footprint_size = robot_node_size;
+  footprint.radius = robot_radius / resolution;
+
+  grid.resize(geometry.rows);
+  for (int y = 0; y < geometry.rows; ++y)
+  {
+    grid[y].assign(geometry.columns, false);
+  }
+  inflateTiles(data, width, height, footprint, 0, 0, geometry.columns, geometry.rows, grid, 0, 0);
+  return true;
+}
+
+Point_t worldToTile(TileGeometry const& geometry, double x, double y)
+{
+  Point_t tile;
+  tile.x = std::min(std::max(static_cast<int>(std::floor((x - geometry.origin_x) / geometry.tile_size)), 0),
+                    geometry.columns - 1);
+  tile.y = std::min(std::max(static_cast<int>(std::floor((y - geometry.origin_y) / geometry.tile_size)), 0),
+                    geometry.rows - 1);
+  return tile;
+}
+
+void tileToWorld(TileGeometry const& geometry, Point_t const& tile, double& x, double& y)
+{
+  x = geometry.origin_x + (tile.x + 0.5) * geometry.tile_size;
+  y = geometry.origin_y + (tile.y + 0.5) * geometry.tile_size;
+}
+}  // namespace full_coverage_path_planner
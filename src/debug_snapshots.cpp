@@ -0,0 +1,327 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <errno.h>
+#include <png.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <full_coverage_path_planner/debug_snapshots.h>
+
+namespace full_coverage_path_planner
+{
+namespace
+{
+const char* const kStageNames[] = { "start", "spiral", "escape" };
+
+void setTile(std::vector<uint8_t>& packed, size_t i, uint8_t tile)
+{
+  packed[i / 4] |= tile << (2 * (i % 4));
+}
+
+uint8_t getTile(std::vector<uint8_t> const& packed, size_t i)
+{
+  return (packed[i / 4] >> (2 * (i % 4))) & 3;
+}
+}  // namespace
+
+bool readSnapshotLog(std::string const& file, std::vector<DebugSnapshot>& snapshots)
+{
+  std::ifstream in(file.c_str(), std::ios::binary);
+  if (!in)
+  {
+    return false;
+  }
+  snapshots.clear();
+  std::vector<uint8_t> packed;
+  std::vector<int32_t> points;
+  DebugSnapshot snapshot;
+  while (in.read(reinterpret_cast<char*>(&snapshot.header), sizeof(snapshot.header)))
+  {
+    SnapshotRecordHeader const& header = snapshot.header;
+    if (header.magic != kSnapshotMagic || header.version != kSnapshotVersion)
+    {
+      return false;
+    }
+    size_t tiles = static_cast<size_t>(header.width) * header.height;
+    packed.resize((tiles + 3) / 4);
+    points.resize(2 * header.segment_count);
+    if (!in.read(reinterpret_cast<char*>(packed.data()), packed.size()) ||
+        !in.read(reinterpret_cast<char*>(points.data()), points.size() * sizeof(int32_t)))
+    {
+      return false;
+    }
+    snapshot.tiles.resize(tiles);
+    for (size_t i = 0; i < tiles; ++i)
+    {
+      snapshot.tiles[i] = getTile(packed, i);
+    }
+    snapshot.segment.resize(header.segment_count);
+    for (size_t i = 0; i < header.segment_count; ++i)
+    {
+      snapshot.segment[i].x = points[2 * i];
+      snapshot.segment[i].y = points[2 * i + 1];
+    }
+    snapshots.push_back(snapshot);
+  }
+  return in.eof();
+}
+
+AsyncSnapshotWriter::AsyncSnapshotWriter()
+  : format_(ePng), enabled_(false), plan_(0), sequence_(0), writing_(false), stop_(false), dropped_(0)
+{
+}
+
+AsyncSnapshotWriter::~AsyncSnapshotWriter()
+{
+  close();
+}
+
+bool AsyncSnapshotWriter::open(std::string const& directory, Format format, int buffers)
+{
+  close();
+  if (buffers <= 0 || (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST))
+  {
+    return false;
+  }
+  directory_ = directory;
+  format_ = format;
+  plan_ = 0;
+  sequence_ = 0;
+  dropped_ = 0;
+  stop_ = false;
+  buffers_.resize(buffers);
+  free_.clear();
+  for (size_t i = 0; i < buffers_.size(); ++i)
+  {
+    free_.push_back(&buffers_[i]);
+  }
+  thread_ = std::thread(&AsyncSnapshotWriter::run, this);
+  return true;
+}
+
+void AsyncSnapshotWriter::close()
+{
+  if (!thread_.joinable())
+  {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_one();
+  thread_.join();
+}
+
+void AsyncSnapshotWriter::flush()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!queue_.empty() || writing_)
+  {
+    idle_.wait(lock);
+  }
+}
+
+uint64_t AsyncSnapshotWriter::dropped() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return dropped_;
+}
+
+void AsyncSnapshotWriter::beginPlan()
+{
+  ++plan_;
+  sequence_ = 0;
+}
+
+void AsyncSnapshotWriter::capture(SnapshotStage stage, std::vector<std::vector<bool> > const& grid,
+                                  std::vector<std::vector<bool> > const& visited,
+                                  std::vector<gridNode_t> const& segment, size_t goals)
+{
+  int nRows = grid.size(), nCols = grid[0].size();
+  DebugSnapshot* snapshot = acquire(stage, nCols, nRows, segment, goals);
+  if (!snapshot)
+  {
+    return;
+  }
+  uint8_t* tile = snapshot->tiles.data();
+  for (int y = 0; y < nRows; ++y)
+  {
+    for (int x = 0; x < nCols; ++x)
+    {
+      *tile++ = grid[y][x] ? eSnapshotBlocked : visited[y][x] ? eSnapshotVisited : eSnapshotFree;
+    }
+  }
+  enqueue(snapshot);
+}
+
+void AsyncSnapshotWriter::capture(SnapshotStage stage, IntervalGrid const& grid, std::vector<bool> const& visited,
+                                  std::vector<gridNode_t> const& segment, size_t goals)
+{
+  DebugSnapshot* snapshot = acquire(stage, grid.width(), grid.height(), segment, goals);
+  if (!snapshot)
+  {
+    return;
+  }
+  std::fill(snapshot->tiles.begin(), snapshot->tiles.end(), static_cast<uint8_t>(eSnapshotBlocked));
+  for (int y = 0; y < grid.height(); ++y)
+  {
+    uint8_t* row = snapshot->tiles.data() + static_cast<size_t>(y) * grid.width();
+    for (FreeInterval const* it = grid.rowBegin(y); it != grid.rowEnd(y); ++it)
+    {
+      for (int x = it->start; x < it->end; ++x)
+      {
+        row[x] = visited[it->offset + x - it->start] ? eSnapshotVisited : eSnapshotFree;
+      }
+    }
+  }
+  enqueue(snapshot);
+}
+
+DebugSnapshot* AsyncSnapshotWriter::acquire(SnapshotStage stage, int width, int height,
+                                            std::vector<gridNode_t> const& segment, size_t goals)
+{
+  DebugSnapshot* snapshot;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_.empty())
+    {
+      ++dropped_;
+      ++sequence_;  // Keep the numbers of the other snapshots, a gap shows a dropped one
+      return NULL;
+    }
+    snapshot = free_.back();
+    free_.pop_back();
+  }
+  SnapshotRecordHeader& header = snapshot->header;
+  header.magic = kSnapshotMagic;
+  header.version = kSnapshotVersion;
+  header.plan = plan_;
+  header.sequence = sequence_++;
+  header.stage = stage;
+  header.width = width;
+  header.height = height;
+  header.goals = goals;
+  header.segment_count = segment.size();
+  snapshot->tiles.resize(static_cast<size_t>(width) * height);
+  snapshot->segment.resize(segment.size());
+  for (size_t i = 0; i < segment.size(); ++i)
+  {
+    snapshot->segment[i] = segment[i].pos;
+  }
+  return snapshot;
+}
+
+void AsyncSnapshotWriter::enqueue(DebugSnapshot* snapshot)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(snapshot);
+  }
+  wake_.notify_one();
+}
+
+void AsyncSnapshotWriter::run()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true)
+  {
+    while (queue_.empty() && !stop_)
+    {
+      wake_.wait(lock);
+    }
+    if (queue_.empty())
+    {
+      break;  // Stopped, and everything is written
+    }
+    DebugSnapshot* snapshot = queue_.front();
+    queue_.pop_front();
+    writing_ = true;
+    lock.unlock();
+    if (!write(*snapshot))
+    {
+      fprintf(stderr, "Could not write debug snapshot to %s: %s\n", directory_.c_str(), strerror(errno));
+    }
+    lock.lock();
+    writing_ = false;
+    free_.push_back(snapshot);
+    if (queue_.empty())
+    {
+      idle_.notify_all();
+    }
+  }
+  idle_.notify_all();
+}
+
+bool AsyncSnapshotWriter::write(DebugSnapshot const& snapshot)
+{
+  SnapshotRecordHeader const& header = snapshot.header;
+  size_t tiles = snapshot.tiles.size();
+  if (format_ == eLog)
+  {
+    std::vector<uint8_t> packed((tiles + 3) / 4, 0);
+    for (size_t i = 0; i < tiles; ++i)
+    {
+      setTile(packed, i, snapshot.tiles[i]);
+    }
+    std::vector<int32_t> points(2 * snapshot.segment.size());
+    for (size_t i = 0; i < snapshot.segment.size(); ++i)
+    {
+      points[2 * i] = snapshot.segment[i].x;
+      points[2 * i + 1] = snapshot.segment[i].y;
+    }
+    std::ofstream out((directory_ + "/snapshots.fcppsnap").c_str(), std::ios::binary | std::ios::app);
+    out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    out.write(reinterpret_cast<char const*>(packed.data()), packed.size());
+    out.write(reinterpret_cast<char const*>(points.data()), points.size() * sizeof(int32_t));
+    return static_cast<bool>(out);
+  }
+
+  // Free white, blocked black, visited grey, the segment red with its last tile green. Row 0 of the image is the
+  // highest y, so the image looks like the map in rviz
+  static const uint8_t kColors[3][3] = { { 255, 255, 255 }, { 0, 0, 0 }, { 160, 160, 160 } };
+  size_t stride = 3 * static_cast<size_t>(header.width);
+  std::vector<uint8_t> rgb(stride * header.height);
+  for (uint32_t y = 0; y < header.height; ++y)
+  {
+    uint8_t* pixel = rgb.data() + (header.height - 1 - y) * stride;
+    for (uint32_t x = 0; x < header.width; ++x, pixel += 3)
+    {
+      uint8_t const* color = kColors[snapshot.tiles[y * header.width + x]];
+      pixel[0] = color[0];
+      pixel[1] = color[1];
+      pixel[2] = color[2];
+    }
+  }
+  for (size_t i = 0; i < snapshot.segment.size(); ++i)
+  {
+    Point_t p = snapshot.segment[i];
+    if (p.x >= 0 && p.x < static_cast<int>(header.width) && p.y >= 0 && p.y < static_cast<int>(header.height))
+    {
+      uint8_t* pixel = rgb.data() + (header.height - 1 - p.y) * stride + 3 * p.x;
+      bool last = i + 1 == snapshot.segment.size();
+      pixel[0] = last ? 0 : 255;
+      pixel[1] = last ? 200 : 0;
+      pixel[2] = 0;
+    }
+  }
+
+  char name[64];
+  snprintf(name, sizeof(name), "/plan%u_%04u_%s.png", header.plan, header.sequence, kStageNames[header.stage]);
+  png_image image;
+  memset(&image, 0, sizeof(image));
+  image.version = PNG_IMAGE_VERSION;
+  image.width = header.width;
+  image.height = header.height;
+  image.format = PNG_FORMAT_RGB;
+  return png_image_write_to_file(&image, (directory_ + name).c_str(), 0, rgb.data(), stride, NULL) != 0;
+}
+}  // namespace full_coverage_path_planner
@@ -0,0 +1,488 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * Quality-versus-runtime benchmark of the planner settings over a corpus of maps.
+ *
+ * Usage: fcpp_benchmark [options] map.yaml...
+ *   --config SPEC       configuration to run, e.g. name=fast,tool_radius=0.3,join_style=mwm (repeatable),
+ *                       by default every engine, footprint model and join style
+ *   --robot-radius R    default robot radius [m] (0.3)
+ *   --tool-radius R     default tool radius [m] (0.3)
+ *   --repeat N          planning repetitions per run, the median time is reported (3)
+ *   --csv FILE          write the results as CSV
+ *   --json FILE         write the results as JSON
+ *   --perf-counters     also count cycles, instructions, cache and branch misses per phase (Linux perf_event_open)
+ *
+ * Every (map, configuration) pair runs in its own process, so its peak memory can be measured in isolation.
+ * The Pareto summary is written to stdout.
+ */
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <ros/console.h>
+
+#include "full_coverage_path_planner/benchmark.h"
+#include "full_coverage_path_planner/contour_coverage.h"
+#include "full_coverage_path_planner/full_coverage_path_planner.h"
+#include "full_coverage_path_planner/map_loader.h"
+#include "full_coverage_path_planner/perf_counters.h"
+#include "full_coverage_path_planner/snapshot_sink.h"
+#include "full_coverage_path_planner/spiral_stc.h"
+
+using full_coverage_path_planner::BenchmarkConfig;
+using full_coverage_path_planner::BenchmarkMetrics;
+using full_coverage_path_planner::BenchmarkResult;
+using full_coverage_path_planner::PerfCounters;
+
+namespace full_coverage_path_planner
+{
+/**
+ * Splits the hardware counters of spiral_stc into the spirals and the A* escapes, at the snapshots the search takes
+ * after every spiral and after every escape. The last A* search, which finds no open space and ends the plan, takes no
+ * snapshot: it is what runs between the last snapshot and the end of the plan (see endPlan)
+ */
+class EscapeCounterSink : public SnapshotSink
+{
+public:
+  explicit EscapeCounterSink(PerfCounters const* counters)
+    : counters_(counters), last_(noPerfCounts()), a_star_(noPerfCounts()), goals_(0)
+  {
+  }
+
+  bool enabled() const
+  {
+    return true;
+  }
+
+  void beginPlan()
+  {
+    counters_->read(last_);
+    a_star_ = perfDifference(last_, last_);
+    goals_ = 0;
+  }
+
+  void capture(SnapshotStage stage, std::vector<std::vector<bool> > const& /*grid*/,
+               std::vector<std::vector<bool> > const& /*visited*/, std::vector<gridNode_t> const& /*segment*/,
+               size_t goals)
+  {
+    mark(stage, goals);
+  }
+
+  void capture(SnapshotStage stage, IntervalGrid const& /*grid*/, std::vector<bool> const& /*visited*/,
+               std::vector<gridNode_t> const& /*segment*/, size_t goals)
+  {
+    mark(stage, goals);
+  }
+
+  /**
+   * End of the plan: when open tiles were left at the last snapshot, the search ran a last A* search that did not reach
+   * them, which is counted as an escape as well
+   * @param end counts at the end of the plan
+   */
+  void endPlan(PerfCounts const& end)
+  {
+    if (goals_ > 0)
+    {
+      perfAccumulate(a_star_, perfDifference(last_, end));
+    }
+    last_ = end;
+    goals_ = 0;
+  }
+
+  /**
+   * Counts of the escapes of the last plan, from the snapshot after a spiral to the one after the escape, and of the
+   * last A* search from the last snapshot to endPlan
+   */
+  PerfCounts const& aStar() const
+  {
+    return a_star_;
+  }
+
+private:
+  void mark(SnapshotStage stage, size_t goals)
+  {
+    PerfCounts now;
+    counters_->read(now);
+    if (stage == eSnapshotEscape)
+    {
+      perfAccumulate(a_star_, perfDifference(last_, now));
+    }
+    last_ = now;
+    goals_ = goals;
+  }
+
+  PerfCounters const* counters_;
+  PerfCounts last_;
+  PerfCounts a_star_;
+  size_t goals_;  // Open tiles left at the last snapshot
+};
+
+/**
+ * Runs the planning pipeline of SpiralSTC::makePlan on a given map, with the settings of a benchmark configuration
+ */
+class BenchmarkPlanner : public FullCoveragePathPlanner
+{
+public:
+  explicit BenchmarkPlanner(BenchmarkConfig const& config)
+  {
+    robot_radius_ = config.robot_radius;
+    tool_radius_ = config.tool_radius;
+    footprint_model_ = config.footprint_model == "circle" ? eFootprintCircle : eFootprintSquare;
+    join_params_.style = config.join_style == "half_circle" ? eJoinHalfCircle :
+                         config.join_style == "mwm" ? eJoinMwm : eJoinNone;
+    join_params_.turn_radius = tool_radius_;
+    contour_ = config.engine == "contour";
+    initialized_ = true;
+  }
+
+  bool makePlan(const geometry_msgs::PoseStamped& /*start*/, const geometry_msgs::PoseStamped& /*goal*/,
+                std::vector<geometry_msgs::PoseStamped>& /*plan*/)
+  {
+    return false;  // Not used, run() goes through the same steps with timing in between
+  }
+
+  /**
+   * Plan from the free tile closest to the center of the map. The map is loaded with loadTileGrid like the planner
+   * does with map_file, as part of the parse phase of every repetition
+   * @param map_file map_server yaml file of the map to plan on
+   * @param repeat number of times to plan, the median times are reported
+   * @param counters hardware counters to report per phase, NULL to not count
+   * @param metrics output, except for the peak memory
+   * @return false when the map can not be loaded
+   */
+  bool run(std::string const& map_file, int repeat, PerfCounters const* counters, BenchmarkMetrics& metrics)
+  {
+    metrics.success = false;
+    for (int p = 0; p < ePhaseCount; ++p)
+    {
+      metrics.counts[p] = noPerfCounts();
+    }
+
+    // Start at the free tile closest to the center, untimed
+    std::vector<std::vector<bool> > grid;
+    geometry_msgs::PoseStamped start;
+    Point_t startPoint;
+    if (!loadMapFile(map_file, robot_radius_ * 2, tool_radius_ * 2))
+    {
+      return false;
+    }
+    if (!parseTileGrid(file_metadata_, file_footprint_, file_tiles_, start, grid, startPoint))
+    {
+      return true;
+    }
+    std::list<Point_t> freeTiles = map_2_goals(grid, eNodeOpen);
+    if (freeTiles.empty())
+    {
+      return true;
+    }
+    Point_t center = { static_cast<int>(grid[0].size() / 2), static_cast<int>(grid.size() / 2) };
+    startPoint = *std::min_element(freeTiles.begin(), freeTiles.end(), ComparatorForPointSort(center));
+    start.header.frame_id = "map";
+    start.pose.position.x = (startPoint.x + 0.5) * tile_size_ + grid_origin_.x;
+    start.pose.position.y = (startPoint.y + 0.5) * tile_size_ + grid_origin_.y;
+    start.pose.orientation.w = 1.0;
+
+    // The escapes are only split off when counting, otherwise the search takes no snapshots
+    EscapeCounterSink escapes(counters);
+    spiral_workspace_.snapshots = counters ? &escapes : NULL;
+    std::vector<double> wall_times, parse_times;
+    std::list<Point_t> goalPoints;
+    std::vector<geometry_msgs::PoseStamped> plan;
+    for (int r = 0; r < repeat; ++r)
+    {
+      PerfCounts c0, c1, c2, c3;
+      sample(counters, c0);
+      double t0 = now();
+      Point_t scaledStart;
+      if (!loadMapFile(map_file, robot_radius_ * 2, tool_radius_ * 2) ||
+          !parseTileGrid(file_metadata_, file_footprint_, file_tiles_, start, grid, scaledStart))
+      {
+        return true;
+      }
+      double t1 = now();
+      sample(counters, c1);
+      if (contour_)
+      {
+        contourCoverage(grid, scaledStart, contour_workspace_, path_, spiral_cpp_metrics_.multiple_pass_counter,
+                        spiral_cpp_metrics_.visited_counter);
+      }
+      else
+      {
+        SpiralSTC::spiral_stc(grid, scaledStart, spiral_workspace_, path_, spiral_cpp_metrics_.multiple_pass_counter,
+                              spiral_cpp_metrics_.visited_counter);
+      }
+      goalPoints.assign(path_.begin(), path_.end());
+      sample(counters, c2);
+      plan.clear();
+      parsePointlist2Plan(start, goalPoints, plan);
+      if (join_params_.style != eJoinNone)
+      {
+        smoothPlan(plan);
+      }
+      double t2 = now();
+      sample(counters, c3);
+      parse_times.push_back(t1 - t0);
+      wall_times.push_back(t2 - t0);
+      if (counters)
+      {
+        perfAccumulate(metrics.counts[ePhaseParse], perfDifference(c0, c1));
+        perfAccumulate(metrics.counts[ePhaseCoverage], perfDifference(c1, c2));
+        perfAccumulate(metrics.counts[ePhaseConversion], perfDifference(c2, c3));
+        if (!contour_)
+        {
+          escapes.endPlan(c2);
+          perfAccumulate(metrics.counts[ePhaseAStar], escapes.aStar());
+        }
+      }
+    }
+    for (int p = 0; p < ePhaseCount; ++p)
+    {
+      for (int e = 0; e < ePerfEventCount; ++e)
+      {
+        metrics.counts[p].values[e] = metrics.counts[p].values[e] < 0 ? -1 : metrics.counts[p].values[e] / repeat;
+      }
+    }
+
+    std::vector<Waypoint> waypoints(plan.size());
+    for (unsigned int i = 0; i < plan.size(); ++i)
+    {
+      waypoints[i].x = plan[i].pose.position.x;
+      waypoints[i].y = plan[i].pose.position.y;
+      waypoints[i].yaw = tf::getYaw(plan[i].pose.orientation);
+    }
+    measurePlan(waypoints, metrics);
+    metrics.wall_time_s = median(wall_times);
+    metrics.parse_time_s = median(parse_times);
+    metrics.turns = countTurns(goalPoints);
+    metrics.multiple_pass_counter = spiral_cpp_metrics_.multiple_pass_counter;
+    metrics.accessible_counter = spiral_cpp_metrics_.visited_counter - spiral_cpp_metrics_.multiple_pass_counter;
+    metrics.grid_cells = grid.size() * grid[0].size();
+    metrics.success = true;
+    return true;
+  }
+
+private:
+  static double now()
+  {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+  }
+
+  static void sample(PerfCounters const* counters, PerfCounts& counts)
+  {
+    if (counters == NULL || !counters->read(counts))
+    {
+      counts = noPerfCounts();
+    }
+  }
+
+  static double median(std::vector<double> values)
+  {
+    std::sort(values.begin(), values.end());
+    return values.empty() ? 0.0 : values[values.size() / 2];
+  }
+
+  bool contour_;  ///< Plan with contourCoverage instead of spiral_stc
+  ContourWorkspace contour_workspace_;
+  SpiralWorkspace spiral_workspace_;
+  std::vector<Point_t> path_;
+};
+}  // namespace full_coverage_path_planner
+
+/**
+ * No measurements, and no counters
+ */
+void clearMetrics(BenchmarkMetrics& metrics)
+{
+  memset(&metrics, 0, sizeof(metrics));
+  for (int p = 0; p < full_coverage_path_planner::ePhaseCount; ++p)
+  {
+    metrics.counts[p] = full_coverage_path_planner::noPerfCounts();
+  }
+}
+
+/**
+ * Run one (map, configuration) pair in a child process and measure its peak memory
+ */
+BenchmarkMetrics runIsolated(std::string const& map_file, BenchmarkConfig const& config, int repeat,
+                             bool perf_counters)
+{
+  BenchmarkMetrics metrics;
+  clearMetrics(metrics);
+  int fds[2];
+  if (pipe(fds) != 0)
+  {
+    return metrics;
+  }
+
+  pid_t pid = fork();
+  if (pid == 0)
+  {
+    close(fds[0]);
+    // Opened in the child, the counters only count the thread that plans
+    PerfCounters counters;
+    bool counting = perf_counters && counters.open();
+    full_coverage_path_planner::BenchmarkPlanner planner(config);
+    if (!planner.run(map_file, repeat, counting ? &counters : NULL, metrics))
+    {
+      std::cerr << "Could not load map " << map_file << std::endl;
+    }
+    ssize_t written = write(fds[1], &metrics, sizeof(metrics));
+    _exit(written == sizeof(metrics) ? 0 : 1);
+  }
+  close(fds[1]);
+  if (pid < 0)
+  {
+    close(fds[0]);
+    return metrics;
+  }
+
+  ssize_t received = read(fds[0], &metrics, sizeof(metrics));
+  close(fds[0]);
+  int status;
+  struct rusage usage;
+  wait4(pid, &status, 0, &usage);
+  if (received != sizeof(metrics) || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+  {
+    clearMetrics(metrics);
+  }
+  metrics.peak_memory_kb = usage.ru_maxrss;
+  return metrics;
+}
+
+int main(int argc, char** argv)
+{
+  double robot_radius = 0.3, tool_radius = 0.3;
+  int repeat = 3;
+  bool perf_counters = false;
+  std::string csv_file, json_file;
+  std::vector<std::string> config_specs, maps;
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if (arg == "--config" && has_value)
+    {
+      config_specs.push_back(argv[++i]);
+    }
+    else if (arg == "--robot-radius" && has_value)
+    {
+      robot_radius = atof(argv[++i]);
+    }
+    else if (arg == "--tool-radius" && has_value)
+    {
+      tool_radius = atof(argv[++i]);
+    }
+    else if (arg == "--repeat" && has_value)
+    {
+      repeat = std::max(1, atoi(argv[++i]));
+    }
+    else if (arg == "--csv" && has_value)
+    {
+      csv_file = argv[++i];
+    }
+    else if (arg == "--json" && has_value)
+    {
+      json_file = argv[++i];
+    }
+    else if (arg == "--perf-counters")
+    {
+      perf_counters = true;
+    }
+    else if (arg.compare(0, 2, "--") == 0)
+    {
+      std::cerr << "Unknown option " << arg << std::endl;
+      return 1;
+    }
+    else
+    {
+      maps.push_back(arg);
+    }
+  }
+  if (maps.empty())
+  {
+    std::cerr << "Usage: fcpp_benchmark [--config SPEC]... [--robot-radius R] [--tool-radius R] [--repeat N] "
+                 "[--csv FILE] [--json FILE] [--perf-counters] map.yaml..." << std::endl;
+    return 1;
+  }
+
+  std::vector<BenchmarkConfig> configs;
+  if (config_specs.empty())
+  {
+    configs = full_coverage_path_planner::defaultBenchmarkConfigs(robot_radius, tool_radius);
+  }
+  for (unsigned int i = 0; i < config_specs.size(); ++i)
+  {
+    BenchmarkConfig config = full_coverage_path_planner::defaultBenchmarkConfigs(robot_radius, tool_radius)[0];
+    config.name.clear();
+    if (!full_coverage_path_planner::parseBenchmarkConfig(config_specs[i], config))
+    {
+      std::cerr << "Invalid configuration " << config_specs[i] << std::endl;
+      return 1;
+    }
+    configs.push_back(config);
+  }
+
+  if (perf_counters)
+  {
+    PerfCounters probe;
+    if (!probe.open())
+    {
+      std::cerr << "Hardware counters are not available (" << strerror(errno) << "), check "
+                   "/proc/sys/kernel/perf_event_paranoid; reporting times only" << std::endl;
+      perf_counters = false;
+    }
+  }
+
+  // The planner logs every step, only warnings are of interest here
+  if (ros::console::set_logger_level(ROSCONSOLE_DEFAULT_NAME, ros::console::levels::Warn))
+  {
+    ros::console::notifyLoggerLevelsChanged();
+  }
+
+  std::vector<BenchmarkResult> results;
+  for (unsigned int m = 0; m < maps.size(); ++m)
+  {
+    for (unsigned int c = 0; c < configs.size(); ++c)
+    {
+      BenchmarkResult result;
+      result.map = maps[m];
+      result.config = configs[c];
+      result.metrics = runIsolated(maps[m], configs[c], repeat, perf_counters);
+      result.pareto = false;
+      std::cerr << maps[m] << " " << configs[c].name << ": "
+                << (result.metrics.success ? "done" : "failed") << std::endl;
+      results.push_back(result);
+    }
+  }
+
+  full_coverage_path_planner::markParetoFront(results);
+  if (!csv_file.empty())
+  {
+    std::ofstream csv(csv_file.c_str());
+    full_coverage_path_planner::writeCsv(csv, results);
+  }
+  if (!json_file.empty())
+  {
+    std::ofstream json(json_file.c_str());
+    full_coverage_path_planner::writeJson(json, results);
+  }
+  full_coverage_path_planner::writeParetoSummary(std::cout, results);
+  full_coverage_path_planner::writeCounterSummary(std::cout, results);
+  return 0;
+}
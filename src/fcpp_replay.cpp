@@ -0,0 +1,223 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * Replay of recorded planning requests (see the record_requests_dir parameter), for offline profiling.
+ *
+ * Usage: fcpp_replay [--repeat N] request.fcppreq...
+ *   --repeat N   number of times every request is planned, e.g. to collect enough samples under perf (1)
+ *
+ * Runs the same steps as SpiralSTC::makePlan, with the recorded map, start pose, planner settings and coverage engine,
+ * and prints the time of every step. Run it under a profiler to see where the time goes, e.g.
+ *   perf record -g fcpp_replay --repeat 20 request_3.fcppreq
+ */
+#include <time.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <ros/console.h>
+
+#include "full_coverage_path_planner/full_coverage_path_planner.h"
+#include "full_coverage_path_planner/request_recorder.h"
+#include "full_coverage_path_planner/spiral_stc.h"
+
+namespace full_coverage_path_planner
+{
+/**
+ * Runs the planning pipeline of SpiralSTC::makePlan on a recorded request
+ */
+class ReplayPlanner : public FullCoveragePathPlanner
+{
+public:
+  enum Phase
+  {
+    eParseGrid,
+    eCoverage,
+    eParsePointlist,
+    eSmoothPlan,
+    eResamplePlan,
+    eTotal,
+    ePhaseCount
+  };
+
+  bool makePlan(const geometry_msgs::PoseStamped& /*start*/, const geometry_msgs::PoseStamped& /*goal*/,
+                std::vector<geometry_msgs::PoseStamped>& /*plan*/)
+  {
+    return false;  // Not used, replay() goes through the same steps with timing in between
+  }
+
+  /**
+   * Plan a recorded request
+   * @param request recorded request
+   * @param repeat number of times to plan
+   * @param times output, per phase the time [s] of every repetition
+   * @return false when the map of the request can not be parsed
+   */
+  bool replay(RecordedRequest const& request, int repeat, std::vector<std::vector<double> >& times)
+  {
+    nav_msgs::OccupancyGrid map;
+    geometry_msgs::PoseStamped start;
+    restoreRequest(request, map, start);
+
+    times.assign(ePhaseCount, std::vector<double>());
+    for (int r = 0; r < repeat; ++r)
+    {
+      double t[ePhaseCount + 1];
+      t[eParseGrid] = now();
+      std::vector<std::vector<bool> > grid;
+      Point_t startPoint;
+      if (!parseGrid(map, grid, robot_radius_ * 2, tool_radius_ * 2, start, startPoint))
+      {
+        return false;
+      }
+      t[eCoverage] = now();
+      // The engine of the recorded request, like makePlan picks it
+      if (contour_engine_)
+      {
+        contourCoverage(grid, startPoint, contour_workspace_, path_, spiral_cpp_metrics_.multiple_pass_counter,
+                        spiral_cpp_metrics_.visited_counter);
+      }
+      else if (sparse_grid_)
+      {
+        interval_grid_.assign(grid);
+        SpiralSTC::spiral_stc(interval_grid_, startPoint, interval_workspace_, path_,
+                              spiral_cpp_metrics_.multiple_pass_counter, spiral_cpp_metrics_.visited_counter);
+      }
+      else
+      {
+        SpiralSTC::spiral_stc(grid, startPoint, workspace_, path_, spiral_cpp_metrics_.multiple_pass_counter,
+                              spiral_cpp_metrics_.visited_counter);
+      }
+      std::list<Point_t> goalPoints(path_.begin(), path_.end());
+      t[eParsePointlist] = now();
+      plan_.clear();
+      parsePointlist2Plan(start, goalPoints, plan_);
+      t[eSmoothPlan] = now();
+      if (join_params_.style != eJoinNone)
+      {
+        smoothPlan(plan_);
+      }
+      t[eResamplePlan] = now();
+      if (resample_plan_)
+      {
+        resamplePlan(plan_);
+      }
+      t[eTotal] = now();
+      for (int p = 0; p < eTotal; ++p)
+      {
+        times[p].push_back(t[p + 1] - t[p]);
+      }
+      times[eTotal].push_back(t[eTotal] - t[eParseGrid]);
+    }
+    return true;
+  }
+
+  std::vector<geometry_msgs::PoseStamped> const& plan() const
+  {
+    return plan_;
+  }
+
+private:
+  static double now()
+  {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+  }
+
+  SpiralWorkspace workspace_;
+  IntervalGrid interval_grid_;
+  IntervalSpiralWorkspace interval_workspace_;
+  ContourWorkspace contour_workspace_;
+  std::vector<Point_t> path_;
+  std::vector<geometry_msgs::PoseStamped> plan_;
+};
+}  // namespace full_coverage_path_planner
+
+using full_coverage_path_planner::RecordedRequest;
+using full_coverage_path_planner::ReplayPlanner;
+
+int main(int argc, char** argv)
+{
+  int repeat = 1;
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (arg == "--repeat" && i + 1 < argc)
+    {
+      repeat = std::max(1, atoi(argv[++i]));
+    }
+    else if (arg.compare(0, 2, "--") == 0)
+    {
+      std::cerr << "Unknown option " << arg << std::endl;
+      return 1;
+    }
+    else
+    {
+      files.push_back(arg);
+    }
+  }
+  if (files.empty())
+  {
+    std::cerr << "Usage: fcpp_replay [--repeat N] request.fcppreq..." << std::endl;
+    return 1;
+  }
+
+  // The planner logs every step, only warnings are of interest here
+  if (ros::console::set_logger_level(ROSCONSOLE_DEFAULT_NAME, ros::console::levels::Warn))
+  {
+    ros::console::notifyLoggerLevelsChanged();
+  }
+
+  char const* phase_names[] = { "parseGrid", "coverage", "parsePointlist2Plan", "smoothPlan", "resamplePlan",
+                                "total" };
+  int result = 0;
+  for (unsigned int f = 0; f < files.size(); ++f)
+  {
+    RecordedRequest request;
+    if (!full_coverage_path_planner::readRequest(files[f], request))
+    {
+      std::cerr << "Could not read request " << files[f] << std::endl;
+      result = 1;
+      continue;
+    }
+    full_coverage_path_planner::RecordedRequestHeader const& header = request.header;
+    std::cout << files[f] << ": " << header.width << "x" << header.height << " cells of " << header.resolution
+              << " m, start (" << header.start_x << ", " << header.start_y << ", " << header.start_yaw
+              << "), robot_radius " << header.robot_radius << ", tool_radius " << header.tool_radius << ", engine "
+              << (header.coverage_engine == full_coverage_path_planner::eRecordedContour ? "contour" :
+                  header.sparse_grid ? "spiral_stc (sparse_grid)" : "spiral_stc")
+              << ", recorded at " << std::fixed << std::setprecision(3) << header.stamp << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::setprecision(6);
+
+    ReplayPlanner planner;
+    std::vector<std::vector<double> > times;
+    if (!planner.replay(request, repeat, times))
+    {
+      std::cerr << "Could not parse the map of " << files[f] << std::endl;
+      result = 1;
+      continue;
+    }
+    std::cout << "  plan of " << planner.plan().size() << " poses, times over " << repeat << " run(s) [ms]:"
+              << std::endl;
+    std::cout << "  " << std::left << std::setw(22) << "phase" << std::right << std::setw(12) << "min"
+              << std::setw(12) << "median" << std::setw(12) << "max" << std::endl;
+    for (unsigned int p = 0; p < times.size(); ++p)
+    {
+      std::sort(times[p].begin(), times[p].end());
+      std::cout << "  " << std::left << std::setw(22) << phase_names[p] << std::right << std::setw(12)
+                << times[p].front() * 1000 << std::setw(12) << times[p][times[p].size() / 2] * 1000 << std::setw(12)
+                << times[p].back() * 1000 << std::endl;
+    }
+  }
+  return result;
+}
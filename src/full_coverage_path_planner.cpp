@@ -1,7 +1,10 @@
 //
 // Copyright [2020] Nobleo Technology"  [legal/copyright]
 //
+#include <algorithm>
+#include <cmath>
 #include <list>
+#include <memory>
 #include <vector>
 
 #include "full_coverage_path_planner/full_coverage_path_planner.h"
@@ -27,13 +30,34 @@
  *   O   --->> x-axis
  */
 
-// #define DEBUG_PLOT
-
 // Default Constructor
 namespace full_coverage_path_planner
 {
-FullCoveragePathPlanner::FullCoveragePathPlanner() : initialized_(false)
+FullCoveragePathPlanner::FullCoveragePathPlanner()
+  : footprint_model_(eFootprintSquare),
+    footprint_inscribed_radius_(0.0f),
+    footprint_circumscribed_radius_(0.0f),
+    contour_engine_(false),
+    sparse_grid_(false),
+    has_dock_(false),
+    plan_handoff_(NULL),
+    map_updates_(false),
+    has_map_(false),
+    grid_valid_(false),
+    initialized_(false)
 {
+  join_params_.style = eJoinNone;
+  join_params_.turn_radius = 0.0;
+  join_params_.u_turn_width = 0.0;
+  join_params_.spacing = 0.1;
+  join_params_.v_depth = 1.0;
+  join_params_.v_bottom_off_center = 0.0;
+  resample_plan_ = false;
+  resampling_params_.spacing = 0.05;
+  resampling_params_.max_velocity = 0.5;
+  resampling_params_.max_acceleration = 0.5;
+  resampling_params_.max_lateral_acceleration = 0.3;
+  publish_plan_topic_ = true;
 }
 
 void FullCoveragePathPlanner::publishPlan(const std::vector<geometry_msgs::PoseStamped>& path)
@@ -44,6 +68,13 @@ void FullCoveragePathPlanner::publishPlan(const std::vector<geometry_msgs::PoseS
     return;
   }
 
+  // Fall back to the topic when the plan cannot be shared
+  bool shared = shared_plan_writer_.isOpen() && publishSharedPlan(path);
+  if (shared && !publish_plan_topic_)
+  {
+    return;
+  }
+
   // create a message for the plan
   nav_msgs::Path gui_path;
   gui_path.poses.resize(path.size());
@@ -63,102 +94,82 @@ void FullCoveragePathPlanner::publishPlan(const std::vector<geometry_msgs::PoseS
   plan_pub_.publish(gui_path);
 }
 
-void FullCoveragePathPlanner::parsePointlist2Plan(const geometry_msgs::PoseStamped& start,
-    std::list<Point_t> const& goalpoints,
-    std::vector<geometry_msgs::PoseStamped>& plan)
+bool FullCoveragePathPlanner::publishSharedPlan(const std::vector<geometry_msgs::PoseStamped>& path)
 {
-  geometry_msgs::PoseStamped new_goal;
-  std::list<Point_t>::const_iterator it, it_next, it_prev;
-  int dx_now, dy_now, dx_next, dy_next, move_dir_now = 0, move_dir_prev = 0, move_dir_next = 0;
-  bool do_publish = false;
-  float orientation = eDirNone;
-  ROS_INFO("Received goalpoints with length: %lu", goalpoints.size());
-  if (goalpoints.size() > 1)
+  full_coverage_path_planner::SharedPlanHandle handle;
+  SharedPlanSlotRef ref;
+  SharedPlanPose* poses = shared_plan_writer_.beginWrite(path.size(), ref);
+  if (poses == NULL)
   {
-    for (it = goalpoints.begin(); it != goalpoints.end(); ++it)
-    {
-      it_next = it;
-      it_next++;
-      it_prev = it;
-      it_prev--;
+    ROS_WARN("Plan of %zu poses does not fit in shared memory, publishing it on the plan topic", path.size());
+    return false;
+  }
 
-      // Check for the direction of movement
-      if (it == goalpoints.begin())
-      {
-        dx_now = it_next->x - it->x;
-        dy_now = it_next->y - it->y;
-      }
-      else
-      {
-        dx_now = it->x - it_prev->x;
-        dy_now = it->y - it_prev->y;
-        dx_next = it_next->x - it->x;
-        dy_next = it_next->y - it->y;
-      }
+  // Poses are written in place, the frame and stamp of the first pose go in the handle
+  for (unsigned int i = 0; i < path.size(); i++)
+  {
+    poses[i].x = path[i].pose.position.x;
+    poses[i].y = path[i].pose.position.y;
+    poses[i].yaw = tf::getYaw(path[i].pose.orientation);
+  }
+  shared_plan_writer_.commit(ref);
 
-      // Calculate direction enum: dx + dy*2 will give a unique number for each of the four possible directions because
-      // of their signs:
-      //  1 +  0*2 =  1
-      //  0 +  1*2 =  2
-      // -1 +  0*2 = -1
-      //  0 + -1*2 = -2
-      move_dir_now = dx_now + dy_now * 2;
-      move_dir_next = dx_next + dy_next * 2;
-
-      // Check if this points needs to be published (i.e. a change of direction or first or last point in list)
-      do_publish = move_dir_next != move_dir_now || it == goalpoints.begin() ||
-                   (it != goalpoints.end() && it == --goalpoints.end());
-      move_dir_prev = move_dir_now;
-
-      // Add to vector if required
-      if (do_publish)
-      {
-        new_goal.header.frame_id = "map";
-        new_goal.pose.position.x = (it->x) * tile_size_ + grid_origin_.x + tile_size_ * 0.5;
-        new_goal.pose.position.y = (it->y) * tile_size_ + grid_origin_.y + tile_size_ * 0.5;
-        // Calculate desired orientation to be in line with movement direction
-        switch (move_dir_now)
-        {
-        case eDirNone:
-          // Keep orientation
-          break;
-        case eDirRight:
-          orientation = 0;
-          break;
-        case eDirUp:
-          orientation = M_PI / 2;
-          break;
-        case eDirLeft:
-          orientation = M_PI;
-          break;
-        case eDirDown:
-          orientation = M_PI * 1.5;
-          break;
-        }
-        new_goal.pose.orientation = tf::createQuaternionMsgFromYaw(orientation);
-        if (it != goalpoints.begin())
-        {
-          previous_goal_.pose.orientation = new_goal.pose.orientation;
-          // republish previous goal but with new orientation to indicate change of direction
-          // useful when the plan is strictly followed with base_link
-          plan.push_back(previous_goal_);
-        }
-        ROS_DEBUG("Voila new point: x=%f, y=%f, o=%f,%f,%f,%f", new_goal.pose.position.x, new_goal.pose.position.y,
-                  new_goal.pose.orientation.x, new_goal.pose.orientation.y, new_goal.pose.orientation.z,
-                  new_goal.pose.orientation.w);
-        plan.push_back(new_goal);
-        previous_goal_ = new_goal;
-      }
-    }
+  if (!path.empty())
+  {
+    handle.header.frame_id = path[0].header.frame_id;
+    handle.header.stamp = path[0].header.stamp;
   }
-  else
+  handle.shm_name = shared_plan_writer_.name();
+  handle.slot = ref.slot;
+  handle.sequence = ref.sequence;
+  handle.pose_count = ref.pose_count;
+  shared_plan_pub_.publish(handle);
+  return true;
+}
+
+void FullCoveragePathPlanner::handOffPlan(const std::vector<geometry_msgs::PoseStamped>& plan,
+                                          std::list<Point_t> const& goalpoints)
+{
+  if (plan_handoff_ == NULL)
+  {
+    return;
+  }
+  // Fill the buffer of the plan before the last one, readers keep the last one until the swap in commit()
+  std::shared_ptr<HandoffPlan> handoff = plan_handoff_->beginWrite();
+  handoff->frame_id = plan.empty() ? "map" : plan[0].header.frame_id;
+  handoff->stamp = plan.empty() ? 0.0 : plan[0].header.stamp.toSec();
+  handoff->origin_x = grid_origin_.x;
+  handoff->origin_y = grid_origin_.y;
+  handoff->tile_size = tile_size_;
+  handoff->poses.resize(plan.size());
+  for (size_t i = 0; i < plan.size(); ++i)
   {
-    new_goal.header.frame_id = "map";
-    new_goal.pose.position.x = (goalpoints.begin()->x) * tile_size_ + grid_origin_.x + tile_size_ * 0.5;
-    new_goal.pose.position.y = (goalpoints.begin()->y) * tile_size_ + grid_origin_.y + tile_size_ * 0.5;
-    new_goal.pose.orientation = tf::createQuaternionMsgFromYaw(0);
+    handoff->poses[i].x = plan[i].pose.position.x;
+    handoff->poses[i].y = plan[i].pose.position.y;
+    handoff->poses[i].yaw = tf::getYaw(plan[i].pose.orientation);
+  }
+  handoff->tiles.assign(goalpoints.begin(), goalpoints.end());
+  mapPosesToTiles(handoff->poses, handoff->tiles, grid_origin_.x, grid_origin_.y, tile_size_, handoff->pose_tiles);
+  plan_handoff_->commit(handoff);
+}
+
+void FullCoveragePathPlanner::parsePointlist2Plan(const geometry_msgs::PoseStamped& start,
+    std::list<Point_t> const& goalpoints,
+    std::vector<geometry_msgs::PoseStamped>& plan)
+{
+  ROS_INFO("Received goalpoints with length: %lu", goalpoints.size());
+  std::vector<Waypoint> waypoints;
+  tileWalkToWaypoints(goalpoints.begin(), goalpoints.end(), tile_size_, grid_origin_.x, grid_origin_.y, waypoints);
+  geometry_msgs::PoseStamped new_goal;
+  new_goal.header.frame_id = "map";
+  for (std::vector<Waypoint>::const_iterator it = waypoints.begin(); it != waypoints.end(); ++it)
+  {
+    new_goal.pose.position.x = it->x;
+    new_goal.pose.position.y = it->y;
+    new_goal.pose.orientation = tf::createQuaternionMsgFromYaw(it->yaw);
     plan.push_back(new_goal);
   }
+
   /* Add poses from current position to start of plan */
 
   // Compute angle between current pose and first plan point
@@ -185,6 +196,435 @@ void FullCoveragePathPlanner::parsePointlist2Plan(const geometry_msgs::PoseStamp
   ROS_INFO("Plan ready containing %lu goals!", plan.size());
 }
 
+void FullCoveragePathPlanner::publishCompactPlan(const geometry_msgs::PoseStamped& start,
+                                                 std::list<Point_t> const& goalpoints)
+{
+  full_coverage_path_planner::CompactCoveragePlan compact_plan;
+  compact_plan.header.frame_id = "map";
+  compact_plan.header.stamp = start.header.stamp;
+  compact_plan.origin_x = grid_origin_.x;
+  compact_plan.origin_y = grid_origin_.y;
+  compact_plan.tile_size = tile_size_;
+  if (!goalpoints.empty())
+  {
+    compact_plan.start_x = goalpoints.front().x;
+    compact_plan.start_y = goalpoints.front().y;
+  }
+  compact_plan.directions = encodeDirections(goalpoints.begin(), goalpoints.end());
+  ROS_INFO("Compact plan of %lu tiles in %lu characters", goalpoints.size(), compact_plan.directions.size());
+  compact_plan_pub_.publish(compact_plan);
+}
+
+bool FullCoveragePathPlanner::publishPlanSegments(const geometry_msgs::PoseStamped& start,
+                                                  std::vector<std::vector<bool> > const& grid,
+                                                  Point_t const& startPoint, std::vector<Point_t> const& goalpoints)
+{
+  Point_t dock = startPoint;
+  if (has_dock_)
+  {
+    dock.x = static_cast<int>(floor((dock_.x - grid_origin_.x) / tile_size_));
+    dock.y = static_cast<int>(floor((dock_.y - grid_origin_.y) / tile_size_));
+  }
+  std::vector<int> distance;
+  dockDistanceField(grid, dock, distance);
+  PathCostTable table;
+  table.assign(goalpoints);
+  std::vector<PlanSegment> segments;
+  bool fits = segmentPath(goalpoints, table, distance, grid[0].size(), tile_size_, segmentation_params_, segments);
+
+  full_coverage_path_planner::PlanSegments msg;
+  msg.header.frame_id = "map";
+  msg.header.stamp = start.header.stamp;
+  msg.budget = segmentation_params_.budget;
+  msg.segments.resize(segments.size());
+  for (unsigned int i = 0; i < segments.size(); ++i)
+  {
+    msg.costs.push_back(segments[i].cost);
+    msg.approach_distances.push_back(segments[i].approach * tile_size_);
+    msg.return_distances.push_back(segments[i].retreat * tile_size_);
+    std::vector<Waypoint> waypoints;
+    tileWalkToWaypoints(goalpoints.begin() + segments[i].begin, goalpoints.begin() + segments[i].end + 1, tile_size_,
+                        grid_origin_.x, grid_origin_.y, waypoints);
+    msg.segments[i].header = msg.header;
+    msg.segments[i].poses.resize(waypoints.size());
+    for (unsigned int j = 0; j < waypoints.size(); ++j)
+    {
+      msg.segments[i].poses[j].header = msg.header;
+      msg.segments[i].poses[j].pose.position.x = waypoints[j].x;
+      msg.segments[i].poses[j].pose.position.y = waypoints[j].y;
+      msg.segments[i].poses[j].pose.orientation = tf::createQuaternionMsgFromYaw(waypoints[j].yaw);
+    }
+  }
+  if (fits)
+  {
+    ROS_INFO("Plan split into %lu segments", segments.size());
+  }
+  else
+  {
+    ROS_ERROR("Plan does not fit in segments of budget %f, only the first %lu segments are published",
+              segmentation_params_.budget, segments.size());
+  }
+  segments_pub_.publish(msg);
+  return fits;
+}
+
+void FullCoveragePathPlanner::smoothPlan(std::vector<geometry_msgs::PoseStamped>& plan)
+{
+  if (plan.empty())
+  {
+    return;
+  }
+
+  std::vector<Waypoint> waypoints(plan.size());
+  for (unsigned int i = 0; i < plan.size(); ++i)
+  {
+    waypoints[i].x = plan[i].pose.position.x;
+    waypoints[i].y = plan[i].pose.position.y;
+    waypoints[i].yaw = tf::getYaw(plan[i].pose.orientation);
+  }
+
+  // Strokes are one tile apart
+  join_params_.u_turn_width = tile_size_;
+  std::vector<Waypoint> smoothed = smoothStrokeJoins(waypoints, join_params_);
+
+  // The first pose is the start pose of the robot, keep it as is
+  geometry_msgs::PoseStamped start = plan.front();
+  geometry_msgs::PoseStamped new_goal = plan.back();
+  plan.resize(smoothed.size());
+  plan[0] = start;
+  for (unsigned int i = 1; i < smoothed.size(); ++i)
+  {
+    new_goal.pose.position.x = smoothed[i].x;
+    new_goal.pose.position.y = smoothed[i].y;
+    new_goal.pose.orientation = tf::createQuaternionMsgFromYaw(smoothed[i].yaw);
+    plan[i] = new_goal;
+  }
+  ROS_INFO("Smoothed plan contains %lu goals", plan.size());
+}
+
+void FullCoveragePathPlanner::resamplePlan(std::vector<geometry_msgs::PoseStamped>& plan)
+{
+  if (plan.empty())
+  {
+    return;
+  }
+
+  std::vector<Waypoint> waypoints(plan.size());
+  for (unsigned int i = 0; i < plan.size(); ++i)
+  {
+    waypoints[i].x = plan[i].pose.position.x;
+    waypoints[i].y = plan[i].pose.position.y;
+    waypoints[i].yaw = tf::getYaw(plan[i].pose.orientation);
+  }
+
+  PathProfile profile;
+  resamplePath(waypoints, resampling_params_, profile);
+
+  // The first pose is the start pose of the robot, keep it as is
+  geometry_msgs::PoseStamped start = plan.front();
+  geometry_msgs::PoseStamped new_goal = plan.back();
+  plan.resize(profile.poses.size());
+  plan[0] = start;
+  for (unsigned int i = 1; i < profile.poses.size(); ++i)
+  {
+    new_goal.pose.position.x = profile.poses[i].x;
+    new_goal.pose.position.y = profile.poses[i].y;
+    new_goal.pose.orientation = tf::createQuaternionMsgFromYaw(profile.poses[i].yaw);
+    plan[i] = new_goal;
+  }
+
+  // Publish the profile with the same header as the plan, so consumers can match them
+  full_coverage_path_planner::PlanProfile profile_msg;
+  profile_msg.header.frame_id = start.header.frame_id;
+  profile_msg.header.stamp = start.header.stamp;
+  profile_msg.arc_length = profile.arc_length;
+  profile_msg.curvature = profile.curvature;
+  profile_msg.max_velocity = profile.max_velocity;
+  if (profile_pub_)
+  {
+    profile_pub_.publish(profile_msg);
+  }
+  ROS_INFO("Resampled plan contains %lu goals", plan.size());
+}
+
+bool FullCoveragePathPlanner::parsePoints(XmlRpc::XmlRpcValue& value, std::vector<fPoint_t>& points)
+{
+  points.clear();
+  if (value.getType() != XmlRpc::XmlRpcValue::TypeArray)
+  {
+    return false;
+  }
+
+  for (int i = 0; i < value.size(); ++i)
+  {
+    XmlRpc::XmlRpcValue& point = value[i];
+    if (point.getType() != XmlRpc::XmlRpcValue::TypeArray || point.size() != 2)
+    {
+      points.clear();
+      return false;
+    }
+    float coordinates[2];
+    for (int j = 0; j < 2; ++j)
+    {
+      if (point[j].getType() == XmlRpc::XmlRpcValue::TypeInt)
+      {
+        coordinates[j] = static_cast<int>(point[j]);
+      }
+      else if (point[j].getType() == XmlRpc::XmlRpcValue::TypeDouble)
+      {
+        coordinates[j] = static_cast<double>(point[j]);
+      }
+      else
+      {
+        points.clear();
+        return false;
+      }
+    }
+    fPoint_t p = { coordinates[0], coordinates[1] };
+    points.push_back(p);
+  }
+  return true;
+}
+
+bool FullCoveragePathPlanner::parsePolygon(XmlRpc::XmlRpcValue& value, std::vector<fPoint_t>& polygon)
+{
+  if (!parsePoints(value, polygon) || polygon.size() < 3)
+  {
+    polygon.clear();
+    return false;
+  }
+  return true;
+}
+
+bool FullCoveragePathPlanner::planFromAtlas(const geometry_msgs::PoseStamped& start, std::list<Point_t>& goalpoints)
+{
+  std::vector<int> zones;
+  if (!ros::param::get(atlas_zones_param_, zones) || zones.empty())
+  {
+    ROS_WARN("No zones set in %s, planning instead of using the atlas", atlas_zones_param_.c_str());
+    return false;
+  }
+
+  // The robot has to be at (or next to) one of the docking stations the atlas was built for
+  AtlasFileHeader const& header = atlas_.header();
+  Point_t startTile =
+  {
+    static_cast<int>(floor((start.pose.position.x - header.origin_x) / header.tile_size)),
+    static_cast<int>(floor((start.pose.position.y - header.origin_y) / header.tile_size))
+  };
+  int distance_squared = 0;
+  int dock = atlas_.nearestDock(startTile, distance_squared);
+  if (dock < 0 || distance_squared > 2)
+  {
+    ROS_WARN("Start is not at a docking station of the atlas, planning instead");
+    return false;
+  }
+  if (!atlas_.assemble(dock, zones, goalpoints))
+  {
+    ROS_WARN("Zones can not be stitched from dock %d with the atlas, planning instead", dock);
+    return false;
+  }
+
+  tile_size_ = header.tile_size;
+  grid_origin_.x = header.origin_x;
+  grid_origin_.y = header.origin_y;
+
+  // Same metrics as the spiral reports
+  std::vector<bool> visited(static_cast<size_t>(header.width) * header.height, false);
+  spiral_cpp_metrics_.visited_counter = goalpoints.size();
+  spiral_cpp_metrics_.multiple_pass_counter = 0;
+  for (std::list<Point_t>::const_iterator it = goalpoints.begin(); it != goalpoints.end(); ++it)
+  {
+    if (it->x < 0 || it->x >= header.width || it->y < 0 || it->y >= header.height)
+    {
+      continue;
+    }
+    size_t index = static_cast<size_t>(it->y) * header.width + it->x;
+    spiral_cpp_metrics_.multiple_pass_counter += visited[index];
+    visited[index] = true;
+  }
+  ROS_INFO("Assembled plan of %lu tiles from dock %d over %lu zones", goalpoints.size(), dock, zones.size());
+  return true;
+}
+
+void FullCoveragePathPlanner::recordRequest(nav_msgs::OccupancyGrid const& map, const geometry_msgs::PoseStamped& start)
+{
+  RecordedRequest request;
+  RecordedRequestHeader& header = request.header;
+  header.stamp = ros::WallTime::now().toSec();
+  header.start_x = start.pose.position.x;
+  header.start_y = start.pose.position.y;
+  header.start_yaw = tf::getYaw(start.pose.orientation);
+  header.robot_radius = robot_radius_;
+  header.tool_radius = tool_radius_;
+  header.footprint_model = footprint_model_;
+  header.footprint_inscribed_radius = footprint_inscribed_radius_;
+  header.footprint_circumscribed_radius = footprint_circumscribed_radius_;
+  header.join_style = join_params_.style;
+  header.join_turn_radius = join_params_.turn_radius;
+  header.join_u_turn_width = join_params_.u_turn_width;
+  header.join_spacing = join_params_.spacing;
+  header.join_v_depth = join_params_.v_depth;
+  header.join_v_bottom_off_center = join_params_.v_bottom_off_center;
+  header.resample_plan = resample_plan_;
+  header.resample_spacing = resampling_params_.spacing;
+  header.max_velocity = resampling_params_.max_velocity;
+  header.max_acceleration = resampling_params_.max_acceleration;
+  header.max_lateral_acceleration = resampling_params_.max_lateral_acceleration;
+  header.coverage_engine = contour_engine_ ? eRecordedContour : eRecordedSpiralStc;
+  header.sparse_grid = sparse_grid_;
+  request.roi = roi_;
+  packMap(map, request);
+
+  std::string file = request_recorder_.record(request);
+  if (file.empty())
+  {
+    ROS_WARN("Could not record the planning request");
+  }
+  else
+  {
+    ROS_INFO("Recorded the planning request in %s", file.c_str());
+  }
+}
+
+void FullCoveragePathPlanner::restoreRequest(RecordedRequest const& request, nav_msgs::OccupancyGrid& map,
+                                             geometry_msgs::PoseStamped& start)
+{
+  RecordedRequestHeader const& header = request.header;
+  robot_radius_ = header.robot_radius;
+  tool_radius_ = header.tool_radius;
+  footprint_model_ = static_cast<FootprintModel>(header.footprint_model);
+  footprint_inscribed_radius_ = header.footprint_inscribed_radius;
+  footprint_circumscribed_radius_ = header.footprint_circumscribed_radius;
+  join_params_.style = static_cast<JoinStyle>(header.join_style);
+  join_params_.turn_radius = header.join_turn_radius;
+  join_params_.u_turn_width = header.join_u_turn_width;
+  join_params_.spacing = header.join_spacing;
+  join_params_.v_depth = header.join_v_depth;
+  join_params_.v_bottom_off_center = header.join_v_bottom_off_center;
+  resample_plan_ = header.resample_plan;
+  resampling_params_.spacing = header.resample_spacing;
+  resampling_params_.max_velocity = header.max_velocity;
+  resampling_params_.max_acceleration = header.max_acceleration;
+  resampling_params_.max_lateral_acceleration = header.max_lateral_acceleration;
+  contour_engine_ = header.coverage_engine == eRecordedContour;
+  sparse_grid_ = header.sparse_grid;
+  roi_ = request.roi;
+  unpackMap(request, map);
+
+  start.header.frame_id = "map";
+  start.pose.position.x = header.start_x;
+  start.pose.position.y = header.start_y;
+  start.pose.orientation = tf::createQuaternionMsgFromYaw(header.start_yaw);
+  initialized_ = true;
+}
+
+bool FullCoveragePathPlanner::updateGrid(nav_msgs::OccupancyGrid const& cpp_grid_, int cx0, int cy0, int cx1, int cy1,
+                                         std::vector<std::vector<bool> >& grid, std::vector<Point_t>& changed)
+{
+  changed.clear();
+  nav_msgs::MapMetaData const& info = cpp_grid_.info;
+  // The origin of a map that did not move can still differ in the last bits, e.g. after a round trip through yaml
+  double origin_tolerance = 0.01 * info.resolution;
+  if (grid.empty() || info.width != parsed_map_info_.width || info.height != parsed_map_info_.height ||
+      info.resolution != parsed_map_info_.resolution ||
+      std::fabs(info.origin.position.x - parsed_map_info_.origin.position.x) > origin_tolerance ||
+      std::fabs(info.origin.position.y - parsed_map_info_.origin.position.y) > origin_tolerance ||
+      cpp_grid_.data.size() < static_cast<size_t>(info.width) * info.height)
+  {
+    return false;
+  }
+  updateTiles(&cpp_grid_.data[0], info.width, info.height, parsed_footprint_,
+              clamp(cx0, 0, static_cast<int>(info.width)), clamp(cy0, 0, static_cast<int>(info.height)),
+              clamp(cx1, 0, static_cast<int>(info.width)), clamp(cy1, 0, static_cast<int>(info.height)),
+              grid, parsed_tile_origin_.x, parsed_tile_origin_.y, roi_blocked_.empty() ? NULL : &roi_blocked_,
+              changed);
+  ROS_DEBUG("Updated grid for cells [%d, %d) x [%d, %d): %lu tiles changed", cx0, cx1, cy0, cy1, changed.size());
+  return true;
+}
+
+TileFootprint FullCoveragePathPlanner::tileFootprint(float robotRadius, float toolRadius, double resolution) const
+{
+  TileFootprint footprint;
+  footprint.model = footprint_model_;
+  footprint.node_size = dmax(floor(toolRadius / resolution), 1);  // Size of node in pixels/units
+  footprint.footprint_size = dmax(floor(robotRadius / resolution), 1);  // RobotRadius in pixels/units
+  switch (footprint_model_)
+  {
+  case eFootprintInscribed:
+    footprint.radius = footprint_inscribed_radius_ / resolution;
+    break;
+  case eFootprintCircumscribed:
+    footprint.radius = footprint_circumscribed_radius_ / resolution;
+    break;
+  default:
+    // Circular robot, robotRadius is its diameter
+    footprint.radius = 0.5 * robotRadius / resolution;
+    break;
+  }
+  return footprint;
+}
+
+bool FullCoveragePathPlanner::roiTiles(int nTileCols, int nTileRows, int& tx0, int& ty0, int& tx1, int& ty1)
+{
+  // Only the tiles in the bounding box of the region of interest are parsed, by default that is the whole map
+  tx0 = 0;
+  ty0 = 0;
+  tx1 = nTileCols;
+  ty1 = nTileRows;
+  if (!roi_.empty())
+  {
+    float min_x = roi_[0].x, max_x = roi_[0].x, min_y = roi_[0].y, max_y = roi_[0].y;
+    for (std::vector<fPoint_t>::const_iterator it = roi_.begin(); it != roi_.end(); ++it)
+    {
+      min_x = dmin(min_x, it->x);
+      max_x = dmax(max_x, it->x);
+      min_y = dmin(min_y, it->y);
+      max_y = dmax(max_y, it->y);
+    }
+    tx0 = clamp(static_cast<int>(floor((min_x - grid_origin_.x) / tile_size_)), 0, nTileCols);
+    ty0 = clamp(static_cast<int>(floor((min_y - grid_origin_.y) / tile_size_)), 0, nTileRows);
+    tx1 = clamp(static_cast<int>(ceil((max_x - grid_origin_.x) / tile_size_)), tx0, nTileCols);
+    ty1 = clamp(static_cast<int>(ceil((max_y - grid_origin_.y) / tile_size_)), ty0, nTileRows);
+    if (tx0 == tx1 || ty0 == ty1)
+    {
+      ROS_ERROR("Region of interest does not overlap with the map");
+      return false;
+    }
+    // The grid starts at the corner of the bounding box
+    grid_origin_.x += tx0 * tile_size_;
+    grid_origin_.y += ty0 * tile_size_;
+    ROS_INFO("Cropped grid to region of interest: %d x %d tiles", tx1 - tx0, ty1 - ty0);
+  }
+  return true;
+}
+
+void FullCoveragePathPlanner::maskRoi(std::vector<std::vector<bool> >& grid)
+{
+  roi_blocked_.clear();
+  if (roi_.empty())
+  {
+    return;
+  }
+  // Block the tiles outside of the region of interest, with the polygon expressed in (cropped) grid coordinates
+  int nTileRows = grid.size(), nTileCols = grid[0].size();
+  std::vector<fPoint_t> polygon(roi_.size());
+  for (unsigned int i = 0; i < roi_.size(); ++i)
+  {
+    polygon[i].x = (roi_[i].x - grid_origin_.x) / tile_size_;
+    polygon[i].y = (roi_[i].y - grid_origin_.y) / tile_size_;
+  }
+  roi_blocked_.assign(nTileRows, std::vector<bool>(nTileCols, false));
+  maskOutsidePolygon(roi_blocked_, polygon);
+  for (int y = 0; y < nTileRows; ++y)
+  {
+    for (int x = 0; x < nTileCols; ++x)
+    {
+      grid[y][x] = grid[y][x] || roi_blocked_[y][x];
+    }
+  }
+}
+
 bool FullCoveragePathPlanner::parseGrid(nav_msgs::OccupancyGrid const& cpp_grid_,
                                         std::vector<std::vector<bool> >& grid,
                                         float robotRadius,
@@ -192,13 +632,13 @@ bool FullCoveragePathPlanner::parseGrid(nav_msgs::OccupancyGrid const& cpp_grid_
                                         geometry_msgs::PoseStamped const& realStart,
                                         Point_t& scaledStart)
 {
-  int ix, iy, nodeRow, nodeColl;
-  uint32_t nodeSize = dmax(floor(toolRadius / cpp_grid_.info.resolution), 1);  // Size of node in pixels/units
-  uint32_t robotNodeSize = dmax(floor(robotRadius / cpp_grid_.info.resolution), 1);  // RobotRadius in pixels/units
+  // Scale grid, inflating the obstacles with the robot footprint
+  TileFootprint footprint = tileFootprint(robotRadius, toolRadius, cpp_grid_.info.resolution);
+  int nodeSize = footprint.node_size;
   uint32_t nRows = cpp_grid_.info.height, nCols = cpp_grid_.info.width;
   ROS_INFO("nRows: %u nCols: %u nodeSize: %d", nRows, nCols, nodeSize);
 
-  if (nRows == 0 || nCols == 0)
+  if (nRows == 0 || nCols == 0 || cpp_grid_.data.size() < static_cast<size_t>(nRows) * nCols)
   {
     return false;
   }
@@ -208,35 +648,223 @@ bool FullCoveragePathPlanner::parseGrid(nav_msgs::OccupancyGrid const& cpp_grid_
   grid_origin_.x = cpp_grid_.info.origin.position.x;  // x-origin in meters
   grid_origin_.y = cpp_grid_.info.origin.position.y;  // y-origin in meters
 
+  int tx0, ty0, tx1, ty1;
+  if (!roiTiles(tileCount(nCols, nodeSize), tileCount(nRows, nodeSize), tx0, ty0, tx1, ty1))
+  {
+    return false;
+  }
+
+  grid.assign(ty1 - ty0, std::vector<bool>(tx1 - tx0, false));
+  inflateTiles(&cpp_grid_.data[0], nCols, nRows, footprint, tx0, ty0, tx1, ty1, grid, tx0, ty0);
+  parsed_map_info_ = cpp_grid_.info;
+  parsed_footprint_ = footprint;
+  parsed_tile_origin_.x = tx0;
+  parsed_tile_origin_.y = ty0;
+  maskRoi(grid);
+  return startTile(grid, realStart, scaledStart);
+}
+
+bool FullCoveragePathPlanner::parseTileGrid(MapMetadata const& metadata, TileFootprint const& footprint,
+                                            std::vector<std::vector<bool> > const& tiles,
+                                            geometry_msgs::PoseStamped const& realStart,
+                                            std::vector<std::vector<bool> >& grid, Point_t& scaledStart)
+{
+  if (tiles.empty() || tiles[0].empty())
+  {
+    return false;
+  }
+  tile_size_ = footprint.node_size * static_cast<float>(metadata.resolution);
+  grid_origin_.x = metadata.origin_x;
+  grid_origin_.y = metadata.origin_y;
+
+  // The tiles do not depend on the crop: a tile only reads the map cells in its footprint window, which
+  // loadTileGrid inflated from the whole map. So the crop is a copy of the bounding box of the region of interest
+  int tx0, ty0, tx1, ty1;
+  if (!roiTiles(tiles[0].size(), tiles.size(), tx0, ty0, tx1, ty1))
+  {
+    return false;
+  }
+  grid.resize(ty1 - ty0);
+  for (int y = ty0; y < ty1; ++y)
+  {
+    grid[y - ty0].assign(tiles[y].begin() + tx0, tiles[y].begin() + tx1);
+  }
+  // There is no map to apply updates to
+  parsed_map_info_ = nav_msgs::MapMetaData();
+  maskRoi(grid);
+  return startTile(grid, realStart, scaledStart);
+}
+
+bool FullCoveragePathPlanner::loadMapFile(std::string const& map_file, float robotRadius, float toolRadius)
+{
+  MapMetadata metadata;
+  if (!readMapMetadata(map_file, metadata))
+  {
+    return false;
+  }
+  if (metadata.origin_yaw != 0.0)
+  {
+    ROS_ERROR("%s is rotated (origin yaw %f), only maps aligned with their frame can be tiled", map_file.c_str(),
+              metadata.origin_yaw);
+    return false;
+  }
+  // The resolution of a map from map_server is a float, and so is the one that parseGrid scales the footprint with
+  TileFootprint footprint = tileFootprint(robotRadius, toolRadius, static_cast<float>(metadata.resolution));
+  if (!loadTileGrid(map_file, footprint, file_metadata_, file_tiles_))
+  {
+    file_tiles_.clear();
+    return false;
+  }
+  file_footprint_ = footprint;
+  ROS_INFO("Loaded %s: %lu x %lu tiles", map_file.c_str(), file_tiles_.empty() ? 0 : file_tiles_[0].size(),
+           file_tiles_.size());
+  return true;
+}
+
+bool FullCoveragePathPlanner::startTile(std::vector<std::vector<bool> > const& grid,
+                                        geometry_msgs::PoseStamped const& realStart, Point_t& scaledStart)
+{
+  int nTileRows = grid.size(), nTileCols = grid[0].size();
   // Scale starting point
   scaledStart.x = static_cast<unsigned int>(clamp((realStart.pose.position.x - grid_origin_.x) / tile_size_, 0.0,
-                             floor(cpp_grid_.info.width / tile_size_)));
+                             nTileCols - 1));
   scaledStart.y = static_cast<unsigned int>(clamp((realStart.pose.position.y - grid_origin_.y) / tile_size_, 0.0,
-                             floor(cpp_grid_.info.height / tile_size_)));
+                             nTileRows - 1));
 
-  // Scale grid
-  for (iy = 0; iy < nRows; iy = iy + nodeSize)
+  // When the robot starts outside of the region of interest, start covering at the closest tile inside it
+  if (!roi_.empty() && grid[scaledStart.y][scaledStart.x])
   {
-    std::vector<bool> gridRow;
-    for (ix = 0; ix < nCols; ix = ix + nodeSize)
+    std::list<Point_t> freeTiles = map_2_goals(grid, eNodeOpen);
+    if (freeTiles.empty())
     {
-      bool nodeOccupied = false;
-      for (nodeRow = 0; (nodeRow < robotNodeSize) && ((iy + nodeRow) < nRows) && (nodeOccupied == false); ++nodeRow)
+      ROS_ERROR("Region of interest contains no accessible tiles");
+      return false;
+    }
+    scaledStart = *std::min_element(freeTiles.begin(), freeTiles.end(), ComparatorForPointSort(scaledStart));
+    ROS_INFO("Start is outside of the region of interest, start covering at (%d, %d)", scaledStart.x, scaledStart.y);
+  }
+  return true;
+}
+
+bool FullCoveragePathPlanner::planningGrid(const geometry_msgs::PoseStamped& start,
+                                           std::vector<std::vector<bool> >& grid, Point_t& startPoint)
+{
+  std::lock_guard<std::mutex> lock(map_mutex_);
+  if (!map_file_.empty())
+  {
+    // The map file is loaded once, straight into the tiles of the whole map. Every plan crops those
+    if (file_tiles_.empty() && !loadMapFile(map_file_, robot_radius_ * 2, tool_radius_ * 2))
+    {
+      ROS_ERROR("Could not load map file %s", map_file_.c_str());
+      return false;
+    }
+    return parseTileGrid(file_metadata_, file_footprint_, file_tiles_, start, grid, startPoint);
+  }
+  if (map_updates_ && grid_valid_)
+  {
+    // The grid was parsed for an earlier plan and every map update since has been applied to it. The grid origin and
+    // tile size can have been changed by an atlas plan in between
+    tile_size_ = parsed_footprint_.node_size * parsed_map_info_.resolution;
+    grid_origin_.x = parsed_map_info_.origin.position.x + parsed_tile_origin_.x * tile_size_;
+    grid_origin_.y = parsed_map_info_.origin.position.y + parsed_tile_origin_.y * tile_size_;
+    ROS_INFO("Reusing the grid of the previous plan, kept up to date by map updates");
+    if (!startTile(grid_, start, startPoint))
+    {
+      return false;
+    }
+  }
+  else
+  {
+    if (!has_map_)
+    {
+      nav_msgs::GetMap grid_req_srv;
+      ROS_INFO("Requesting grid!!");
+      if (!cpp_grid_client_.call(grid_req_srv))
       {
-        for (nodeColl = 0; (nodeColl < robotNodeSize) && ((ix + nodeColl) < nCols); ++nodeColl)
-        {
-          int index_grid = dmax((iy + nodeRow - ceil(static_cast<float>(robotNodeSize - nodeSize) / 2.0))
-                            * nCols + (ix + nodeColl - ceil(static_cast<float>(robotNodeSize - nodeSize) / 2.0)), 0);
-          if (cpp_grid_.data[index_grid] > 65)
-          {
-            nodeOccupied = true;
-            break;
-          }
-        }
+        ROS_ERROR("Could not retrieve grid from map_server");
+        return false;
       }
-      gridRow.push_back(nodeOccupied);
+      cpp_grid_.info = grid_req_srv.response.map.info;
+      cpp_grid_.data.swap(grid_req_srv.response.map.data);
+      has_map_ = map_updates_;
+    }
+    grid_valid_ = false;
+    if (!parseGrid(cpp_grid_, grid_, robot_radius_ * 2, tool_radius_ * 2, start, startPoint))
+    {
+      ROS_ERROR("Could not parse retrieved grid");
+      return false;
+    }
+    grid_valid_ = map_updates_;
+  }
+  if (request_recorder_.isOpen())
+  {
+    recordRequest(cpp_grid_, start);
+  }
+  if (!map_updates_)
+  {
+    // The map is only kept to apply map updates to
+    std::vector<int8_t>().swap(cpp_grid_.data);
+  }
+  grid = grid_;
+  return true;
+}
+
+void FullCoveragePathPlanner::setMap(nav_msgs::OccupancyGrid const& map)
+{
+  std::lock_guard<std::mutex> lock(map_mutex_);
+  cpp_grid_ = map;
+  has_map_ = true;
+  grid_valid_ = false;
+}
+
+bool FullCoveragePathPlanner::applyMapUpdate(map_msgs::OccupancyGridUpdate const& update, std::vector<Point_t>& changed)
+{
+  std::lock_guard<std::mutex> lock(map_mutex_);
+  changed.clear();
+  if (!has_map_)
+  {
+    return false;
+  }
+  nav_msgs::MapMetaData const& info = cpp_grid_.info;
+  if (update.x < 0 || update.y < 0 || update.x + update.width > info.width || update.y + update.height > info.height ||
+      update.data.size() < static_cast<size_t>(update.width) * update.height)
+  {
+    ROS_WARN("Map update [%d, %d) x [%d, %d) does not fit in the map, getting the whole map for the next plan", update.x,
+             update.x + update.width, update.y, update.y + update.height);
+    has_map_ = false;
+    grid_valid_ = false;
+    return false;
+  }
+  for (uint32_t y = 0; y < update.height; ++y)
+  {
+    std::copy(update.data.begin() + static_cast<size_t>(y) * update.width,
+              update.data.begin() + static_cast<size_t>(y + 1) * update.width,
+              cpp_grid_.data.begin() + static_cast<size_t>(update.y + y) * info.width + update.x);
+  }
+  if (!grid_valid_)
+  {
+    return false;  // Parsed at the next plan, with this update
+  }
+  if (!updateGrid(cpp_grid_, update.x, update.y, update.x + update.width, update.y + update.height, grid_, changed))
+  {
+    grid_valid_ = false;
+    return false;
+  }
+
+  if (changed_tiles_pub_ && !changed.empty())
+  {
+    full_coverage_path_planner::ChangedTiles msg;
+    msg.header = update.header;
+    msg.tile_size = parsed_footprint_.node_size * parsed_map_info_.resolution;
+    msg.origin_x = parsed_map_info_.origin.position.x + parsed_tile_origin_.x * msg.tile_size;
+    msg.origin_y = parsed_map_info_.origin.position.y + parsed_tile_origin_.y * msg.tile_size;
+    for (std::vector<Point_t>::const_iterator it = changed.begin(); it != changed.end(); ++it)
+    {
+      msg.x.push_back(it->x);
+      msg.y.push_back(it->y);
+      msg.blocked.push_back(grid_[it->y][it->x]);
     }
-    grid.push_back(gridRow);
+    changed_tiles_pub_.publish(msg);
   }
   return true;
 }
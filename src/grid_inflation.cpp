@@ -0,0 +1,335 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <full_coverage_path_planner/grid_inflation.h>
+
+namespace full_coverage_path_planner
+{
+namespace
+{
+const float kDistanceInfinity = 1e20f;
+
+inline int clampWindow(int value, int lower, int upper)
+{
+  return std::min(std::max(value, lower), upper);
+}
+
+/**
+ * Division rounding towards minus infinity, also for negative numerators
+ */
+inline int floorDiv(int numerator, int denominator)
+{
+  return numerator >= 0 ? numerator / denominator : -((-numerator + denominator - 1) / denominator);
+}
+
+/**
+ * One dimensional squared distance transform of sampled function f (lower envelope of parabolas)
+ * @param f input samples, 0 on obstacles and kDistanceInfinity elsewhere
+ * @param n number of samples
+ * @param d output squared distances
+ * @param v scratch: locations of the parabolas in the lower envelope, size n
+ * @param z scratch: boundaries between the parabolas, size n + 1
+ */
+void distanceTransform1D(float const* f, int n, float* d, int* v, float* z)
+{
+  int k = 0;
+  v[0] = 0;
+  z[0] = -kDistanceInfinity;
+  z[1] = kDistanceInfinity;
+  for (int q = 1; q < n; ++q)
+  {
+    float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+    while (s <= z[k])
+    {
+      --k;
+      s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+    }
+    ++k;
+    v[k] = q;
+    z[k] = s;
+    z[k + 1] = kDistanceInfinity;
+  }
+
+  k = 0;
+  for (int q = 0; q < n; ++q)
+  {
+    while (z[k + 1] < q)
+    {
+      ++k;
+    }
+    d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+  }
+}
+
+/**
+ * Offset of the square footprint window w.r.t. the tile, such that the footprint is centered on the tile
+ */
+inline int squareOffset(TileFootprint const& footprint)
+{
+  int size = std::max(footprint.footprint_size, 1);
+  return static_cast<int>(std::ceil(static_cast<float>(size - footprint.node_size) / 2.0f));
+}
+
+/**
+ * Radius used by the circular models and the margin of map cells around a tile center that it reaches
+ */
+inline float clearanceRadius(TileFootprint const& footprint, int& margin)
+{
+  // A tile whose center cell is an obstacle must always be blocked, also for tiny radii
+  float radius = std::max(footprint.radius, 0.5f);
+  margin = static_cast<int>(std::ceil(radius)) + 1;
+  return radius;
+}
+
+/**
+ * Map cells [c0, c1) read by the tiles [t0, t1) along one axis of a map of the given number of cells
+ */
+void cellWindow(TileFootprint const& footprint, int cells, int t0, int t1, int& c0, int& c1)
+{
+  int n = footprint.node_size;
+  if (footprint.model == eFootprintSquare)
+  {
+    int offset = squareOffset(footprint);
+    c0 = t0 * n - offset;
+    c1 = (t1 - 1) * n - offset + std::max(footprint.footprint_size, 1);
+  }
+  else
+  {
+    // Obstacles further away than the radius from all tile centers do not matter. The centers of partial tiles at
+    // the border are clamped to the last cell
+    int margin;
+    clearanceRadius(footprint, margin);
+    c0 = std::min(t0 * n + n / 2, cells - 1) - margin;
+    c1 = std::min((t1 - 1) * n + n / 2, cells - 1) + margin + 1;
+  }
+  c0 = clampWindow(c0, 0, cells);
+  c1 = clampWindow(c1, c0, cells);
+}
+
+/**
+ * Mark tiles blocked when the square footprint window around them contains an obstacle.
+ * A summed-area table of obstacle counts makes every window test O(1)
+ * @param data_y0 map row of the first row of data
+ */
+void inflateSquare(int8_t const* data, int data_y0, int width, int height, TileFootprint const& footprint,
+                   int tx0, int ty0, int tx1, int ty1, std::vector<std::vector<bool> >& grid,
+                   int grid_x0, int grid_y0)
+{
+  int n = footprint.node_size;
+  int size = std::max(footprint.footprint_size, 1);
+  int offset = squareOffset(footprint);
+
+  // Map cells touched by the windows of the requested tiles
+  int cx0, cy0, cx1, cy1;
+  cellWindow(footprint, width, tx0, tx1, cx0, cx1);
+  cellWindow(footprint, height, ty0, ty1, cy0, cy1);
+  int w = cx1 - cx0;
+  int h = cy1 - cy0;
+
+  // sat[(y + 1) * (w + 1) + (x + 1)] holds the number of obstacles in [cx0, cx0 + x] x [cy0, cy0 + y]
+  std::vector<uint32_t> sat((w + 1) * (h + 1), 0);
+  for (int y = 0; y < h; ++y)
+  {
+    uint32_t row_sum = 0;
+    int8_t const* row = data + (cy0 - data_y0 + y) * width + cx0;
+    for (int x = 0; x < w; ++x)
+    {
+      row_sum += row[x] > kOccupiedThreshold;
+      sat[(y + 1) * (w + 1) + (x + 1)] = sat[y * (w + 1) + (x + 1)] + row_sum;
+    }
+  }
+
+  for (int ty = ty0; ty < ty1; ++ty)
+  {
+    int y0 = clampWindow(ty * n - offset, cy0, cy1) - cy0;
+    int y1 = clampWindow(ty * n - offset + size, cy0, cy1) - cy0;
+    for (int tx = tx0; tx < tx1; ++tx)
+    {
+      int x0 = clampWindow(tx * n - offset, cx0, cx1) - cx0;
+      int x1 = clampWindow(tx * n - offset + size, cx0, cx1) - cx0;
+      uint32_t count = sat[y1 * (w + 1) + x1] - sat[y0 * (w + 1) + x1]
+                       - sat[y1 * (w + 1) + x0] + sat[y0 * (w + 1) + x0];
+      grid[ty - grid_y0][tx - grid_x0] = count > 0;
+    }
+  }
+}
+
+/**
+ * Mark tiles blocked when the clearance at their center is smaller than the footprint radius
+ * @param data_y0 map row of the first row of data
+ */
+void inflateRadius(int8_t const* data, int data_y0, int width, int height, TileFootprint const& footprint,
+                   int tx0, int ty0, int tx1, int ty1, std::vector<std::vector<bool> >& grid,
+                   int grid_x0, int grid_y0)
+{
+  int n = footprint.node_size;
+  int margin;
+  float radius = clearanceRadius(footprint, margin);
+
+  // Only the window within reach of the tile centers is transformed
+  int cx0, cy0, cx1, cy1;
+  cellWindow(footprint, width, tx0, tx1, cx0, cx1);
+  cellWindow(footprint, height, ty0, ty1, cy0, cy1);
+  int w = cx1 - cx0;
+  int h = cy1 - cy0;
+
+  std::vector<uint8_t> obstacles(w * h);
+  for (int y = 0; y < h; ++y)
+  {
+    int8_t const* row = data + (cy0 - data_y0 + y) * width + cx0;
+    for (int x = 0; x < w; ++x)
+    {
+      obstacles[y * w + x] = row[x] > kOccupiedThreshold;
+    }
+  }
+  std::vector<float> dist2;
+  distanceTransform(obstacles, w, h, dist2);
+
+  float radius2 = radius * radius;
+  for (int ty = ty0; ty < ty1; ++ty)
+  {
+    int cy = std::min(ty * n + n / 2, height - 1) - cy0;
+    for (int tx = tx0; tx < tx1; ++tx)
+    {
+      int cx = std::min(tx * n + n / 2, width - 1) - cx0;
+      grid[ty - grid_y0][tx - grid_x0] = dist2[cy * w + cx] < radius2;
+    }
+  }
+}
+}  // namespace
+
+void distanceTransform(std::vector<uint8_t> const& obstacles, int width, int height, std::vector<float>& dist2)
+{
+  dist2.resize(width * height);
+  if (width <= 0 || height <= 0)
+  {
+    return;
+  }
+
+  int n = std::max(width, height);
+  std::vector<float> f(n), d(n), z(n + 1);
+  std::vector<int> v(n);
+
+  // Transform along the columns
+  for (int x = 0; x < width; ++x)
+  {
+    for (int y = 0; y < height; ++y)
+    {
+      f[y] = obstacles[y * width + x] ? 0.0f : kDistanceInfinity;
+    }
+    distanceTransform1D(&f[0], height, &d[0], &v[0], &z[0]);
+    for (int y = 0; y < height; ++y)
+    {
+      dist2[y * width + x] = d[y];
+    }
+  }
+
+  // And along the rows, on the result of the column pass
+  for (int y = 0; y < height; ++y)
+  {
+    float* row = &dist2[y * width];
+    std::copy(row, row + width, f.begin());
+    distanceTransform1D(&f[0], width, row, &v[0], &z[0]);
+  }
+}
+
+void inflateTiles(int8_t const* data, int width, int height, TileFootprint const& footprint,
+                  int tx0, int ty0, int tx1, int ty1, std::vector<std::vector<bool> >& grid,
+                  int grid_x0, int grid_y0)
+{
+  inflateTileBand(data, 0, width, height, footprint, tx0, ty0, tx1, ty1, grid, grid_x0, grid_y0);
+}
+
+void tileCellRows(int height, TileFootprint const& footprint, int ty0, int ty1, int& cy0, int& cy1)
+{
+  cellWindow(footprint, height, ty0, ty1, cy0, cy1);
+}
+
+void inflateTileBand(int8_t const* band, int band_y0, int width, int height, TileFootprint const& footprint,
+                     int tx0, int ty0, int tx1, int ty1, std::vector<std::vector<bool> >& grid,
+                     int grid_x0, int grid_y0)
+{
+  if (tx0 >= tx1 || ty0 >= ty1 || width <= 0 || height <= 0)
+  {
+    return;
+  }
+
+  if (footprint.model == eFootprintSquare)
+  {
+    inflateSquare(band, band_y0, width, height, footprint, tx0, ty0, tx1, ty1, grid, grid_x0, grid_y0);
+  }
+  else
+  {
+    inflateRadius(band, band_y0, width, height, footprint, tx0, ty0, tx1, ty1, grid, grid_x0, grid_y0);
+  }
+}
+
+void dirtyTileWindow(int width, int height, TileFootprint const& footprint, int cx0, int cy0, int cx1, int cy1,
+                     int& tx0, int& ty0, int& tx1, int& ty1)
+{
+  int n = footprint.node_size;
+  // Cells that reach a tile: tile t reads cells [t * n + low, t * n + high)
+  int low, high;
+  if (footprint.model == eFootprintSquare)
+  {
+    int size = std::max(footprint.footprint_size, 1);
+    low = -static_cast<int>(std::ceil(static_cast<float>(size - n) / 2.0f));
+    high = low + size;
+  }
+  else
+  {
+    int margin = static_cast<int>(std::ceil(std::max(footprint.radius, 0.5f)));
+    low = n / 2 - margin;
+    high = n / 2 + margin + 1;
+  }
+  // t * n + low < c1 and t * n + high > c0, with a tile of slack for the clamped centers at the map border
+  tx0 = clampWindow(floorDiv(cx0 - high, n), 0, tileCount(width, n));
+  ty0 = clampWindow(floorDiv(cy0 - high, n), 0, tileCount(height, n));
+  tx1 = clampWindow(floorDiv(cx1 - 1 - low, n) + 2, tx0, tileCount(width, n));
+  ty1 = clampWindow(floorDiv(cy1 - 1 - low, n) + 2, ty0, tileCount(height, n));
+}
+
+void updateTiles(int8_t const* data, int width, int height, TileFootprint const& footprint,
+                 int cx0, int cy0, int cx1, int cy1, std::vector<std::vector<bool> >& grid, int grid_x0, int grid_y0,
+                 std::vector<std::vector<bool> > const* blocked, std::vector<Point_t>& changed)
+{
+  changed.clear();
+  if (grid.empty() || cx0 >= cx1 || cy0 >= cy1)
+  {
+    return;
+  }
+  int tx0, ty0, tx1, ty1;
+  dirtyTileWindow(width, height, footprint, cx0, cy0, cx1, cy1, tx0, ty0, tx1, ty1);
+  // Only the tiles of the grid
+  tx0 = std::max(tx0, grid_x0);
+  ty0 = std::max(ty0, grid_y0);
+  tx1 = std::min(tx1, grid_x0 + static_cast<int>(grid[0].size()));
+  ty1 = std::min(ty1, grid_y0 + static_cast<int>(grid.size()));
+  if (tx0 >= tx1 || ty0 >= ty1)
+  {
+    return;
+  }
+
+  // Recompute the window into a scratch grid, then merge it and collect the differences
+  std::vector<std::vector<bool> > window(ty1 - ty0, std::vector<bool>(tx1 - tx0, false));
+  inflateTiles(data, width, height, footprint, tx0, ty0, tx1, ty1, window, tx0, ty0);
+  for (int ty = ty0; ty < ty1; ++ty)
+  {
+    std::vector<bool>& row = grid[ty - grid_y0];
+    for (int tx = tx0; tx < tx1; ++tx)
+    {
+      Point_t tile = { tx - grid_x0, ty - grid_y0 };
+      bool state = window[ty - ty0][tx - tx0] || (blocked && (*blocked)[tile.y][tile.x]);
+      if (row[tile.x] != state)
+      {
+        row[tile.x] = state;
+        changed.push_back(tile);
+      }
+    }
+  }
+}
+}  // namespace full_coverage_path_planner
@@ -0,0 +1,219 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <algorithm>
+#include <vector>
+
+#include <full_coverage_path_planner/interval_grid.h>
+
+namespace full_coverage_path_planner
+{
+namespace
+{
+/**
+ * Same order as sort_gridNodePath_heuristic_desc, for paths given as the index of their last node
+ */
+struct CompareLastNodeHeuristicDesc
+{
+  explicit CompareLastNodeHeuristicDesc(std::vector<gridNode_t> const& nodes) : nodes_(nodes)
+  {
+  }
+
+  bool operator()(int first, int second) const
+  {
+    return nodes_[first].he > nodes_[second].he;
+  }
+
+  std::vector<gridNode_t> const& nodes_;
+};
+
+bool compareStart(int x, FreeInterval const& interval)
+{
+  return x < interval.start;
+}
+}  // namespace
+
+IntervalGrid::IntervalGrid() : width_(0), height_(0), free_count_(0), row_begin_(1, 0)
+{
+}
+
+IntervalGrid::IntervalGrid(std::vector<std::vector<bool> > const& grid) : width_(0), height_(0), free_count_(0)
+{
+  assign(grid);
+}
+
+void IntervalGrid::assign(std::vector<std::vector<bool> > const& grid)
+{
+  height_ = grid.size();
+  width_ = grid.empty() ? 0 : grid[0].size();
+  free_count_ = 0;
+  row_begin_.resize(height_ + 1);
+  intervals_.clear();
+  for (int y = 0; y < height_; ++y)
+  {
+    row_begin_[y] = intervals_.size();
+    std::vector<bool> const& row = grid[y];
+    int x = 0;
+    while (x < width_)
+    {
+      // Skip to the next free tile, then to the end of its run
+      x = std::find(row.begin() + x, row.end(), eNodeOpen) - row.begin();
+      if (x >= width_)
+      {
+        break;
+      }
+      FreeInterval interval = { x, 0, free_count_ };
+      x = std::find(row.begin() + x, row.end(), eNodeVisited) - row.begin();
+      interval.end = x;
+      free_count_ += interval.end - interval.start;
+      intervals_.push_back(interval);
+    }
+  }
+  row_begin_[height_] = intervals_.size();
+}
+
+void IntervalGrid::toGrid(std::vector<std::vector<bool> >& grid) const
+{
+  grid.assign(height_, std::vector<bool>(width_, eNodeVisited));
+  for (int y = 0; y < height_; ++y)
+  {
+    for (FreeInterval const* it = rowBegin(y); it != rowEnd(y); ++it)
+    {
+      std::fill(grid[y].begin() + it->start, grid[y].begin() + it->end, eNodeOpen);
+    }
+  }
+}
+
+int IntervalGrid::index(int x, int y) const
+{
+  if (y < 0 || y >= height_)
+  {
+    return -1;
+  }
+  // The run holding x is the last one starting at or before x
+  FreeInterval const* it = std::upper_bound(rowBegin(y), rowEnd(y), x, compareStart);
+  if (it == rowBegin(y) || x >= (it - 1)->end)
+  {
+    return -1;
+  }
+  --it;
+  return it->offset + x - it->start;
+}
+
+void map_2_goals(IntervalGrid const& grid, std::vector<bool> const& visited, std::vector<Point_t>& goals)
+{
+  goals.clear();
+  goals.reserve(grid.freeCount());
+  for (int y = 0; y < grid.height(); ++y)
+  {
+    for (FreeInterval const* it = grid.rowBegin(y); it != grid.rowEnd(y); ++it)
+    {
+      for (int x = it->start; x < it->end; ++x)
+      {
+        if (!visited[it->offset + x - it->start])
+        {
+          Point_t p = { x, y };  // x, y
+          goals.push_back(p);
+        }
+      }
+    }
+  }
+}
+
+bool a_star_to_open_space(IntervalGrid const& grid, gridNode_t init, int cost, std::vector<bool> const& visited,
+                          std::vector<Point_t> const& open_space, AStarWorkspace& workspace,
+                          std::vector<gridNode_t>& pathNodes)
+{
+  int dx, dy, dx_prev;
+  size_t nFree = grid.freeCount();
+
+  // Same bookkeeping as the dense version, over the free tiles only
+  if (workspace.closed.size() != nFree || ++workspace.generation == 0)
+  {
+    workspace.closed.assign(nFree, 0);
+    workspace.generation = 1;
+    workspace.nodes.reserve(nFree + 1);
+    workspace.parents.reserve(nFree + 1);
+    workspace.open.reserve(nFree + 1);
+    workspace.trace.reserve(nFree + 1);
+  }
+  std::vector<gridNode_t>& nodes = workspace.nodes;
+  std::vector<int>& parents = workspace.parents;
+  std::vector<int>& open = workspace.open;
+  nodes.assign(1, init);
+  parents.assign(1, -1);
+  open.assign(1, 0);
+  int init_index = grid.index(init.pos.x, init.pos.y);
+  if (init_index >= 0)
+  {
+    workspace.closed[init_index] = workspace.generation;
+  }
+
+  while (!open.empty())
+  {
+    std::sort(open.begin(), open.end(), CompareLastNodeHeuristicDesc(nodes));
+    int last = open.back();
+    open.pop_back();
+    gridNode_t const end = nodes[last];
+    ++workspace.expansions;
+
+    int end_index = grid.index(end.pos.x, end.pos.y);
+    if (end_index >= 0 && visited[end_index] == eNodeOpen)
+    {
+      workspace.trace.clear();
+      for (int node = last; node >= 0; node = parents[node])
+      {
+        workspace.trace.push_back(nodes[node]);
+      }
+      pathNodes.insert(pathNodes.end(), workspace.trace.rbegin(), workspace.trace.rend());
+      return false;  // We do not resign, we found a path
+    }
+
+    if (parents[last] >= 0)
+    {
+      // Start looking around counter-clockwise of the direction the path arrived in
+      dx = end.pos.x - nodes[parents[last]].pos.x;
+      dy = end.pos.y - nodes[parents[last]].pos.y;
+      dx_prev = dx;
+      dx = -dy;
+      dy = dx_prev;
+    }
+    else
+    {
+      dx = 0;
+      dy = 1;
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+      Point_t p2 = { end.pos.x + dx, end.pos.y + dy };
+      int p2_index = grid.index(p2.x, p2.y);
+      if (p2_index >= 0 && workspace.closed[p2_index] != workspace.generation)
+      {
+        gridNode_t new_node =
+        {
+          p2,                                                          // Point: x,y
+          cost + end.cost,                                             // Cost
+          cost + end.cost + distanceToClosestPoint(p2, open_space) + i,  // Heuristic (+i so CCW turns are cheaper)
+        };
+        workspace.closed[p2_index] = workspace.generation;
+        nodes.push_back(new_node);
+        parents.push_back(last);
+        open.push_back(nodes.size() - 1);
+      }
+      // Cycle around to next neighbor, CCW
+      dx_prev = dx;
+      dx = dy;
+      dy = -dx_prev;
+    }
+  }
+
+  // No open paths left, there's no place to go and we must resign
+  if (!pathNodes.empty())
+  {
+    pathNodes.erase(pathNodes.begin(), pathNodes.end() - 1);
+  }
+  pathNodes.push_back(init);
+  return true;
+}
+}  // namespace full_coverage_path_planner
@@ -0,0 +1,386 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <png.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <full_coverage_path_planner/map_loader.h>
+
+namespace full_coverage_path_planner
+{
+namespace
+{
+std::string trim(std::string const& s)
+{
+  size_t begin = s.find_first_not_of(" \t\r\"'");
+  size_t end = s.find_last_not_of(" \t\r\"'");
+  return begin == std::string::npos ? std::string() : s.substr(begin, end - begin + 1);
+}
+
+/**
+ * Decodes a PNG or binary PGM (P5) image one row at a time, top row first, so that only a row of the image is in
+ * memory. Every pixel is the average of its color channels, alpha excluded
+ */
+class ImageRows
+{
+public:
+  ImageRows() : file_(NULL), png_(NULL), info_(NULL), width_(0), height_(0), channels_(0), max_value_(255), row_(0)
+  {
+  }
+
+  ~ImageRows()
+  {
+    png_destroy_read_struct(png_ ? &png_ : NULL, info_ ? &info_ : NULL, NULL);
+    if (file_)
+    {
+      fclose(file_);
+    }
+  }
+
+  bool open(std::string const& file)
+  {
+    std::string extension = file.substr(file.rfind('.') + 1);
+    return extension == "pgm" || extension == "PGM" ? openPgm(file) : openPng(file);
+  }
+
+  int width() const
+  {
+    return width_;
+  }
+
+  int height() const
+  {
+    return height_;
+  }
+
+  /**
+   * Decode the next row
+   * @param pixels output, width() values
+   */
+  bool next(uint8_t* pixels)
+  {
+    if (row_ >= height_)
+    {
+      return false;
+    }
+    uint8_t const* samples = NULL;
+    if (png_ && !image_.empty())
+    {
+      samples = &image_[static_cast<size_t>(row_) * width_ * channels_];
+    }
+    else if (png_)
+    {
+      if (!readPngRow())
+      {
+        return false;
+      }
+      samples = buffer_.data();
+    }
+    else
+    {
+      in_.read(reinterpret_cast<char*>(pixels), width_);
+      if (in_.gcount() != width_)
+      {
+        return false;
+      }
+      if (max_value_ != 255)
+      {
+        for (int x = 0; x < width_; ++x)
+        {
+          pixels[x] = pixels[x] * 255 / max_value_;
+        }
+      }
+    }
+    // Gray (and alpha) or RGB (and alpha)
+    for (int x = 0; samples && x < width_; ++x)
+    {
+      uint8_t const* pixel = samples + x * channels_;
+      pixels[x] = channels_ < 3 ? pixel[0] : (pixel[0] + pixel[1] + pixel[2]) / 3;
+    }
+    ++row_;
+    return true;
+  }
+
+private:
+  bool openPgm(std::string const& file)
+  {
+    in_.open(file.c_str(), std::ios::binary);
+    std::string magic;
+    in_ >> magic;
+    // Skip comments between the header fields
+    int* fields[] = { &width_, &height_, &max_value_ };
+    for (int i = 0; i < 3 && in_; ++i)
+    {
+      in_ >> std::ws;
+      while (in_.peek() == '#')
+      {
+        std::string comment;
+        std::getline(in_, comment);
+        in_ >> std::ws;
+      }
+      in_ >> *fields[i];
+    }
+    if (!in_ || magic != "P5" || width_ <= 0 || height_ <= 0 || max_value_ <= 0 || max_value_ > 255)
+    {
+      return false;
+    }
+    in_.get();  // Single whitespace before the data
+    return true;
+  }
+
+  /**
+   * libpng reports errors by a longjmp, so the functions that call it have no locals with destructors
+   */
+  bool openPng(std::string const& file)
+  {
+    file_ = fopen(file.c_str(), "rb");
+    png_ = file_ ? png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL) : NULL;
+    info_ = png_ ? png_create_info_struct(png_) : NULL;
+    if (!info_ || setjmp(png_jmpbuf(png_)))
+    {
+      return false;
+    }
+    png_init_io(png_, file_);
+    png_read_info(png_, info_);
+    png_set_expand(png_);  // Palettes to RGB and gray of less than 8 bits to 8 bits
+#ifdef PNG_READ_SCALE_16_TO_8_SUPPORTED
+    png_set_scale_16(png_);
+#else
+    png_set_strip_16(png_);
+#endif
+    int passes = png_set_interlace_handling(png_);
+    png_read_update_info(png_, info_);
+    width_ = png_get_image_width(png_, info_);
+    height_ = png_get_image_height(png_, info_);
+    channels_ = png_get_channels(png_, info_);
+    buffer_.resize(png_get_rowbytes(png_, info_));
+    if (passes > 1)
+    {
+      // Interlaced images are only complete after the last pass, so those are decoded as a whole
+      image_.resize(buffer_.size() * height_);
+      rows_.resize(height_);
+      for (int y = 0; y < height_; ++y)
+      {
+        rows_[y] = &image_[y * buffer_.size()];
+      }
+      png_read_image(png_, rows_.data());
+    }
+    return width_ > 0 && height_ > 0;
+  }
+
+  bool readPngRow()
+  {
+    if (setjmp(png_jmpbuf(png_)))
+    {
+      return false;
+    }
+    png_read_row(png_, buffer_.data(), NULL);
+    return true;
+  }
+
+  FILE* file_;
+  png_structp png_;
+  png_infop info_;
+  std::ifstream in_;
+  int width_;
+  int height_;
+  int channels_;
+  int max_value_;
+  int row_;                      ///< Next row to decode
+  std::vector<uint8_t> buffer_;  ///< Decoded samples of a PNG row
+  std::vector<uint8_t> image_;   ///< Whole decoded image, only for interlaced PNGs
+  std::vector<png_bytep> rows_;
+};
+
+/**
+ * Occupancy value of a pixel like map_server in trinary mode
+ */
+int8_t occupancyValue(MapMetadata const& metadata, uint8_t pixel)
+{
+  double occupancy = metadata.negate ? pixel / 255.0 : (255 - pixel) / 255.0;
+  if (occupancy > metadata.occupied_thresh)
+  {
+    return 100;
+  }
+  if (occupancy < metadata.free_thresh)
+  {
+    return 0;
+  }
+  return -1;
+}
+}  // namespace
+
+bool readMapMetadata(std::string const& yaml_file, MapMetadata& metadata)
+{
+  std::ifstream in(yaml_file.c_str());
+  if (!in)
+  {
+    return false;
+  }
+  metadata.image.clear();
+  metadata.resolution = 0.0;
+  metadata.origin_x = metadata.origin_y = metadata.origin_yaw = 0.0;
+  metadata.negate = false;
+  metadata.occupied_thresh = 0.65;
+  metadata.free_thresh = 0.196;
+
+  // The map_server format is flat "key: value", so a full yaml parser is not needed
+  std::string line;
+  while (std::getline(in, line))
+  {
+    line = line.substr(0, line.find('#'));
+    size_t colon = line.find(':');
+    if (colon == std::string::npos)
+    {
+      continue;
+    }
+    std::string key = trim(line.substr(0, colon)), value = trim(line.substr(colon + 1));
+    if (key == "image")
+    {
+      metadata.image = value;
+    }
+    else if (key == "resolution")
+    {
+      metadata.resolution = atof(value.c_str());
+    }
+    else if (key == "origin")
+    {
+      for (size_t i = 0; i < value.size(); ++i)
+      {
+        if (value[i] == '[' || value[i] == ']' || value[i] == ',')
+        {
+          value[i] = ' ';
+        }
+      }
+      std::istringstream origin(value);
+      origin >> metadata.origin_x >> metadata.origin_y >> metadata.origin_yaw;
+    }
+    else if (key == "negate")
+    {
+      metadata.negate = atoi(value.c_str()) != 0 || value == "true";
+    }
+    else if (key == "occupied_thresh")
+    {
+      metadata.occupied_thresh = atof(value.c_str());
+    }
+    else if (key == "free_thresh")
+    {
+      metadata.free_thresh = atof(value.c_str());
+    }
+  }
+
+  if (metadata.image.empty() || metadata.resolution <= 0.0)
+  {
+    return false;
+  }
+  if (metadata.image[0] != '/')
+  {
+    size_t slash = yaml_file.rfind('/');
+    if (slash != std::string::npos)
+    {
+      metadata.image = yaml_file.substr(0, slash + 1) + metadata.image;
+    }
+  }
+  return true;
+}
+
+bool loadMap(std::string const& yaml_file, nav_msgs::OccupancyGrid& map)
+{
+  MapMetadata metadata;
+  ImageRows image;
+  if (!readMapMetadata(yaml_file, metadata) || metadata.origin_yaw != 0.0 || !image.open(metadata.image))
+  {
+    return false;
+  }
+
+  int width = image.width(), height = image.height();
+  map.info.resolution = metadata.resolution;
+  map.info.width = width;
+  map.info.height = height;
+  map.info.origin.position.x = metadata.origin_x;
+  map.info.origin.position.y = metadata.origin_y;
+  map.info.origin.orientation.w = 1.0;
+  map.data.resize(static_cast<size_t>(width) * height);
+  std::vector<uint8_t> pixels(width);
+  for (int y = height - 1; y >= 0; --y)
+  {
+    // Images are stored top row first, maps bottom row first
+    if (!image.next(pixels.data()))
+    {
+      return false;
+    }
+    for (int x = 0; x < width; ++x)
+    {
+      map.data[static_cast<size_t>(y) * width + x] = occupancyValue(metadata, pixels[x]);
+    }
+  }
+  return true;
+}
+
+bool loadTileGrid(std::string const& yaml_file, TileFootprint const& footprint, MapMetadata& metadata,
+                  std::vector<std::vector<bool> >& grid, int* band_rows)
+{
+  ImageRows image;
+  if (!readMapMetadata(yaml_file, metadata) || metadata.origin_yaw != 0.0 || footprint.node_size <= 0 ||
+      !image.open(metadata.image))
+  {
+    return false;
+  }
+
+  int width = image.width(), height = image.height();
+  int tile_columns = tileCount(width, footprint.node_size), tile_rows = tileCount(height, footprint.node_size);
+  grid.assign(tile_rows, std::vector<bool>(tile_columns, false));
+
+  // Ring buffer of the last decoded map rows, enough for the footprint window of a tile row. Every row is stored
+  // twice, at slot and slot + capacity, so that the rows of any window are contiguous
+  int capacity = 1;
+  for (int ty = 0; ty < tile_rows; ++ty)
+  {
+    int cy0, cy1;
+    tileCellRows(height, footprint, ty, ty + 1, cy0, cy1);
+    capacity = std::max(capacity, cy1 - cy0);
+  }
+  if (band_rows)
+  {
+    *band_rows = capacity;
+  }
+  std::vector<int8_t> band(2 * static_cast<size_t>(capacity) * width);
+  std::vector<uint8_t> pixels(width);
+
+  // Images are stored top row first, so the map is decoded from its last row down and so are the tile rows
+  int ty = tile_rows - 1;
+  for (int y = height - 1; y >= 0; --y)
+  {
+    if (!image.next(pixels.data()))
+    {
+      return false;
+    }
+    int8_t* row = &band[static_cast<size_t>(y % capacity) * width];
+    for (int x = 0; x < width; ++x)
+    {
+      row[x] = occupancyValue(metadata, pixels[x]);
+    }
+    std::copy(row, row + width, row + static_cast<size_t>(capacity) * width);
+
+    // A tile row is complete once the lowest map row it reads is decoded, which is then the first row of the band
+    for (; ty >= 0; --ty)
+    {
+      int cy0, cy1;
+      tileCellRows(height, footprint, ty, ty + 1, cy0, cy1);
+      if (cy0 < y)
+      {
+        break;
+      }
+      inflateTileBand(row, y, width, height, footprint, 0, ty, tile_columns, ty + 1, grid);
+    }
+  }
+  return true;
+}
+}  // namespace full_coverage_path_planner
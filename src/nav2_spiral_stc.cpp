@@ -0,0 +1,261 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <cfloat>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <nav2_costmap_2d/cost_values.hpp>
+#include <nav2_util/node_utils.hpp>
+#include <pluginlib/class_list_macros.hpp>
+#include <tf2/utils.h>
+
+#include "full_coverage_path_planner/nav2_spiral_stc.h"
+#include "full_coverage_path_planner/tile_walk.h"
+
+// register this planner as a Nav2 GlobalPlanner plugin
+PLUGINLIB_EXPORT_CLASS(full_coverage_path_planner::Nav2SpiralSTC, nav2_core::GlobalPlanner)
+
+namespace full_coverage_path_planner
+{
+namespace
+{
+geometry_msgs::msg::Quaternion quaternionFromYaw(double yaw)
+{
+  geometry_msgs::msg::Quaternion q;
+  q.z = std::sin(0.5 * yaw);
+  q.w = std::cos(0.5 * yaw);
+  return q;
+}
+}  // namespace
+
+Nav2SpiralSTC::Nav2SpiralSTC()
+  : logger_(rclcpp::get_logger("Nav2SpiralSTC")), robot_radius_(0.5), tool_radius_(0.5),
+    footprint_model_(eFootprintSquare), contour_engine_(false), sparse_grid_(false)
+{
+  geometry_.tile_size = 0.0;
+  geometry_.origin_x = 0.0;
+  geometry_.origin_y = 0.0;
+  geometry_.columns = 0;
+  geometry_.rows = 0;
+  join_params_.style = eJoinNone;
+  join_params_.turn_radius = 0.0;
+  join_params_.u_turn_width = 0.0;
+  join_params_.spacing = 0.1;
+  join_params_.v_depth = 1.0;
+  join_params_.v_bottom_off_center = 0.0;
+}
+
+void Nav2SpiralSTC::configure(const rclcpp_lifecycle::LifecycleNode::WeakPtr& parent, std::string name,
+                              std::shared_ptr<tf2_ros::Buffer> /*tf*/,
+                              std::shared_ptr<nav2_costmap_2d::Costmap2DROS> costmap_ros)
+{
+  auto node = parent.lock();
+  logger_ = node->get_logger();
+  clock_ = node->get_clock();
+  name_ = name;
+  costmap_ros_ = costmap_ros;
+
+  // Same parameters as the ROS 1 plugin, in the namespace of the plugin
+  nav2_util::declare_parameter_if_not_declared(node, name_ + ".robot_radius", rclcpp::ParameterValue(0.5));
+  nav2_util::declare_parameter_if_not_declared(node, name_ + ".tool_radius", rclcpp::ParameterValue(0.5));
+  nav2_util::declare_parameter_if_not_declared(node, name_ + ".footprint_model", rclcpp::ParameterValue("square"));
+  nav2_util::declare_parameter_if_not_declared(node, name_ + ".coverage_engine",
+                                               rclcpp::ParameterValue("spiral_stc"));
+  nav2_util::declare_parameter_if_not_declared(node, name_ + ".sparse_grid", rclcpp::ParameterValue(false));
+  nav2_util::declare_parameter_if_not_declared(node, name_ + ".join_style", rclcpp::ParameterValue("none"));
+  nav2_util::declare_parameter_if_not_declared(node, name_ + ".join_radius", rclcpp::ParameterValue(-1.0));
+  nav2_util::declare_parameter_if_not_declared(node, name_ + ".join_spacing", rclcpp::ParameterValue(0.1));
+  nav2_util::declare_parameter_if_not_declared(node, name_ + ".join_v_depth", rclcpp::ParameterValue(1.0));
+  nav2_util::declare_parameter_if_not_declared(node, name_ + ".map_topic", rclcpp::ParameterValue(""));
+
+  std::string footprint_model, coverage_engine, join_style, map_topic;
+  node->get_parameter(name_ + ".robot_radius", robot_radius_);
+  node->get_parameter(name_ + ".tool_radius", tool_radius_);
+  node->get_parameter(name_ + ".footprint_model", footprint_model);
+  node->get_parameter(name_ + ".coverage_engine", coverage_engine);
+  node->get_parameter(name_ + ".sparse_grid", sparse_grid_);
+  node->get_parameter(name_ + ".join_style", join_style);
+  node->get_parameter(name_ + ".join_radius", join_params_.turn_radius);
+  node->get_parameter(name_ + ".join_spacing", join_params_.spacing);
+  node->get_parameter(name_ + ".join_v_depth", join_params_.v_depth);
+  node->get_parameter(name_ + ".map_topic", map_topic);
+
+  if (footprint_model != "square" && footprint_model != "circle")
+  {
+    RCLCPP_WARN(logger_, "Unknown footprint_model %s, using square", footprint_model.c_str());
+  }
+  footprint_model_ = footprint_model == "circle" ? eFootprintCircle : eFootprintSquare;
+  if (coverage_engine != "spiral_stc" && coverage_engine != "contour")
+  {
+    RCLCPP_WARN(logger_, "Unknown coverage_engine %s, using spiral_stc", coverage_engine.c_str());
+  }
+  contour_engine_ = coverage_engine == "contour";
+  if (join_style != "none" && join_style != "half_circle" && join_style != "mwm")
+  {
+    RCLCPP_WARN(logger_, "Unknown join_style %s, using none", join_style.c_str());
+  }
+  join_params_.style = join_style == "half_circle" ? eJoinHalfCircle : join_style == "mwm" ? eJoinMwm : eJoinNone;
+  if (join_params_.turn_radius < 0.0)
+  {
+    join_params_.turn_radius = tool_radius_;
+  }
+
+  // The plan goes out as a unique pointer, so intra-process subscribers take it over without a copy
+  plan_pub_ = node->create_publisher<nav_msgs::msg::Path>(name_ + "/coverage_plan", 1);
+
+  // Intra-process subscriptions do not support a transient local durability (yet), the map is only received once
+  // anyway. Its callback keeps the shared pointer, so it is not copied either
+  if (!map_topic.empty())
+  {
+    rclcpp::SubscriptionOptions options;
+    options.use_intra_process_comm = rclcpp::IntraProcessSetting::Disable;
+    map_sub_ = node->create_subscription<nav_msgs::msg::OccupancyGrid>(
+        map_topic, rclcpp::QoS(1).transient_local().reliable(),
+        std::bind(&Nav2SpiralSTC::mapCallback, this, std::placeholders::_1), options);
+  }
+  RCLCPP_INFO(logger_, "Configured %s: %s engine on %s", name_.c_str(), coverage_engine.c_str(),
+              map_topic.empty() ? "the global costmap" : map_topic.c_str());
+}
+
+void Nav2SpiralSTC::cleanup()
+{
+  map_sub_.reset();
+  map_.reset();
+  plan_pub_.reset();
+}
+
+void Nav2SpiralSTC::activate()
+{
+  plan_pub_->on_activate();
+}
+
+void Nav2SpiralSTC::deactivate()
+{
+  plan_pub_->on_deactivate();
+}
+
+void Nav2SpiralSTC::mapCallback(nav_msgs::msg::OccupancyGrid::ConstSharedPtr map)
+{
+  map_ = map;
+}
+
+nav_msgs::msg::Path Nav2SpiralSTC::createPlan(const geometry_msgs::msg::PoseStamped& start,
+                                              const geometry_msgs::msg::PoseStamped& /*goal*/)
+{
+  auto plan = std::make_unique<nav_msgs::msg::Path>();
+  plan->header.frame_id = costmap_ros_->getGlobalFrameID();
+  plan->header.stamp = clock_->now();
+
+  // Tile grid from the map of map_topic, or from the lethal cells of the costmap
+  bool parsed;
+  if (map_sub_)
+  {
+    nav_msgs::msg::OccupancyGrid::ConstSharedPtr map = map_;
+    if (!map)
+    {
+      RCLCPP_ERROR(logger_, "No map received yet");
+      return *plan;
+    }
+    parsed = map->data.size() >= static_cast<size_t>(map->info.width) * map->info.height &&
+             parseGrid(map->data.data(), map->info.width, map->info.height, map->info.resolution,
+                       map->info.origin.position.x, map->info.origin.position.y);
+  }
+  else
+  {
+    // Only the copy holds the lock, so the costmap can update while the copy is tiled
+    nav2_costmap_2d::Costmap2D* costmap = costmap_ros_->getCostmap();
+    int width, height;
+    double resolution, origin_x, origin_y;
+    {
+      std::unique_lock<nav2_costmap_2d::Costmap2D::mutex_t> lock(*(costmap->getMutex()));
+      width = costmap->getSizeInCellsX();
+      height = costmap->getSizeInCellsY();
+      resolution = costmap->getResolution();
+      origin_x = costmap->getOriginX();
+      origin_y = costmap->getOriginY();
+      costsToOccupancy(costmap->getCharMap(), static_cast<size_t>(width) * height, nav2_costmap_2d::LETHAL_OBSTACLE,
+                       occupancy_);
+    }
+    parsed = parseGrid(occupancy_.data(), width, height, resolution, origin_x, origin_y);
+  }
+  if (!parsed)
+  {
+    RCLCPP_ERROR(logger_, "Could not parse the map");
+    return *plan;
+  }
+  Point_t scaled_start = worldToTile(geometry_, start.pose.position.x, start.pose.position.y);
+
+  int multiple_pass_counter, visited_counter;
+  if (contour_engine_)
+  {
+    contourCoverage(grid_, scaled_start, contour_workspace_, walk_, multiple_pass_counter, visited_counter);
+  }
+  else if (sparse_grid_)
+  {
+    interval_grid_.assign(grid_);
+    spiralCoverage(interval_grid_, scaled_start, interval_workspace_, walk_, multiple_pass_counter, visited_counter);
+  }
+  else
+  {
+    spiralCoverage(grid_, scaled_start, spiral_workspace_, walk_, multiple_pass_counter, visited_counter);
+  }
+  RCLCPP_INFO(logger_, "Covered %d tiles with %d re-visits", visited_counter - multiple_pass_counter,
+              multiple_pass_counter);
+
+  // Same poses as FullCoveragePathPlanner::parsePointlist2Plan: the start pose, a translation to the first tile and
+  // the corners of the walk
+  Waypoint start_waypoint = { start.pose.position.x, start.pose.position.y, tf2::getYaw(start.pose.orientation) };
+  waypoints_.assign(1, start_waypoint);
+  tileWalkToWaypoints(walk_.begin(), walk_.end(), geometry_.tile_size, geometry_.origin_x, geometry_.origin_y,
+                      waypoints_);
+  double dx = waypoints_[1].x - start_waypoint.x, dy = waypoints_[1].y - start_waypoint.y;
+  if (!(std::fabs(dy) < 100.0 * FLT_EPSILON && std::fabs(dx) < 100.0 * FLT_EPSILON))
+  {
+    Waypoint first = waypoints_[1];
+    first.yaw = std::atan2(dy, dx);
+    start_waypoint.yaw = first.yaw;
+    waypoints_.insert(waypoints_.begin() + 1, first);
+    waypoints_.insert(waypoints_.begin() + 1, start_waypoint);
+  }
+  if (join_params_.style != eJoinNone)
+  {
+    // Strokes are one tile apart
+    join_params_.u_turn_width = geometry_.tile_size;
+    waypoints_ = smoothStrokeJoins(waypoints_, join_params_);
+  }
+
+  plan->poses.resize(waypoints_.size());
+  plan->poses[0] = start;
+  plan->poses[0].header = plan->header;
+  for (size_t i = 1; i < waypoints_.size(); ++i)
+  {
+    geometry_msgs::msg::PoseStamped& pose = plan->poses[i];
+    pose.header = plan->header;
+    pose.pose.position.x = waypoints_[i].x;
+    pose.pose.position.y = waypoints_[i].y;
+    pose.pose.orientation = quaternionFromYaw(waypoints_[i].yaw);
+  }
+  RCLCPP_INFO(logger_, "Plan ready containing %zu poses", plan->poses.size());
+
+  // The planner server needs its own copy, the subscribers of coverage_plan share the published one
+  nav_msgs::msg::Path result = *plan;
+  if (plan_pub_->is_activated() &&
+      plan_pub_->get_subscription_count() + plan_pub_->get_intra_process_subscription_count() > 0)
+  {
+    plan_pub_->publish(std::move(plan));
+  }
+  return result;
+}
+
+bool Nav2SpiralSTC::parseGrid(int8_t const* data, int width, int height, double resolution, double origin_x,
+                              double origin_y)
+{
+  return occupancyToTiles(data, width, height, resolution, origin_x, origin_y, robot_radius_, tool_radius_,
+                          footprint_model_, geometry_, grid_);
+}
+}  // namespace full_coverage_path_planner
@@ -0,0 +1,120 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <full_coverage_path_planner/path_resampling.h>
+
+namespace full_coverage_path_planner
+{
+namespace
+{
+const double kPositionEpsilon = 1e-6;
+const double kYawEpsilon = 1e-3;
+
+inline void appendPose(PathProfile& profile, double x, double y, double yaw, double s)
+{
+  Waypoint w = { x, y, yaw };
+  profile.poses.push_back(w);
+  profile.arc_length.push_back(s);
+}
+}  // namespace
+
+void resamplePath(std::vector<Waypoint> const& path, ResamplingParams const& params, PathProfile& profile)
+{
+  profile.poses.clear();
+  profile.arc_length.clear();
+  profile.curvature.clear();
+  profile.max_velocity.clear();
+  if (path.empty())
+  {
+    return;
+  }
+
+  // Reserve all poses up front, so the resampling itself does not reallocate
+  double spacing = std::max(params.spacing, kPositionEpsilon);
+  size_t capacity = path.size();
+  for (size_t i = 1; i < path.size(); ++i)
+  {
+    capacity += std::ceil(std::hypot(path[i].x - path[i - 1].x, path[i].y - path[i - 1].y) / spacing);
+  }
+  profile.poses.reserve(capacity);
+  profile.arc_length.reserve(capacity);
+
+  // Resample: keep the corners, divide every segment in equal parts of at most the spacing
+  double s = 0.0;
+  appendPose(profile, path[0].x, path[0].y, path[0].yaw, s);
+  for (size_t i = 1; i < path.size(); ++i)
+  {
+    double dx = path[i].x - path[i - 1].x;
+    double dy = path[i].y - path[i - 1].y;
+    double length = std::hypot(dx, dy);
+    if (length < kPositionEpsilon)
+    {
+      // Turn on the spot
+      if (std::fabs(std::remainder(path[i].yaw - profile.poses.back().yaw, 2 * M_PI)) > kYawEpsilon)
+      {
+        appendPose(profile, path[i].x, path[i].y, path[i].yaw, s);
+      }
+      continue;
+    }
+
+    double yaw = std::atan2(dy, dx);
+    int parts = std::max(1, static_cast<int>(std::ceil(length / spacing)));
+    for (int k = 1; k <= parts; ++k)
+    {
+      double t = static_cast<double>(k) / parts;
+      appendPose(profile, path[i - 1].x + t * dx, path[i - 1].y + t * dy, yaw, s + t * length);
+    }
+    s += length;
+  }
+
+  // Curvature from the change in heading between the neighbouring poses and the speed it allows
+  size_t n = profile.poses.size();
+  profile.curvature.assign(n, 0.0);
+  profile.max_velocity.assign(n, params.max_velocity);
+  for (size_t i = 0; i < n; ++i)
+  {
+    size_t prev = i > 0 ? i - 1 : 0;
+    size_t next = i + 1 < n ? i + 1 : n - 1;
+    double dyaw = std::remainder(profile.poses[next].yaw - profile.poses[prev].yaw, 2 * M_PI);
+    double ds = profile.arc_length[next] - profile.arc_length[prev];
+    bool turn_on_spot = (i > 0 && profile.arc_length[i] - profile.arc_length[i - 1] < kPositionEpsilon) ||
+                        (i + 1 < n && profile.arc_length[i + 1] - profile.arc_length[i] < kPositionEpsilon);
+    if (turn_on_spot)
+    {
+      if (std::fabs(dyaw) > kYawEpsilon)
+      {
+        profile.curvature[i] = dyaw > 0 ? std::numeric_limits<double>::infinity()
+                                        : -std::numeric_limits<double>::infinity();
+      }
+      profile.max_velocity[i] = 0.0;
+    }
+    else if (ds > kPositionEpsilon && std::fabs(dyaw) > kPositionEpsilon)
+    {
+      profile.curvature[i] = dyaw / ds;
+      profile.max_velocity[i] = std::min(params.max_velocity,
+                                         std::sqrt(params.max_lateral_acceleration / std::fabs(profile.curvature[i])));
+    }
+  }
+
+  // Trapezoidal profile: start and end at standstill and respect the acceleration limit in between
+  profile.max_velocity[0] = 0.0;
+  profile.max_velocity[n - 1] = 0.0;
+  for (size_t i = 1; i < n; ++i)
+  {
+    double ds = profile.arc_length[i] - profile.arc_length[i - 1];
+    profile.max_velocity[i] = std::min(profile.max_velocity[i],
+        std::sqrt(profile.max_velocity[i - 1] * profile.max_velocity[i - 1] + 2 * params.max_acceleration * ds));
+  }
+  for (size_t i = n - 1; i > 0; --i)
+  {
+    double ds = profile.arc_length[i] - profile.arc_length[i - 1];
+    profile.max_velocity[i - 1] = std::min(profile.max_velocity[i - 1],
+        std::sqrt(profile.max_velocity[i] * profile.max_velocity[i] + 2 * params.max_acceleration * ds));
+  }
+}
+}  // namespace full_coverage_path_planner
@@ -0,0 +1,163 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <full_coverage_path_planner/perf_counters.h>
+
+namespace full_coverage_path_planner
+{
+namespace
+{
+int perfEventOpen(uint32_t type, uint64_t config, int group_fd)
+{
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = group_fd < 0;  // The leader starts the whole group once it is complete
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+}  // namespace
+
+char const* perfEventName(int event)
+{
+  static char const* names[ePerfEventCount] = { "cycles", "instructions", "l1d_misses", "llc_misses",
+                                                "branch_misses" };
+  return event >= 0 && event < ePerfEventCount ? names[event] : "";
+}
+
+PerfCounts noPerfCounts()
+{
+  PerfCounts counts;
+  for (int e = 0; e < ePerfEventCount; ++e)
+  {
+    counts.values[e] = -1;
+  }
+  return counts;
+}
+
+PerfCounts perfDifference(PerfCounts const& a, PerfCounts const& b)
+{
+  PerfCounts difference;
+  for (int e = 0; e < ePerfEventCount; ++e)
+  {
+    difference.values[e] = a.values[e] < 0 || b.values[e] < 0 ? -1 : b.values[e] - a.values[e];
+  }
+  return difference;
+}
+
+void perfAccumulate(PerfCounts& a, PerfCounts const& b)
+{
+  for (int e = 0; e < ePerfEventCount; ++e)
+  {
+    if (b.values[e] >= 0)
+    {
+      a.values[e] = (a.values[e] < 0 ? 0 : a.values[e]) + b.values[e];
+    }
+  }
+}
+
+PerfCounters::PerfCounters() : event_count_(0)
+{
+  for (int e = 0; e < ePerfEventCount; ++e)
+  {
+    fds_[e] = -1;
+    slots_[e] = -1;
+  }
+}
+
+PerfCounters::~PerfCounters()
+{
+  close();
+}
+
+bool PerfCounters::open()
+{
+  close();
+  static const uint32_t types[ePerfEventCount] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+                                                   PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE };
+  static const uint64_t configs[ePerfEventCount] =
+  {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+  };
+  for (int e = 0; e < ePerfEventCount; ++e)
+  {
+    fds_[e] = perfEventOpen(types[e], configs[e], fds_[ePerfCycles]);
+    if (fds_[e] < 0 && e == ePerfCycles)
+    {
+      return false;  // Without the leader there is no group
+    }
+    if (fds_[e] >= 0)
+    {
+      slots_[e] = event_count_++;
+    }
+  }
+  if (ioctl(fds_[ePerfCycles], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) != 0)
+  {
+    int error = errno;
+    close();
+    errno = error;
+    return false;
+  }
+  return true;
+}
+
+void PerfCounters::close()
+{
+  // Members before the leader, the leader last
+  for (int e = ePerfEventCount - 1; e >= 0; --e)
+  {
+    if (fds_[e] >= 0)
+    {
+      ::close(fds_[e]);
+    }
+    fds_[e] = -1;
+    slots_[e] = -1;
+  }
+  event_count_ = 0;
+}
+
+bool PerfCounters::read(PerfCounts& counts) const
+{
+  counts = noPerfCounts();
+  if (!isOpen())
+  {
+    return false;
+  }
+  // nr, time_enabled, time_running, then a value per event of the group
+  uint64_t data[3 + ePerfEventCount];
+  ssize_t size = ::read(fds_[ePerfCycles], data, sizeof(data));
+  if (size < static_cast<ssize_t>((3 + event_count_) * sizeof(uint64_t)) ||
+      data[0] != static_cast<uint64_t>(event_count_))
+  {
+    return false;
+  }
+  if (data[2] == 0)
+  {
+    return false;  // The group was never scheduled on the PMU, e.g. because other groups use all of its counters
+  }
+  double scale = static_cast<double>(data[1]) / data[2];
+  for (int e = 0; e < ePerfEventCount; ++e)
+  {
+    if (slots_[e] >= 0)
+    {
+      counts.values[e] = static_cast<int64_t>(data[3 + slots_[e]] * scale + 0.5);
+    }
+  }
+  return true;
+}
+}  // namespace full_coverage_path_planner
@@ -0,0 +1,96 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <math.h>
+#include <stdlib.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <full_coverage_path_planner/plan_handoff.h>
+
+namespace full_coverage_path_planner
+{
+void mapPosesToTiles(std::vector<Waypoint> const& poses, std::vector<Point_t> const& tiles, double origin_x,
+                     double origin_y, double tile_size, std::vector<uint32_t>& pose_tiles)
+{
+  pose_tiles.assign(poses.size(), 0);
+  if (tiles.empty())
+  {
+    return;
+  }
+  size_t current = 0;
+  // Tiles the walk can have advanced since the last pose that was found on it
+  size_t steps = 0;
+  int previous_x = tiles[0].x, previous_y = tiles[0].y;
+  for (size_t i = 0; i < poses.size(); ++i)
+  {
+    int x = static_cast<int>(floor((poses[i].x - origin_x) / tile_size));
+    int y = static_cast<int>(floor((poses[i].y - origin_y) / tile_size));
+    // The walk takes a step per tile and consecutive poses are at most a straight stroke apart, so it advances at most
+    // as many tiles as the poses are apart (plus the tile that is repeated where an escape starts, or the tile a pose
+    // beside the walk is off). Poses beside the walk add up, the walk went on while they were not found
+    steps += abs(x - previous_x) + abs(y - previous_y) + 2;
+    previous_x = x;
+    previous_y = y;
+    for (size_t k = current; k < tiles.size() && k <= current + steps; ++k)
+    {
+      if (tiles[k].x == x && tiles[k].y == y)
+      {
+        current = k;
+        steps = 0;
+        break;
+      }
+    }
+    pose_tiles[i] = current;
+  }
+}
+
+PlanHandoff::PlanHandoff() : sequence_(0)
+{
+}
+
+std::shared_ptr<HandoffPlan> PlanHandoff::beginWrite()
+{
+  std::shared_ptr<HandoffPlan> plan;
+  plan.swap(previous_);
+  if (plan && plan.use_count() == 1)
+  {
+    // The last reader released it, make its reads happen before we overwrite the plan
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return plan;
+  }
+  return std::make_shared<HandoffPlan>();
+}
+
+void PlanHandoff::commit(std::shared_ptr<HandoffPlan> const& plan)
+{
+  plan->sequence = sequence_.load(std::memory_order_relaxed) + 1;
+  std::shared_ptr<HandoffPlan const> published = plan;
+  std::shared_ptr<HandoffPlan const> old = std::atomic_exchange(&current_, published);
+  sequence_.store(plan->sequence, std::memory_order_release);
+  previous_ = std::const_pointer_cast<HandoffPlan>(old);
+}
+
+std::shared_ptr<HandoffPlan const> PlanHandoff::latest() const
+{
+  return std::atomic_load(&current_);
+}
+
+PlanHandoff& planHandoff(std::string const& name)
+{
+  // Never destroyed: consumers may still use their handoff while the process exits
+  static std::mutex mutex;
+  static std::map<std::string, PlanHandoff*>* handoffs = new std::map<std::string, PlanHandoff*>;
+  std::lock_guard<std::mutex> lock(mutex);
+  PlanHandoff*& handoff = (*handoffs)[name];
+  if (handoff == NULL)
+  {
+    handoff = new PlanHandoff;
+  }
+  return *handoff;
+}
+}  // namespace full_coverage_path_planner
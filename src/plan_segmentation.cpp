@@ -0,0 +1,102 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <math.h>
+
+#include <vector>
+
+#include <full_coverage_path_planner/plan_segmentation.h>
+
+namespace full_coverage_path_planner
+{
+void PathCostTable::assign(std::vector<Point_t> const& path)
+{
+  size_t n = path.size();
+  length_.assign(n, 0.0);
+  turn_.assign(n, 0.0);
+  for (size_t i = 1; i < n; ++i)
+  {
+    int dx = path[i].x - path[i - 1].x, dy = path[i].y - path[i - 1].y;
+    length_[i] = length_[i - 1] + sqrt(static_cast<double>(dx * dx + dy * dy));
+    turn_[i] = turn_[i - 1];
+    if (i + 1 < n)
+    {
+      int dx2 = path[i + 1].x - path[i].x, dy2 = path[i + 1].y - path[i].y;
+      if ((dx != 0 || dy != 0) && (dx2 != 0 || dy2 != 0))
+      {
+        turn_[i] += fabs(atan2(static_cast<double>(dx * dy2 - dy * dx2), static_cast<double>(dx * dx2 + dy * dy2)));
+      }
+    }
+  }
+}
+
+void dockDistanceField(std::vector<std::vector<bool> > const& grid, Point_t const& dock, std::vector<int>& distance)
+{
+  int nRows = grid.size(), nCols = grid[0].size();
+  distance.assign(static_cast<size_t>(nRows) * nCols, -1);
+  if (dock.x < 0 || dock.x >= nCols || dock.y < 0 || dock.y >= nRows)
+  {
+    return;
+  }
+
+  // The distance field doubles as the visited set, the queue holds tile indices in order of distance
+  std::vector<int> queue;
+  queue.reserve(distance.size());
+  distance[dock.y * nCols + dock.x] = 0;
+  queue.push_back(dock.y * nCols + dock.x);
+  static const int dx[] = { 1, 0, -1, 0 };
+  static const int dy[] = { 0, 1, 0, -1 };
+  for (size_t head = 0; head < queue.size(); ++head)
+  {
+    int x = queue[head] % nCols, y = queue[head] / nCols;
+    for (int d = 0; d < 4; ++d)
+    {
+      int nx = x + dx[d], ny = y + dy[d];
+      if (nx >= 0 && nx < nCols && ny >= 0 && ny < nRows && grid[ny][nx] == eNodeOpen &&
+          distance[ny * nCols + nx] < 0)
+      {
+        distance[ny * nCols + nx] = distance[queue[head]] + 1;
+        queue.push_back(ny * nCols + nx);
+      }
+    }
+  }
+}
+
+bool segmentPath(std::vector<Point_t> const& path, PathCostTable const& table, std::vector<int> const& distance,
+                 int width, double tile_size, SegmentationParams const& params, std::vector<PlanSegment>& segments)
+{
+  segments.clear();
+  double tile_cost = tile_size * params.cost_per_meter;
+  size_t begin = 0;
+  int approach = 0;  // The robot is at the start of the first segment already
+  while (begin + 1 < path.size())
+  {
+    PlanSegment segment = { begin, begin, 0.0, approach, -1 };
+    double approach_cost = approach * tile_cost;
+    for (size_t end = begin + 1; end < path.size(); ++end)
+    {
+      double covered = approach_cost + table.length(begin, end) * tile_cost + table.turn(begin, end) *
+                       params.cost_per_radian;
+      if (covered > params.budget)
+      {
+        break;  // Further tiles only cost more before the way back is added
+      }
+      int retreat = distance[path[end].y * width + path[end].x];
+      if (retreat >= 0 && covered + retreat * tile_cost <= params.budget)
+      {
+        segment.end = end;
+        segment.cost = covered + retreat * tile_cost;
+        segment.retreat = retreat;
+      }
+    }
+    if (segment.end == begin)
+    {
+      return false;
+    }
+    segments.push_back(segment);
+    begin = segment.end;
+    approach = segment.retreat;
+  }
+  return true;
+}
+}  // namespace full_coverage_path_planner
@@ -0,0 +1,313 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <limits>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <full_coverage_path_planner/planning_atlas.h>
+
+namespace full_coverage_path_planner
+{
+namespace
+{
+inline uint64_t walkCount(uint64_t dock_count, uint64_t zone_count)
+{
+  return zone_count + dock_count * zone_count + zone_count * zone_count;
+}
+}  // namespace
+
+void shortestWalks(std::vector<std::vector<bool> > const& grid, Point_t source, std::vector<Point_t> const& targets,
+                   std::vector<std::list<Point_t> >& walks)
+{
+  walks.assign(targets.size(), std::list<Point_t>());
+  int nRows = grid.size();
+  int nCols = nRows > 0 ? grid[0].size() : 0;
+  if (source.x < 0 || source.x >= nCols || source.y < 0 || source.y >= nRows)
+  {
+    return;
+  }
+
+  // Breadth-first search, storing the index of the tile each tile was reached from
+  std::vector<int> parent(nRows * nCols, -1);
+  std::vector<int> queue;
+  queue.reserve(nRows * nCols);
+  int source_index = source.y * nCols + source.x;
+  parent[source_index] = source_index;
+  queue.push_back(source_index);
+  int const dx[] = { 1, 0, -1, 0 };
+  int const dy[] = { 0, 1, 0, -1 };
+  for (size_t head = 0; head < queue.size(); ++head)
+  {
+    int x = queue[head] % nCols, y = queue[head] / nCols;
+    for (int i = 0; i < 4; ++i)
+    {
+      int nx = x + dx[i], ny = y + dy[i];
+      if (nx >= 0 && nx < nCols && ny >= 0 && ny < nRows && !grid[ny][nx] && parent[ny * nCols + nx] < 0)
+      {
+        parent[ny * nCols + nx] = queue[head];
+        queue.push_back(ny * nCols + nx);
+      }
+    }
+  }
+
+  for (unsigned int t = 0; t < targets.size(); ++t)
+  {
+    Point_t target = targets[t];
+    if (target.x < 0 || target.x >= nCols || target.y < 0 || target.y >= nRows ||
+        parent[target.y * nCols + target.x] < 0)
+    {
+      continue;
+    }
+    for (int index = target.y * nCols + target.x; ; index = parent[index])
+    {
+      Point_t p = { index % nCols, index / nCols };
+      walks[t].push_front(p);
+      if (index == source_index)
+      {
+        break;
+      }
+    }
+  }
+}
+
+void connectAtlas(std::vector<std::vector<bool> > const& grid, AtlasContent& content)
+{
+  size_t nZones = content.zones.size();
+  std::vector<Point_t> entries(nZones);
+  for (unsigned int z = 0; z < nZones; ++z)
+  {
+    // Zones without a walk get an entry outside of the grid, so they are never connected
+    Point_t outside = { -1, -1 };
+    entries[z] = content.zones[z].empty() ? outside : content.zones[z].front();
+  }
+
+  content.dock_connectors.clear();
+  for (unsigned int d = 0; d < content.docks.size(); ++d)
+  {
+    std::vector<std::list<Point_t> > walks;
+    shortestWalks(grid, content.docks[d], entries, walks);
+    content.dock_connectors.insert(content.dock_connectors.end(), walks.begin(), walks.end());
+  }
+
+  content.zone_connectors.clear();
+  for (unsigned int z = 0; z < nZones; ++z)
+  {
+    std::vector<std::list<Point_t> > walks(nZones);
+    if (!content.zones[z].empty())
+    {
+      shortestWalks(grid, content.zones[z].back(), entries, walks);
+    }
+    content.zone_connectors.insert(content.zone_connectors.end(), walks.begin(), walks.end());
+  }
+}
+
+bool writeAtlas(std::string const& file, AtlasContent const& content)
+{
+  size_t nZones = content.zones.size();
+  if (content.dock_connectors.size() != content.docks.size() * nZones ||
+      content.zone_connectors.size() != nZones * nZones)
+  {
+    return false;
+  }
+
+  // All walks in the order of the file: zones, dock connectors, zone connectors
+  std::vector<std::list<Point_t> const*> walks;
+  for (unsigned int i = 0; i < nZones; ++i)
+  {
+    walks.push_back(&content.zones[i]);
+  }
+  for (unsigned int i = 0; i < content.dock_connectors.size(); ++i)
+  {
+    walks.push_back(&content.dock_connectors[i]);
+  }
+  for (unsigned int i = 0; i < content.zone_connectors.size(); ++i)
+  {
+    walks.push_back(&content.zone_connectors[i]);
+  }
+
+  AtlasFileHeader header;
+  header.magic = kAtlasMagic;
+  header.version = kAtlasVersion;
+  header.origin_x = content.origin_x;
+  header.origin_y = content.origin_y;
+  header.tile_size = content.tile_size;
+  header.width = content.width;
+  header.height = content.height;
+  header.dock_count = content.docks.size();
+  header.zone_count = nZones;
+  header.point_count = 0;
+  std::vector<AtlasWalkRecord> records(walks.size());
+  for (unsigned int i = 0; i < walks.size(); ++i)
+  {
+    records[i].offset = header.point_count;
+    records[i].length = walks[i]->size();
+    header.point_count += walks[i]->size();
+  }
+
+  std::ofstream out(file.c_str(), std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+  for (unsigned int i = 0; i < content.docks.size(); ++i)
+  {
+    AtlasTile tile = { content.docks[i].x, content.docks[i].y };
+    out.write(reinterpret_cast<char const*>(&tile), sizeof(tile));
+  }
+  out.write(reinterpret_cast<char const*>(records.data()), records.size() * sizeof(AtlasWalkRecord));
+  for (unsigned int i = 0; i < walks.size(); ++i)
+  {
+    for (std::list<Point_t>::const_iterator it = walks[i]->begin(); it != walks[i]->end(); ++it)
+    {
+      AtlasTile tile = { it->x, it->y };
+      out.write(reinterpret_cast<char const*>(&tile), sizeof(tile));
+    }
+  }
+  return out.good();
+}
+
+PlanningAtlas::PlanningAtlas() : base_(NULL), size_(0), header_(NULL), docks_(NULL), walks_(NULL), tiles_(NULL)
+{
+}
+
+PlanningAtlas::~PlanningAtlas()
+{
+  close();
+}
+
+bool PlanningAtlas::open(std::string const& file)
+{
+  close();
+  int fd = ::open(file.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(AtlasFileHeader))
+  {
+    ::close(fd);
+    return false;
+  }
+  void* base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (base == MAP_FAILED)
+  {
+    return false;
+  }
+
+  // Check the header and that all sections fit in the file before trusting any offset
+  AtlasFileHeader const* header = static_cast<AtlasFileHeader const*>(base);
+  uint64_t walk_count = walkCount(header->dock_count, header->zone_count);
+  uint64_t size = sizeof(AtlasFileHeader) + header->dock_count * sizeof(AtlasTile) +
+                  walk_count * sizeof(AtlasWalkRecord) + header->point_count * sizeof(AtlasTile);
+  bool valid = header->magic == kAtlasMagic && header->version == kAtlasVersion &&
+               header->point_count < std::numeric_limits<uint32_t>::max() && size == static_cast<size_t>(st.st_size);
+  char const* data = static_cast<char const*>(base) + sizeof(AtlasFileHeader);
+  AtlasTile const* docks = reinterpret_cast<AtlasTile const*>(data);
+  AtlasWalkRecord const* walks = reinterpret_cast<AtlasWalkRecord const*>(docks + (valid ? header->dock_count : 0));
+  for (uint64_t i = 0; valid && i < walk_count; ++i)
+  {
+    valid = walks[i].offset + walks[i].length <= header->point_count;
+  }
+  if (!valid)
+  {
+    munmap(base, st.st_size);
+    return false;
+  }
+
+  base_ = base;
+  size_ = st.st_size;
+  header_ = header;
+  docks_ = docks;
+  walks_ = walks;
+  tiles_ = reinterpret_cast<AtlasTile const*>(walks + walk_count);
+  return true;
+}
+
+void PlanningAtlas::close()
+{
+  if (base_ != NULL)
+  {
+    munmap(base_, size_);
+  }
+  base_ = NULL;
+  size_ = 0;
+  header_ = NULL;
+  docks_ = NULL;
+  walks_ = NULL;
+  tiles_ = NULL;
+}
+
+int PlanningAtlas::nearestDock(Point_t tile, int& distance_squared) const
+{
+  int nearest = -1;
+  for (uint32_t d = 0; header_ != NULL && d < header_->dock_count; ++d)
+  {
+    Point_t dock = { docks_[d].x, docks_[d].y };
+    int distance = distanceSquared(tile, dock);
+    if (nearest < 0 || distance < distance_squared)
+    {
+      nearest = d;
+      distance_squared = distance;
+    }
+  }
+  return nearest;
+}
+
+bool PlanningAtlas::assemble(int dock, std::vector<int> const& zones, std::list<Point_t>& walk) const
+{
+  walk.clear();
+  if (header_ == NULL || dock < 0 || dock >= static_cast<int>(header_->dock_count) || zones.empty())
+  {
+    return false;
+  }
+  uint64_t nZones = header_->zone_count;
+  for (unsigned int i = 0; i < zones.size(); ++i)
+  {
+    if (zones[i] < 0 || zones[i] >= static_cast<int>(nZones))
+    {
+      return false;
+    }
+  }
+
+  // Dock to the first zone, then every zone followed by the connector to the next one
+  if (!append(nZones + dock * nZones + zones[0], walk))
+  {
+    return false;
+  }
+  for (unsigned int i = 0; i < zones.size(); ++i)
+  {
+    if (!append(zones[i], walk))
+    {
+      return false;
+    }
+    if (i + 1 < zones.size() &&
+        !append(nZones + header_->dock_count * nZones + zones[i] * nZones + zones[i + 1], walk))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool PlanningAtlas::append(uint64_t index, std::list<Point_t>& walk) const
+{
+  AtlasWalkRecord const& record = walks_[index];
+  if (record.length == 0)
+  {
+    return false;
+  }
+  for (uint64_t i = walk.empty() ? 0 : 1; i < record.length; ++i)
+  {
+    Point_t p = { tiles_[record.offset + i].x, tiles_[record.offset + i].y };
+    walk.push_back(p);
+  }
+  return true;
+}
+}  // namespace full_coverage_path_planner
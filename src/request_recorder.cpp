@@ -0,0 +1,137 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <errno.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <full_coverage_path_planner/request_recorder.h>
+
+namespace full_coverage_path_planner
+{
+void packMap(nav_msgs::OccupancyGrid const& map, RecordedRequest& request)
+{
+  size_t cells = static_cast<size_t>(map.info.width) * map.info.height;
+  request.header.width = map.info.width;
+  request.header.height = map.info.height;
+  request.header.resolution = map.info.resolution;
+  request.header.origin_x = map.info.origin.position.x;
+  request.header.origin_y = map.info.origin.position.y;
+  request.obstacles.assign((cells + 7) / 8, 0);
+  for (size_t i = 0; i < cells && i < map.data.size(); ++i)
+  {
+    if (map.data[i] > kOccupiedThreshold)
+    {
+      request.obstacles[i / 8] |= 1 << (i % 8);
+    }
+  }
+}
+
+void unpackMap(RecordedRequest const& request, nav_msgs::OccupancyGrid& map)
+{
+  size_t cells = static_cast<size_t>(request.header.width) * request.header.height;
+  map.info.width = request.header.width;
+  map.info.height = request.header.height;
+  map.info.resolution = request.header.resolution;
+  map.info.origin.position.x = request.header.origin_x;
+  map.info.origin.position.y = request.header.origin_y;
+  map.info.origin.orientation.w = 1.0;
+  map.data.assign(cells, 0);
+  for (size_t i = 0; i < cells; ++i)
+  {
+    if (request.obstacles[i / 8] & (1 << (i % 8)))
+    {
+      map.data[i] = 100;
+    }
+  }
+}
+
+bool writeRequest(std::string const& file, RecordedRequest const& request)
+{
+  RecordedRequestHeader header = request.header;
+  header.magic = kRequestMagic;
+  header.version = kRequestVersion;
+  header.roi_count = request.roi.size();
+
+  std::ofstream out(file.c_str(), std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+  out.write(reinterpret_cast<char const*>(request.roi.data()), request.roi.size() * sizeof(fPoint_t));
+  out.write(reinterpret_cast<char const*>(request.obstacles.data()), request.obstacles.size());
+  return out.good();
+}
+
+bool readRequest(std::string const& file, RecordedRequest& request)
+{
+  std::ifstream in(file.c_str(), std::ios::binary);
+  in.read(reinterpret_cast<char*>(&request.header), sizeof(request.header));
+  if (!in || request.header.magic != kRequestMagic || request.header.version != kRequestVersion)
+  {
+    return false;
+  }
+  request.roi.resize(request.header.roi_count);
+  in.read(reinterpret_cast<char*>(request.roi.data()), request.roi.size() * sizeof(fPoint_t));
+  request.obstacles.resize((static_cast<size_t>(request.header.width) * request.header.height + 7) / 8);
+  in.read(reinterpret_cast<char*>(request.obstacles.data()), request.obstacles.size());
+  return static_cast<bool>(in);
+}
+
+RequestRecorder::RequestRecorder() : capacity_(0), sequence_(0)
+{
+}
+
+bool RequestRecorder::open(std::string const& directory, int capacity)
+{
+  capacity_ = 0;
+  if (capacity <= 0 || (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST))
+  {
+    return false;
+  }
+  directory_ = directory;
+  capacity_ = capacity;
+
+  // Continue after the last recorded request
+  sequence_ = 0;
+  for (int i = 0; i < capacity_; ++i)
+  {
+    RecordedRequestHeader header;
+    std::ifstream in(fileName(i).c_str(), std::ios::binary);
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (in && header.magic == kRequestMagic && header.version == kRequestVersion && header.sequence >= sequence_)
+    {
+      sequence_ = header.sequence + 1;
+    }
+  }
+  return true;
+}
+
+std::string RequestRecorder::record(RecordedRequest& request)
+{
+  if (!isOpen())
+  {
+    return std::string();
+  }
+  request.header.sequence = sequence_;
+  std::string file = fileName(sequence_ % capacity_);
+  std::string tmp = file + ".tmp";
+  if (!writeRequest(tmp, request) || rename(tmp.c_str(), file.c_str()) != 0)
+  {
+    remove(tmp.c_str());
+    return std::string();
+  }
+  ++sequence_;
+  return file;
+}
+
+std::string RequestRecorder::fileName(int index) const
+{
+  std::stringstream name;
+  name << directory_ << "/request_" << index << ".fcppreq";
+  return name.str();
+}
+}  // namespace full_coverage_path_planner
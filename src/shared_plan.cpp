@@ -0,0 +1,126 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <new>
+#include <string>
+
+#include <full_coverage_path_planner/shared_plan.h>
+
+namespace full_coverage_path_planner
+{
+SharedPlanWriter::SharedPlanWriter() : base_(NULL), size_(0)
+{
+}
+
+SharedPlanWriter::~SharedPlanWriter()
+{
+  close();
+}
+
+bool SharedPlanWriter::open(std::string const& name, uint32_t slot_count, uint32_t slot_capacity)
+{
+  close();
+  if (slot_count == 0)
+  {
+    errno = EINVAL;
+    return false;
+  }
+
+  // Start from a fresh segment, readers that still map an old one keep their (stale) copy
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd < 0)
+  {
+    return false;
+  }
+  size_t size = sharedPlanSize(slot_count, slot_capacity);
+  if (ftruncate(fd, size) != 0)
+  {
+    int error = errno;
+    ::close(fd);
+    shm_unlink(name.c_str());
+    errno = error;
+    return false;
+  }
+  void* base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (base == MAP_FAILED)
+  {
+    int error = errno;
+    shm_unlink(name.c_str());
+    errno = error;
+    return false;
+  }
+
+  SharedPlanHeader* header = new (base) SharedPlanHeader;
+  header->slot_count = slot_count;
+  header->slot_capacity = slot_capacity;
+  header->last_sequence.store(0);
+  for (uint32_t slot = 0; slot < slot_count; ++slot)
+  {
+    SharedPlanSlot* record = new (sharedPlanSlot(base, slot)) SharedPlanSlot;
+    record->sequence.store(0);
+    record->pose_count = 0;
+  }
+  header->version = kSharedPlanVersion;
+  std::atomic_thread_fence(std::memory_order_release);
+  header->magic = kSharedPlanMagic;  // Written last, readers reject a segment that is still being set up
+
+  name_ = name;
+  base_ = base;
+  size_ = size;
+  return true;
+}
+
+void SharedPlanWriter::close()
+{
+  if (base_ != NULL)
+  {
+    munmap(base_, size_);
+    shm_unlink(name_.c_str());
+  }
+  base_ = NULL;
+  size_ = 0;
+  name_.clear();
+}
+
+SharedPlanPose* SharedPlanWriter::beginWrite(uint32_t pose_count, SharedPlanSlotRef& ref)
+{
+  if (base_ == NULL)
+  {
+    return NULL;
+  }
+  SharedPlanHeader* header = static_cast<SharedPlanHeader*>(base_);
+  if (pose_count > header->slot_capacity)
+  {
+    return NULL;
+  }
+
+  ref.sequence = header->last_sequence.load(std::memory_order_relaxed) + 1;
+  ref.slot = ref.sequence % header->slot_count;
+  ref.pose_count = pose_count;
+
+  // Invalidate the slot before overwriting it
+  SharedPlanSlot* record = sharedPlanSlot(base_, ref.slot);
+  record->sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  record->pose_count = pose_count;
+  return sharedPlanPoses(base_, ref.slot);
+}
+
+void SharedPlanWriter::commit(SharedPlanSlotRef const& ref)
+{
+  if (base_ == NULL)
+  {
+    return;
+  }
+  SharedPlanHeader* header = static_cast<SharedPlanHeader*>(base_);
+  sharedPlanSlot(base_, ref.slot)->sequence.store(ref.sequence, std::memory_order_release);
+  header->last_sequence.store(ref.sequence, std::memory_order_release);
+}
+}  // namespace full_coverage_path_planner
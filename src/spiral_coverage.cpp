@@ -0,0 +1,310 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <vector>
+
+#include <full_coverage_path_planner/spiral_coverage.h>
+
+namespace full_coverage_path_planner
+{
+void spiralFill(std::vector<std::vector<bool> > const& grid, std::vector<gridNode_t>& pathNodes,
+                std::vector<std::vector<bool> >& visited)
+{
+  int dx, dy, dx_prev, x2, y2, nRows = grid.size(), nCols = grid[0].size();
+  // Like SpiralSTC::spiral: a direction is only known when the spiral does not start at the second node
+  bool has_direction = pathNodes.size() > 2;
+  gridNode_t prev = pathNodes[pathNodes.size() > 1 ? pathNodes.size() - 2 : 0];
+  bool done = false;
+  while (!done)
+  {
+    if (has_direction)
+    {
+      // turn ccw
+      dx = pathNodes.back().pos.x - prev.pos.x;
+      dy = pathNodes.back().pos.y - prev.pos.y;
+      dx_prev = dx;
+      dx = -dy;
+      dy = dx_prev;
+    }
+    else
+    {
+      // Initialize spiral direction towards y-axis
+      dx = 0;
+      dy = 1;
+    }
+    done = true;
+
+    for (int i = 0; i < 4; ++i)
+    {
+      x2 = pathNodes.back().pos.x + dx;
+      y2 = pathNodes.back().pos.y + dy;
+      if (x2 >= 0 && x2 < nCols && y2 >= 0 && y2 < nRows)
+      {
+        if (grid[y2][x2] == eNodeOpen && visited[y2][x2] == eNodeOpen)
+        {
+          gridNode_t new_node =
+          {
+            { x2, y2 },  // Point: x,y
+            0,           // Cost
+            0,           // Heuristic
+          };
+          prev = pathNodes.back();
+          pathNodes.push_back(new_node);
+          has_direction = true;
+          visited[y2][x2] = eNodeVisited;  // Close node
+          done = false;
+          break;
+        }
+      }
+      // try next direction cw
+      dx_prev = dx;
+      dx = dy;
+      dy = -dx_prev;
+    }
+  }
+}
+
+void spiralCoverage(std::vector<std::vector<bool> > const& grid, Point_t const& init, SpiralWorkspace& workspace,
+                    std::vector<Point_t>& fullPath, int& multiple_pass_counter, int& visited_counter)
+{
+  int nRows = grid.size(), nCols = grid[0].size();
+  multiple_pass_counter = 0;
+  visited_counter = 0;
+
+  // Copy the grid row by row, so the rows keep their storage
+  std::vector<std::vector<bool> >& visited = workspace.visited;
+  visited.resize(nRows);
+  for (int y = 0; y < nRows; ++y)
+  {
+    visited[y].assign(grid[y].begin(), grid[y].end());
+  }
+  std::vector<gridNode_t>& pathNodes = workspace.pathNodes;
+  pathNodes.clear();
+  pathNodes.reserve(2 * static_cast<size_t>(nRows) * nCols + 2);
+  fullPath.clear();
+  fullPath.reserve(static_cast<size_t>(nRows) * nCols);
+  workspace.a_star.expansions = 0;
+
+  gridNode_t new_node =
+  {
+    { init.x, init.y },  // Point: x,y
+    0,                   // Cost
+    0,                   // Heuristic
+  };
+  pathNodes.push_back(new_node);
+  visited[init.y][init.x] = eNodeVisited;
+
+  SnapshotSink* snapshots = workspace.snapshots && workspace.snapshots->enabled() ? workspace.snapshots : NULL;
+  if (snapshots)
+  {
+    snapshots->beginPlan();
+    snapshots->capture(eSnapshotStart, grid, visited, pathNodes, 0);
+  }
+
+  spiralFill(grid, pathNodes, visited);  // First spiral fill
+  map_2_goals(visited, eNodeOpen, workspace.goals);  // Retrieve remaining goalpoints
+  if (snapshots)
+  {
+    snapshots->capture(eSnapshotSpiral, grid, visited, pathNodes, workspace.goals.size());
+  }
+  for (std::vector<gridNode_t>::const_iterator it = pathNodes.begin(); it != pathNodes.end(); ++it)
+  {
+    visited_counter++;
+    fullPath.push_back(it->pos);
+  }
+
+  while (!workspace.goals.empty())
+  {
+    // Keep the last point only, A* extends the path from there on
+    pathNodes.erase(pathNodes.begin(), pathNodes.end() - 1);
+    visited_counter--;  // First point is already counted as visited
+    bool resign = a_star_to_open_space(grid, pathNodes.back(), 1, visited, workspace.goals, workspace.a_star,
+                                       pathNodes);
+    if (resign)
+    {
+      break;
+    }
+
+    // Update visited grid
+    for (std::vector<gridNode_t>::const_iterator it = pathNodes.begin(); it != pathNodes.end(); ++it)
+    {
+      if (visited[it->pos.y][it->pos.x])
+      {
+        multiple_pass_counter++;
+      }
+      visited[it->pos.y][it->pos.x] = eNodeVisited;
+    }
+    if (pathNodes.size() > 0)
+    {
+      multiple_pass_counter--;  // First point is already counted as visited
+    }
+    if (snapshots)
+    {
+      snapshots->capture(eSnapshotEscape, grid, visited, pathNodes, workspace.goals.size());
+    }
+
+    // Spiral fill from current position
+    spiralFill(grid, pathNodes, visited);
+    map_2_goals(visited, eNodeOpen, workspace.goals);  // Retrieve remaining goalpoints
+    if (snapshots)
+    {
+      snapshots->capture(eSnapshotSpiral, grid, visited, pathNodes, workspace.goals.size());
+    }
+    for (std::vector<gridNode_t>::const_iterator it = pathNodes.begin(); it != pathNodes.end(); ++it)
+    {
+      visited_counter++;
+      fullPath.push_back(it->pos);
+    }
+  }
+}
+
+void spiralFill(IntervalGrid const& grid, std::vector<gridNode_t>& pathNodes, std::vector<bool>& visited)
+{
+  int dx, dy, dx_prev, x2, y2;
+  bool has_direction = pathNodes.size() > 2;
+  gridNode_t prev = pathNodes[pathNodes.size() > 1 ? pathNodes.size() - 2 : 0];
+  bool done = false;
+  while (!done)
+  {
+    if (has_direction)
+    {
+      // turn ccw
+      dx = pathNodes.back().pos.x - prev.pos.x;
+      dy = pathNodes.back().pos.y - prev.pos.y;
+      dx_prev = dx;
+      dx = -dy;
+      dy = dx_prev;
+    }
+    else
+    {
+      // Initialize spiral direction towards y-axis
+      dx = 0;
+      dy = 1;
+    }
+    done = true;
+
+    for (int i = 0; i < 4; ++i)
+    {
+      x2 = pathNodes.back().pos.x + dx;
+      y2 = pathNodes.back().pos.y + dy;
+      int index = grid.index(x2, y2);
+      if (index >= 0 && visited[index] == eNodeOpen)
+      {
+        gridNode_t new_node =
+        {
+          { x2, y2 },  // Point: x,y
+          0,           // Cost
+          0,           // Heuristic
+        };
+        prev = pathNodes.back();
+        pathNodes.push_back(new_node);
+        has_direction = true;
+        visited[index] = eNodeVisited;  // Close node
+        done = false;
+        break;
+      }
+      // try next direction cw
+      dx_prev = dx;
+      dx = dy;
+      dy = -dx_prev;
+    }
+  }
+}
+
+void spiralCoverage(IntervalGrid const& grid, Point_t const& init, IntervalSpiralWorkspace& workspace,
+                    std::vector<Point_t>& fullPath, int& multiple_pass_counter, int& visited_counter)
+{
+  size_t nFree = grid.freeCount();
+  multiple_pass_counter = 0;
+  visited_counter = 0;
+
+  std::vector<bool>& visited = workspace.visited;
+  visited.assign(nFree, eNodeOpen);
+  std::vector<gridNode_t>& pathNodes = workspace.pathNodes;
+  pathNodes.clear();
+  pathNodes.reserve(2 * nFree + 2);
+  fullPath.clear();
+  fullPath.reserve(nFree + 1);
+  workspace.a_star.expansions = 0;
+
+  gridNode_t new_node =
+  {
+    { init.x, init.y },  // Point: x,y
+    0,                   // Cost
+    0,                   // Heuristic
+  };
+  pathNodes.push_back(new_node);
+  int index = grid.index(init.x, init.y);
+  if (index >= 0)
+  {
+    visited[index] = eNodeVisited;
+  }
+
+  SnapshotSink* snapshots = workspace.snapshots && workspace.snapshots->enabled() ? workspace.snapshots : NULL;
+  if (snapshots)
+  {
+    snapshots->beginPlan();
+    snapshots->capture(eSnapshotStart, grid, visited, pathNodes, 0);
+  }
+
+  spiralFill(grid, pathNodes, visited);  // First spiral fill
+  map_2_goals(grid, visited, workspace.goals);  // Retrieve remaining goalpoints
+  if (snapshots)
+  {
+    snapshots->capture(eSnapshotSpiral, grid, visited, pathNodes, workspace.goals.size());
+  }
+  for (std::vector<gridNode_t>::const_iterator it = pathNodes.begin(); it != pathNodes.end(); ++it)
+  {
+    visited_counter++;
+    fullPath.push_back(it->pos);
+  }
+
+  while (!workspace.goals.empty())
+  {
+    // Keep the last point only, A* extends the path from there on
+    pathNodes.erase(pathNodes.begin(), pathNodes.end() - 1);
+    visited_counter--;  // First point is already counted as visited
+    bool resign = a_star_to_open_space(grid, pathNodes.back(), 1, visited, workspace.goals, workspace.a_star,
+                                       pathNodes);
+    if (resign)
+    {
+      break;
+    }
+
+    // Update visited tiles, a blocked tile (only the start can be one) counts as visited
+    for (std::vector<gridNode_t>::const_iterator it = pathNodes.begin(); it != pathNodes.end(); ++it)
+    {
+      index = grid.index(it->pos.x, it->pos.y);
+      if (index < 0 || visited[index])
+      {
+        multiple_pass_counter++;
+      }
+      if (index >= 0)
+      {
+        visited[index] = eNodeVisited;
+      }
+    }
+    if (pathNodes.size() > 0)
+    {
+      multiple_pass_counter--;  // First point is already counted as visited
+    }
+    if (snapshots)
+    {
+      snapshots->capture(eSnapshotEscape, grid, visited, pathNodes, workspace.goals.size());
+    }
+
+    // Spiral fill from current position
+    spiralFill(grid, pathNodes, visited);
+    map_2_goals(grid, visited, workspace.goals);  // Retrieve remaining goalpoints
+    if (snapshots)
+    {
+      snapshots->capture(eSnapshotSpiral, grid, visited, pathNodes, workspace.goals.size());
+    }
+    for (std::vector<gridNode_t>::const_iterator it = pathNodes.begin(); it != pathNodes.end(); ++it)
+    {
+      visited_counter++;
+      fullPath.push_back(it->pos);
+    }
+  }
+}
+}  // namespace full_coverage_path_planner
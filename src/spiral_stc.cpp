@@ -1,6 +1,9 @@
 //
 // Copyright [2020] Nobleo Technology"  [legal/copyright]
 //
+#include <errno.h>
+#include <string.h>
+
 #include <algorithm>
 #include <iostream>
 #include <list>
@@ -33,10 +36,224 @@ void SpiralSTC::initialize(std::string name, costmap_2d::Costmap2DROS* costmap_r
     // Define  tool radius (radius) parameter
     float tool_radius_default = 0.5f;
     private_named_nh.param<float>("tool_radius", tool_radius_, tool_radius_default);
+    // Define how the robot footprint inflates the obstacles: square, circle, inscribed or circumscribed
+    std::string footprint_model;
+    private_named_nh.param<std::string>("footprint_model", footprint_model, "square");
+    if (footprint_model == "circle")
+    {
+      footprint_model_ = eFootprintCircle;
+    }
+    else if (footprint_model == "inscribed" || footprint_model == "circumscribed")
+    {
+      std::vector<geometry_msgs::Point> footprint;
+      if (costmap_ros)
+      {
+        footprint = costmap_ros->getRobotFootprint();
+      }
+      if (footprint.empty())
+      {
+        ROS_WARN("No costmap footprint available for footprint_model %s, using circle", footprint_model.c_str());
+        footprint_model_ = eFootprintCircle;
+      }
+      else
+      {
+        double min_dist, max_dist;
+        costmap_2d::calculateMinAndMaxDistances(footprint, min_dist, max_dist);
+        footprint_inscribed_radius_ = min_dist;
+        footprint_circumscribed_radius_ = max_dist;
+        footprint_model_ = footprint_model == "inscribed" ? eFootprintInscribed : eFootprintCircumscribed;
+      }
+    }
+    else
+    {
+      if (footprint_model != "square")
+      {
+        ROS_WARN("Unknown footprint_model %s, using square", footprint_model.c_str());
+      }
+      footprint_model_ = eFootprintSquare;
+    }
+    // Define the region of interest as a list of [x, y] points in the map frame
+    XmlRpc::XmlRpcValue roi;
+    if (private_named_nh.getParam("roi", roi) && !parsePolygon(roi, roi_))
+    {
+      ROS_ERROR("Parameter roi must be a list of at least 3 [x, y] points, covering the whole map instead");
+    }
+    // Define how the strokes of the plan are joined: none (stop and turn), half_circle or mwm
+    std::string join_style;
+    private_named_nh.param<std::string>("join_style", join_style, "none");
+    if (join_style == "half_circle")
+    {
+      join_params_.style = eJoinHalfCircle;
+    }
+    else if (join_style == "mwm")
+    {
+      join_params_.style = eJoinMwm;
+    }
+    else
+    {
+      if (join_style != "none")
+      {
+        ROS_WARN("Unknown join_style %s, using none", join_style.c_str());
+      }
+      join_params_.style = eJoinNone;
+    }
+    private_named_nh.param<double>("join_radius", join_params_.turn_radius, tool_radius_);
+    private_named_nh.param<double>("join_spacing", join_params_.spacing, 0.1);
+    private_named_nh.param<double>("join_v_depth", join_params_.v_depth, 1.0);
+    // Define whether the plan is resampled at a fixed spacing, with a curvature and speed limit profile
+    private_named_nh.param<bool>("resample_plan", resample_plan_, false);
+    private_named_nh.param<double>("resample_spacing", resampling_params_.spacing, 0.05);
+    private_named_nh.param<double>("max_velocity", resampling_params_.max_velocity, 0.5);
+    private_named_nh.param<double>("max_acceleration", resampling_params_.max_acceleration, 0.5);
+    private_named_nh.param<double>("max_lateral_acceleration", resampling_params_.max_lateral_acceleration, 0.3);
+    if (resample_plan_)
+    {
+      profile_pub_ = private_named_nh.advertise<full_coverage_path_planner::PlanProfile>("plan_profile", 1, true);
+    }
+    // Define whether the tile walk is also split into segments that each fit the budget of one battery charge
+    private_named_nh.param<double>("segment_budget", segmentation_params_.budget, 0.0);
+    private_named_nh.param<double>("segment_cost_per_meter", segmentation_params_.cost_per_meter, 1.0);
+    private_named_nh.param<double>("segment_cost_per_radian", segmentation_params_.cost_per_radian, 0.0);
+    has_dock_ = private_named_nh.getParam("dock_x", dock_.x) && private_named_nh.getParam("dock_y", dock_.y);
+    if (segmentation_params_.budget > 0.0)
+    {
+      segments_pub_ = private_named_nh.advertise<full_coverage_path_planner::PlanSegments>("plan_segments", 1, true);
+    }
+    // Define whether the tile walk is also published as a compact, run-length encoded plan
+    bool compact_plan;
+    private_named_nh.param<bool>("publish_compact_plan", compact_plan, false);
+    if (compact_plan)
+    {
+      compact_plan_pub_ = private_named_nh.advertise<full_coverage_path_planner::CompactCoveragePlan>("compact_plan", 1,
+                                                                                                       true);
+    }
+    // Define whether plans are assembled from a precomputed atlas (see build_atlas) instead of planned
+    std::string atlas_file;
+    private_named_nh.param<std::string>("atlas_file", atlas_file, "");
+    atlas_zones_param_ = private_named_nh.resolveName("atlas_zones");
+    if (!atlas_file.empty())
+    {
+      if (atlas_.open(atlas_file))
+      {
+        ROS_INFO("Loaded atlas %s with %u docks and %u zones", atlas_file.c_str(), atlas_.header().dock_count,
+                 atlas_.header().zone_count);
+      }
+      else
+      {
+        ROS_ERROR("Could not load atlas %s, planning every request instead", atlas_file.c_str());
+      }
+    }
+    // Define whether the inputs of every planning request are recorded, to replay slow plans offline (fcpp_replay)
+    std::string record_directory;
+    int record_count;
+    private_named_nh.param<std::string>("record_requests_dir", record_directory, "");
+    private_named_nh.param<int>("record_requests_count", record_count, 20);
+    if (!record_directory.empty() && !request_recorder_.open(record_directory, record_count))
+    {
+      ROS_ERROR("Could not record planning requests in %s (%s)", record_directory.c_str(), strerror(errno));
+    }
+    // Define a map_server map file to plan on instead of the map of static_map, read straight into tiles
+    private_named_nh.param<std::string>("map_file", map_file_, "");
+    if (!map_file_.empty() && request_recorder_.isOpen())
+    {
+      ROS_WARN("Planning requests are not recorded with map_file");
+    }
+    // Define whether the map and its grid are kept and updated with the map updates of map_server or a costmap,
+    // instead of getting and parsing the whole map for every plan
+    private_named_nh.param<bool>("map_updates", map_updates_, false);
+    if (map_updates_ && !map_file_.empty())
+    {
+      ROS_WARN("map_updates is ignored with map_file");
+      map_updates_ = false;
+    }
+    if (map_updates_)
+    {
+      map_sub_ = nh.subscribe("map", 1, &SpiralSTC::mapCallback, this);
+      map_update_sub_ = nh.subscribe("map_updates", 10, &SpiralSTC::mapUpdateCallback, this);
+      changed_tiles_pub_ = private_named_nh.advertise<full_coverage_path_planner::ChangedTiles>("changed_tiles", 10);
+    }
+    // Define the coverage engine: spiral_stc or contour (contour-parallel loops, see contour_coverage.h)
+    std::string coverage_engine;
+    private_named_nh.param<std::string>("coverage_engine", coverage_engine, "spiral_stc");
+    if (coverage_engine != "spiral_stc" && coverage_engine != "contour")
+    {
+      ROS_WARN("Unknown coverage_engine %s, using spiral_stc", coverage_engine.c_str());
+    }
+    contour_engine_ = coverage_engine == "contour";
+    // Define whether the spiral is planned on the runs of free tiles only, for maps that are mostly obstacle
+    private_named_nh.param<bool>("sparse_grid", sparse_grid_, false);
+    // Define whether snapshots of the spiral_stc search are written, switched at runtime by debug_snapshots
+    std::string snapshots_directory, snapshots_format;
+    int snapshots_buffers;
+    private_named_nh.param<std::string>("debug_snapshots_dir", snapshots_directory, "");
+    private_named_nh.param<std::string>("debug_snapshots_format", snapshots_format, "png");
+    private_named_nh.param<int>("debug_snapshots_buffers", snapshots_buffers, 16);
+    debug_snapshots_param_ = private_named_nh.resolveName("debug_snapshots");
+    if (snapshots_format != "png" && snapshots_format != "log")
+    {
+      ROS_WARN("Unknown debug_snapshots_format %s, using png", snapshots_format.c_str());
+    }
+    if (!snapshots_directory.empty())
+    {
+      if (snapshot_writer_.open(snapshots_directory,
+                                snapshots_format == "log" ? AsyncSnapshotWriter::eLog : AsyncSnapshotWriter::ePng,
+                                std::max(1, snapshots_buffers)))
+      {
+        spiral_workspace_.snapshots = &snapshot_writer_;
+        interval_workspace_.snapshots = &snapshot_writer_;
+      }
+      else
+      {
+        ROS_ERROR("Could not write debug snapshots in %s (%s)", snapshots_directory.c_str(), strerror(errno));
+      }
+    }
+    // Define whether the plan is shared in a shared-memory ring buffer, for co-located consumers
+    bool shared_memory_plan;
+    private_named_nh.param<bool>("shared_memory_plan", shared_memory_plan, false);
+    private_named_nh.param<bool>("publish_plan_topic", publish_plan_topic_, true);
+    if (shared_memory_plan)
+    {
+      std::string shm_name;
+      int slots, slot_capacity;
+      private_named_nh.param<std::string>("shared_memory_name", shm_name, "/full_coverage_path_planner_plan");
+      private_named_nh.param<int>("shared_memory_slots", slots, 2);
+      private_named_nh.param<int>("shared_memory_capacity", slot_capacity, 500000);
+      if (shared_plan_writer_.open(shm_name, std::max(1, slots), std::max(0, slot_capacity)))
+      {
+        shared_plan_pub_ = private_named_nh.advertise<full_coverage_path_planner::SharedPlanHandle>("plan_handle", 1,
+                                                                                                     true);
+      }
+      else
+      {
+        ROS_ERROR("Could not create shared memory %s for the plan (%s), publishing it on the plan topic only",
+                  shm_name.c_str(), strerror(errno));
+      }
+    }
+    // Define whether plans are handed off to consumers in this process, through planHandoff(name)
+    bool plan_handoff;
+    private_named_nh.param<bool>("plan_handoff", plan_handoff, false);
+    if (plan_handoff)
+    {
+      plan_handoff_ = &planHandoff(name);
+    }
     initialized_ = true;
   }
 }
 
+void SpiralSTC::mapCallback(const nav_msgs::OccupancyGrid::ConstPtr& map)
+{
+  setMap(*map);
+}
+
+void SpiralSTC::mapUpdateCallback(const map_msgs::OccupancyGridUpdate::ConstPtr& update)
+{
+  std::vector<Point_t> changed;
+  if (applyMapUpdate(*update, changed))
+  {
+    ROS_DEBUG("Map update changed %zu tiles", changed.size());
+  }
+}
+
 std::list<gridNode_t> SpiralSTC::spiral(std::vector<std::vector<bool> > const& grid, std::list<gridNode_t>& init,
                                         std::vector<std::vector<bool> >& visited)
 {
@@ -129,11 +346,6 @@ std::list<Point_t> SpiralSTC::spiral_stc(std::vector<std::vector<bool> > const&
   pathNodes.push_back(new_node);
   visited[y][x] = eNodeVisited;
 
-#ifdef DEBUG_PLOT
-  ROS_INFO("Grid before walking is: ");
-  printGrid(grid, visited, fullPath);
-#endif
-
   pathNodes = SpiralSTC::spiral(grid, pathNodes, visited);                // First spiral fill
   std::list<Point_t> goals = map_2_goals(visited, eNodeOpen);  // Retrieve remaining goalpoints
   // Add points to full path
@@ -147,11 +359,6 @@ std::list<Point_t> SpiralSTC::spiral_stc(std::vector<std::vector<bool> > const&
   // Remove all elements from pathNodes list except last element
   pathNodes.erase(pathNodes.begin(), --(pathNodes.end()));
 
-#ifdef DEBUG_PLOT
-  ROS_INFO("Current grid after first spiral is");
-  printGrid(grid, visited, fullPath);
-  ROS_INFO("There are %d goals remaining", goals.size());
-#endif
   while (goals.size() != 0)
   {
     // Remove all elements from pathNodes list except last element.
@@ -164,9 +371,6 @@ std::list<Point_t> SpiralSTC::spiral_stc(std::vector<std::vector<bool> > const&
     bool resign = a_star_to_open_space(grid, pathNodes.back(), 1, visited, goals, pathNodes);
     if (resign)
     {
-#ifdef DEBUG_PLOT
-      ROS_INFO("A_star_to_open_space is resigning", goals.size());
-#endif
       break;
     }
 
@@ -184,20 +388,9 @@ std::list<Point_t> SpiralSTC::spiral_stc(std::vector<std::vector<bool> > const&
       multiple_pass_counter--;  // First point is already counted as visited
     }
 
-#ifdef DEBUG_PLOT
-    ROS_INFO("Grid with path marked as visited is:");
-    gridNode_t SpiralStart = pathNodes.back();
-    printGrid(grid, visited, pathNodes, pathNodes.front(), pathNodes.back());
-#endif
-
     // Spiral fill from current position
     pathNodes = spiral(grid, pathNodes, visited);
 
-#ifdef DEBUG_PLOT
-    ROS_INFO("Visited grid updated after spiral:");
-    printGrid(grid, visited, pathNodes, SpiralStart, pathNodes.back());
-#endif
-
     goals = map_2_goals(visited, eNodeOpen);  // Retrieve remaining goalpoints
 
     for (it = pathNodes.begin(); it != pathNodes.end(); ++it)
@@ -211,6 +404,37 @@ std::list<Point_t> SpiralSTC::spiral_stc(std::vector<std::vector<bool> > const&
   return fullPath;
 }
 
+void SpiralSTC::spiral(std::vector<std::vector<bool> > const& grid, std::vector<gridNode_t>& pathNodes,
+                       std::vector<std::vector<bool> >& visited)
+{
+  spiralFill(grid, pathNodes, visited);
+}
+
+void SpiralSTC::spiral_stc(std::vector<std::vector<bool> > const& grid,
+                           Point_t const& init,
+                           SpiralWorkspace& workspace,
+                           std::vector<Point_t>& fullPath,
+                           int& multiple_pass_counter,
+                           int& visited_counter)
+{
+  spiralCoverage(grid, init, workspace, fullPath, multiple_pass_counter, visited_counter);
+}
+
+void SpiralSTC::spiral(IntervalGrid const& grid, std::vector<gridNode_t>& pathNodes, std::vector<bool>& visited)
+{
+  spiralFill(grid, pathNodes, visited);
+}
+
+void SpiralSTC::spiral_stc(IntervalGrid const& grid,
+                           Point_t const& init,
+                           IntervalSpiralWorkspace& workspace,
+                           std::vector<Point_t>& fullPath,
+                           int& multiple_pass_counter,
+                           int& visited_counter)
+{
+  spiralCoverage(grid, init, workspace, fullPath, multiple_pass_counter, visited_counter);
+}
+
 bool SpiralSTC::makePlan(const geometry_msgs::PoseStamped& start, const geometry_msgs::PoseStamped& goal,
                          std::vector<geometry_msgs::PoseStamped>& plan)
 {
@@ -225,39 +449,88 @@ bool SpiralSTC::makePlan(const geometry_msgs::PoseStamped& start, const geometry
   }
 
   clock_t begin = clock();
-  Point_t startPoint;
-
-  /********************** Get grid from server **********************/
-  std::vector<std::vector<bool> > grid;
-  nav_msgs::GetMap grid_req_srv;
-  ROS_INFO("Requesting grid!!");
-  if (!cpp_grid_client_.call(grid_req_srv))
+  std::list<Point_t> goalPoints;
+
+  // Look the plan up in the atlas when there is one, plan it otherwise. The atlas plan is converted on the tiles of
+  // the atlas, those of the map are restored once it is handed off
+  float map_tile_size = tile_size_;
+  fPoint_t map_grid_origin = grid_origin_;
+  bool from_atlas = atlas_.isOpen() && planFromAtlas(start, goalPoints);
+  if (!from_atlas)
   {
-    ROS_ERROR("Could not retrieve grid from map_server");
-    return false;
-  }
+    Point_t startPoint;
 
-  if (!parseGrid(grid_req_srv.response.map, grid, robot_radius_ * 2, tool_radius_ * 2, start, startPoint))
-  {
-    ROS_ERROR("Could not parse retrieved grid");
-    return false;
-  }
+    /********************** Get grid from server **********************/
+    std::vector<std::vector<bool> > grid;
+    if (!planningGrid(start, grid, startPoint))
+    {
+      return false;
+    }
 
-#ifdef DEBUG_PLOT
-  ROS_INFO("Start grid is:");
-  std::list<Point_t> printPath;
-  printPath.push_back(startPoint);
-  printGrid(grid, grid, printPath);
-#endif
-
-  std::list<Point_t> goalPoints = spiral_stc(grid,
-                                              startPoint,
-                                              spiral_cpp_metrics_.multiple_pass_counter,
-                                              spiral_cpp_metrics_.visited_counter);
-  ROS_INFO("naive cpp completed!");
+    if (snapshot_writer_.isOpen())
+    {
+      bool snapshots = false;
+      ros::param::get(debug_snapshots_param_, snapshots);
+      snapshot_writer_.setEnabled(snapshots);
+    }
+
+    if (contour_engine_)
+    {
+      contourCoverage(grid,
+                      startPoint,
+                      contour_workspace_,
+                      spiral_path_,
+                      spiral_cpp_metrics_.multiple_pass_counter,
+                      spiral_cpp_metrics_.visited_counter);
+    }
+    else if (sparse_grid_)
+    {
+      interval_grid_.assign(grid);
+      ROS_INFO("Planning on %d free tiles in %d intervals", interval_grid_.freeCount(),
+               interval_grid_.intervalCount());
+      spiral_stc(interval_grid_,
+                 startPoint,
+                 interval_workspace_,
+                 spiral_path_,
+                 spiral_cpp_metrics_.multiple_pass_counter,
+                 spiral_cpp_metrics_.visited_counter);
+    }
+    else
+    {
+      spiral_stc(grid,
+                 startPoint,
+                 spiral_workspace_,
+                 spiral_path_,
+                 spiral_cpp_metrics_.multiple_pass_counter,
+                 spiral_cpp_metrics_.visited_counter);
+    }
+    goalPoints.assign(spiral_path_.begin(), spiral_path_.end());
+    if (segments_pub_)
+    {
+      publishPlanSegments(start, grid, startPoint, spiral_path_);
+    }
+    if (snapshot_writer_.enabled() && snapshot_writer_.dropped() > 0)
+    {
+      ROS_WARN("%lu debug snapshots dropped so far, increase debug_snapshots_buffers to keep them all",
+               snapshot_writer_.dropped());
+    }
+    ROS_INFO("naive cpp completed!");
+  }
   ROS_INFO("Converting path to plan");
 
+  if (compact_plan_pub_)
+  {
+    publishCompactPlan(start, goalPoints);
+  }
   parsePointlist2Plan(start, goalPoints, plan);
+  if (join_params_.style != eJoinNone)
+  {
+    smoothPlan(plan);
+  }
+  if (resample_plan_)
+  {
+    resamplePlan(plan);
+  }
   // Print some metrics:
   spiral_cpp_metrics_.accessible_counter = spiral_cpp_metrics_.visited_counter
                                             - spiral_cpp_metrics_.multiple_pass_counter;
@@ -272,6 +545,12 @@ bool SpiralSTC::makePlan(const geometry_msgs::PoseStamped& start, const geometry
 
   ROS_INFO("Publishing plan!");
   publishPlan(plan);
+  handOffPlan(plan, goalPoints);
+  if (from_atlas)
+  {
+    tile_size_ = map_tile_size;
+    grid_origin_ = map_grid_origin;
+  }
   ROS_INFO("Plan published!");
   ROS_DEBUG("Plan published");
 
@@ -281,4 +560,92 @@ bool SpiralSTC::makePlan(const geometry_msgs::PoseStamped& start, const geometry
 
   return true;
 }
+
+bool SpiralSTC::buildAtlas(nav_msgs::OccupancyGrid const& map, std::vector<std::vector<fPoint_t> > const& zones,
+                           std::vector<fPoint_t> const& docks, std::string const& file)
+{
+  std::vector<std::vector<bool> > grid;
+  geometry_msgs::PoseStamped anyStart;
+  Point_t startPoint;
+  std::lock_guard<std::mutex> lock(map_mutex_);
+  grid_valid_ = false;  // parseGrid replaces the parse that map updates are applied to
+  if (!parseGrid(map, grid, robot_radius_ * 2, tool_radius_ * 2, anyStart, startPoint))
+  {
+    ROS_ERROR("Could not parse the map for the atlas");
+    return false;
+  }
+  return buildAtlasOnGrid(grid, zones, docks, file);
+}
+
+bool SpiralSTC::buildAtlas(std::string const& map_file, std::vector<std::vector<fPoint_t> > const& zones,
+                           std::vector<fPoint_t> const& docks, std::string const& file)
+{
+  std::vector<std::vector<bool> > grid;
+  geometry_msgs::PoseStamped anyStart;
+  Point_t startPoint;
+  std::lock_guard<std::mutex> lock(map_mutex_);
+  grid_valid_ = false;  // parseTileGrid replaces the parse that map updates are applied to
+  if (!loadMapFile(map_file, robot_radius_ * 2, tool_radius_ * 2) ||
+      !parseTileGrid(file_metadata_, file_footprint_, file_tiles_, anyStart, grid, startPoint))
+  {
+    ROS_ERROR("Could not load map file %s for the atlas", map_file.c_str());
+    return false;
+  }
+  return buildAtlasOnGrid(grid, zones, docks, file);
+}
+
+bool SpiralSTC::buildAtlasOnGrid(std::vector<std::vector<bool> > const& grid,
+                                 std::vector<std::vector<fPoint_t> > const& zones, std::vector<fPoint_t> const& docks,
+                                 std::string const& file)
+{
+  AtlasContent content;
+  content.origin_x = grid_origin_.x;
+  content.origin_y = grid_origin_.y;
+  content.tile_size = tile_size_;
+  content.height = grid.size();
+  content.width = grid[0].size();
+  for (unsigned int d = 0; d < docks.size(); ++d)
+  {
+    Point_t dock =
+    {
+      static_cast<int>(floor((docks[d].x - grid_origin_.x) / tile_size_)),
+      static_cast<int>(floor((docks[d].y - grid_origin_.y) / tile_size_))
+    };
+    content.docks.push_back(dock);
+  }
+
+  // A spiral per zone, on the grid with everything outside of the zone blocked
+  content.zones.resize(zones.size());
+  for (unsigned int z = 0; z < zones.size(); ++z)
+  {
+    std::vector<fPoint_t> polygon(zones[z].size());
+    for (unsigned int i = 0; i < zones[z].size(); ++i)
+    {
+      polygon[i].x = (zones[z][i].x - grid_origin_.x) / tile_size_;
+      polygon[i].y = (zones[z][i].y - grid_origin_.y) / tile_size_;
+    }
+    std::vector<std::vector<bool> > zoneGrid = grid;
+    maskOutsidePolygon(zoneGrid, polygon);
+    std::list<Point_t> freeTiles = map_2_goals(zoneGrid, eNodeOpen);
+    if (freeTiles.empty())
+    {
+      ROS_WARN("Zone %u has no accessible tiles", z);
+      continue;
+    }
+    Point_t entry = { static_cast<int>(polygon[0].x), static_cast<int>(polygon[0].y) };
+    entry = *std::min_element(freeTiles.begin(), freeTiles.end(), ComparatorForPointSort(entry));
+    int multiple_pass_counter, visited_counter;
+    content.zones[z] = spiral_stc(zoneGrid, entry, multiple_pass_counter, visited_counter);
+    ROS_INFO("Zone %u: %lu tiles from (%d, %d)", z, content.zones[z].size(), entry.x, entry.y);
+  }
+
+  connectAtlas(grid, content);
+  if (!writeAtlas(file, content))
+  {
+    ROS_ERROR("Could not write atlas %s", file.c_str());
+    return false;
+  }
+  ROS_INFO("Wrote atlas %s with %lu docks and %lu zones", file.c_str(), docks.size(), zones.size());
+  return true;
+}
 }  // namespace full_coverage_path_planner
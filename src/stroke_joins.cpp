@@ -0,0 +1,211 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <full_coverage_path_planner/stroke_joins.h>
+
+namespace full_coverage_path_planner
+{
+namespace
+{
+const double kPositionEpsilon = 1e-6;
+const double kRightAngleEpsilon = 1e-3;  // Tolerance on the dot product of unit vectors
+
+struct Vec
+{
+  double x, y;
+};
+
+inline Vec operator+(Vec a, Vec b)
+{
+  Vec r = { a.x + b.x, a.y + b.y };
+  return r;
+}
+
+inline Vec operator-(Vec a, Vec b)
+{
+  Vec r = { a.x - b.x, a.y - b.y };
+  return r;
+}
+
+inline Vec operator*(double s, Vec a)
+{
+  Vec r = { s * a.x, s * a.y };
+  return r;
+}
+
+inline double dot(Vec a, Vec b)
+{
+  return a.x * b.x + a.y * b.y;
+}
+
+inline double cross(Vec a, Vec b)
+{
+  return a.x * b.y - a.y * b.x;
+}
+
+inline double heading(Vec a)
+{
+  return std::atan2(a.y, a.x);
+}
+
+/**
+ * Append a pose, unless it is identical to the last one
+ */
+void emit(std::vector<Waypoint>& out, Vec p, double yaw)
+{
+  if (!out.empty())
+  {
+    Waypoint const& last = out.back();
+    if (std::fabs(last.x - p.x) < kPositionEpsilon && std::fabs(last.y - p.y) < kPositionEpsilon &&
+        std::fabs(std::remainder(last.yaw - yaw, 2 * M_PI)) < kRightAngleEpsilon)
+    {
+      return;
+    }
+  }
+  Waypoint w = { p.x, p.y, yaw };
+  out.push_back(w);
+}
+
+/**
+ * Append the arc center + r * (cos(t) * u + sin(t) * w) for t in [0, sweep], sampled at the given spacing.
+ * u and w are orthogonal unit vectors, so the arc starts at center + r * u heading in direction w
+ */
+void appendArc(std::vector<Waypoint>& out, Vec center, Vec u, Vec w, double r, double sweep, double spacing)
+{
+  int n = std::max(1, static_cast<int>(std::ceil(r * sweep / std::max(spacing, kPositionEpsilon))));
+  // Only the start can repeat the last pose, the other poses are a step apart and are written without checks
+  emit(out, center + r * u, heading(w));
+  size_t first = out.size();
+  out.resize(first + n);
+
+  // Rotate (cos(t), sin(t)) by the step instead of evaluating sin and cos for every pose. The tangent turns along, so
+  // its heading changes by the step as well, counter-clockwise when w is counter-clockwise from u
+  double step = sweep / n, cos_step = std::cos(step), sin_step = std::sin(step);
+  double turn = cross(u, w) > 0.0 ? step : -step;
+  double c = 1.0, s = 0.0, start_yaw = heading(w);
+  for (int k = 1; k <= n; ++k)
+  {
+    double c_next = c * cos_step - s * sin_step;
+    s = s * cos_step + c * sin_step;
+    c = c_next;
+    double yaw = start_yaw + k * turn;
+    yaw = yaw > M_PI ? yaw - 2 * M_PI : yaw < -M_PI ? yaw + 2 * M_PI : yaw;
+    Waypoint& p = out[first + k - 1];
+    p.x = center.x + r * (c * u.x + s * w.x);
+    p.y = center.y + r * (c * u.y + s * w.y);
+    p.yaw = yaw;
+  }
+}
+
+inline bool isRightAngle(Vec d_in, Vec d_out)
+{
+  return std::fabs(dot(d_in, d_out)) < kRightAngleEpsilon;
+}
+}  // namespace
+
+std::vector<Waypoint> smoothStrokeJoins(std::vector<Waypoint> const& path, StrokeJoinParams const& params)
+{
+  std::vector<Waypoint> out;
+  if (path.empty())
+  {
+    return out;
+  }
+
+  // Merge waypoints at the same position, only the positions matter for the shape of the path
+  std::vector<Vec> points;
+  points.reserve(path.size());
+  for (std::vector<Waypoint>::const_iterator it = path.begin(); it != path.end(); ++it)
+  {
+    Vec p = { it->x, it->y };
+    if (points.empty() || std::fabs(points.back().x - p.x) > kPositionEpsilon ||
+        std::fabs(points.back().y - p.y) > kPositionEpsilon)
+    {
+      points.push_back(p);
+    }
+  }
+
+  int n = points.size();
+  out.reserve(2 * path.size());
+  emit(out, points[0], path[0].yaw);
+  if (n < 2)
+  {
+    return out;
+  }
+
+  // Unit direction and length of all segments
+  std::vector<Vec> direction(n - 1);
+  std::vector<double> length(n - 1);
+  for (int i = 0; i < n - 1; ++i)
+  {
+    Vec d = points[i + 1] - points[i];
+    length[i] = std::sqrt(dot(d, d));
+    direction[i] = (1.0 / length[i]) * d;
+  }
+  emit(out, points[0], heading(direction[0]));
+
+  int i = 1;
+  while (i < n - 1)
+  {
+    Vec d_in = direction[i - 1], d_out = direction[i];
+    if (params.style == eJoinNone || !isRightAngle(d_in, d_out))
+    {
+      // Stop and turn on the spot
+      emit(out, points[i], heading(d_in));
+      emit(out, points[i], heading(d_out));
+      ++i;
+      continue;
+    }
+
+    bool u_turn = i + 1 < n - 1 && isRightAngle(d_out, direction[i + 1]) &&
+                  cross(d_in, d_out) * cross(d_out, direction[i + 1]) > 0 &&
+                  length[i] <= params.u_turn_width + kPositionEpsilon;
+    if (u_turn)
+    {
+      // Join the end of this stroke (a) with the start of the next stroke (b)
+      Vec a = points[i], b = points[i + 1];
+      Vec d_next = direction[i + 1];
+      double r = 0.5 * length[i];
+      Vec middle = a + r * d_out;
+      if (params.style == eJoinHalfCircle)
+      {
+        // Half circle through a and b that continues in the direction of the strokes
+        appendArc(out, middle, (-1.0) * d_out, d_in, r, M_PI, params.spacing);
+      }
+      else
+      {
+        // V between a and b that points back along the strokes
+        Vec v = middle + (-2.0 * r * params.v_depth) * d_in + (-r * params.v_bottom_off_center) * d_out;
+        emit(out, a, heading(d_in));
+        emit(out, a, heading(v - a));
+        emit(out, v, heading(v - a));
+        emit(out, v, heading(b - v));
+        emit(out, b, heading(b - v));
+      }
+      emit(out, b, heading(d_next));
+      i += 2;
+      continue;
+    }
+
+    // Fillet, at most half of the adjacent segments so that neighbouring fillets do not overlap
+    double r = std::min(params.turn_radius, 0.5 * std::min(length[i - 1], length[i]));
+    if (r <= kPositionEpsilon)
+    {
+      emit(out, points[i], heading(d_in));
+      emit(out, points[i], heading(d_out));
+    }
+    else
+    {
+      Vec center = points[i] + (-r) * d_in + r * d_out;
+      appendArc(out, center, (-1.0) * d_out, d_in, r, 0.5 * M_PI, params.spacing);
+    }
+    ++i;
+  }
+
+  emit(out, points[n - 1], heading(direction[n - 2]));
+  return out;
+}
+}  // namespace full_coverage_path_planner
@@ -0,0 +1,229 @@
+#!/usr/bin/env python
+"""End-to-end coverage throughput benchmark.
+
+Stands in for the robot, the controller and the simulator at once: it publishes /clock faster than real time,
+requests a coverage plan from move_base_flex (get_path with SpiralSTC), drives a kinematic robot along the plan and
+publishes its pose on TF, so coverage_progress can track it. At the end it reports the time to the first plan, the
+CPU time of the planner and of the tracker and the area covered per simulated minute.
+"""
+
+import math
+import os
+import threading
+import time
+
+import actionlib
+import rosgraph
+import rosnode
+import rospy
+import tf
+from geometry_msgs.msg import PoseStamped
+from mbf_msgs.msg import GetPathAction, GetPathGoal
+from rosgraph_msgs.msg import Clock
+from std_msgs.msg import Float32
+
+try:
+    from xmlrpc.client import ServerProxy
+except ImportError:
+    from xmlrpclib import ServerProxy
+
+
+def process_cpu_seconds(node_name):
+    """User and system CPU time of the process of a node on this machine, None if it is not known"""
+    try:
+        uri = rosnode.get_api_uri(rosgraph.Master(rospy.get_name()), node_name, skip_cache=True)
+        _, _, pid = ServerProxy(uri).getPid(rospy.get_name())
+        with open('/proc/%d/stat' % pid) as stat:
+            # utime and stime are fields 14 and 15, counted after the parenthesized command name
+            fields = stat.read().rsplit(')', 1)[1].split()
+        return (int(fields[11]) + int(fields[12])) / float(os.sysconf('SC_CLK_TCK'))
+    except Exception:  # noqa: the node may have died or run on another machine
+        return None
+
+
+def wrap(angle):
+    return (angle + math.pi) % (2 * math.pi) - math.pi
+
+
+class KinematicRobot(object):
+    """Follows the poses of a plan exactly: turns on the spot towards the next pose, drives straight to it and turns
+    to its heading, at fixed velocities"""
+
+    def __init__(self, x, y, yaw, x_vel, yaw_vel):
+        self.x, self.y, self.yaw = x, y, yaw
+        self.x_vel, self.yaw_vel = x_vel, yaw_vel
+        self.distance = 0.0
+        self._poses = []
+        self._index = 0
+
+    def follow(self, poses):
+        self._poses = [(p.pose.position.x, p.pose.position.y,
+                        tf.transformations.euler_from_quaternion((p.pose.orientation.x, p.pose.orientation.y,
+                                                                  p.pose.orientation.z, p.pose.orientation.w))[2])
+                       for p in poses]
+        self._index = 0
+
+    def finished(self):
+        return self._index >= len(self._poses)
+
+    def step(self, dt):
+        while dt > 0 and not self.finished():
+            x, y, yaw = self._poses[self._index]
+            dx, dy = x - self.x, y - self.y
+            distance = math.hypot(dx, dy)
+            target_yaw = math.atan2(dy, dx) if distance > 1e-3 else yaw
+            turn = wrap(target_yaw - self.yaw)
+            if abs(turn) > 1e-3:
+                used = min(abs(turn) / self.yaw_vel, dt)
+                self.yaw = wrap(self.yaw + math.copysign(used * self.yaw_vel, turn))
+            elif distance > 1e-3:
+                used = min(distance / self.x_vel, dt)
+                self.x += dx / distance * used * self.x_vel
+                self.y += dy / distance * used * self.x_vel
+                self.distance += used * self.x_vel
+            else:
+                self._index += 1
+                used = 0.0
+            dt -= used
+
+
+class CoverageBenchmark(object):
+
+    def __init__(self):
+        self.rate = rospy.get_param("~rate", 50.0)  # Simulation steps per simulated second
+        self.speedup = rospy.get_param("~speedup", 10.0)  # Simulated seconds per wall second, 0 for as fast as possible
+        self.max_duration = rospy.get_param("~max_duration", 3600.0)  # Simulated seconds after the plan
+        self.settle = rospy.get_param("~settle", 2.0)  # Simulated seconds to continue after the plan is driven
+        self.area = rospy.get_param("~coverage_area_size_x", 10.0) * rospy.get_param("~coverage_area_size_y", 10.0)
+        self.map_name = rospy.get_param("~map_name", "map")
+        self.report_file = rospy.get_param("~report_file", "")
+        self.planner_node = rospy.get_param("~planner_node", "/move_base_flex")
+        self.tracker_node = rospy.get_param("~tracker_node", "/coverage_progress")
+        self.robot = KinematicRobot(rospy.get_param("~start_x", 0.0), rospy.get_param("~start_y", 0.0),
+                                    rospy.get_param("~start_yaw", 0.0), rospy.get_param("~target_x_vel", 0.5),
+                                    rospy.get_param("~target_yaw_vel", 0.4))
+
+        self.clock_pub = rospy.Publisher("/clock", Clock, queue_size=1)
+        self.broadcaster = tf.TransformBroadcaster()
+        self.progress = 0.0
+        self.progress_sub = rospy.Subscriber("coverage_progress", Float32, self._progress_callback, queue_size=1)
+
+        self._lock = threading.Lock()
+        self._sim_time = 1.0
+        self._driving_since = None
+        self._finished_at = None
+
+    def _progress_callback(self, msg):
+        self.progress = msg.data
+
+    def _simulate(self):
+        """Advance the clock and the robot in fixed steps, at speedup times real time"""
+        dt = 1.0 / self.rate
+        wall_start = time.time()
+        sim_start = self._sim_time
+        while not rospy.is_shutdown():
+            with self._lock:
+                self._sim_time += dt
+                stamp = rospy.Time.from_sec(self._sim_time)
+                if self._driving_since is not None and self._finished_at is None:
+                    self.robot.step(dt)
+                    if self.robot.finished():
+                        self._finished_at = self._sim_time
+                x, y, yaw = self.robot.x, self.robot.y, self.robot.yaw
+            self.clock_pub.publish(Clock(clock=stamp))
+            self.broadcaster.sendTransform((0, 0, 0), (0, 0, 0, 1), stamp, "odom", "map")
+            self.broadcaster.sendTransform((x, y, 0), tf.transformations.quaternion_from_euler(0, 0, yaw), stamp,
+                                           "base_link", "odom")
+            if self.speedup > 0:
+                time.sleep(max(0.0, wall_start + (self._sim_time - sim_start) / self.speedup - time.time()))
+
+    def run(self):
+        simulation = threading.Thread(target=self._simulate)
+        simulation.daemon = True
+        simulation.start()
+
+        client = actionlib.SimpleActionClient(self.planner_node + "/get_path", GetPathAction)
+        client.wait_for_server()
+        planner_cpu_start = process_cpu_seconds(self.planner_node)
+        tracker_cpu_start = process_cpu_seconds(self.tracker_node)
+
+        goal = GetPathGoal()
+        goal.use_start_pose = True
+        goal.start_pose = PoseStamped()
+        goal.start_pose.header.frame_id = "map"
+        goal.start_pose.header.stamp = rospy.Time.now()
+        goal.start_pose.pose.position.x = self.robot.x
+        goal.start_pose.pose.position.y = self.robot.y
+        (goal.start_pose.pose.orientation.x, goal.start_pose.pose.orientation.y, goal.start_pose.pose.orientation.z,
+         goal.start_pose.pose.orientation.w) = tf.transformations.quaternion_from_euler(0, 0, self.robot.yaw)
+        goal.target_pose = goal.start_pose
+        goal.planner = "SpiralSTC"
+
+        wall_start = time.time()
+        client.send_goal(goal)
+        while not client.wait_for_result(rospy.Duration(0.1)) and not rospy.is_shutdown():
+            pass
+        time_to_first_plan = time.time() - wall_start
+        result = client.get_result()
+        if result is None or not result.path.poses:
+            rospy.logerr("No plan received, outcome %s", result.outcome if result else None)
+            rospy.signal_shutdown("benchmark failed")
+            return
+
+        with self._lock:
+            self.robot.follow(result.path.poses)
+            self._driving_since = self._sim_time
+        wall_driving = time.time()
+        now = self._driving_since
+        while not rospy.is_shutdown():
+            time.sleep(0.05)
+            with self._lock:
+                now = self._sim_time
+                if self._finished_at is not None and now > self._finished_at + self.settle:
+                    break
+                if now > self._driving_since + self.max_duration:
+                    rospy.logwarn("Plan not finished in %.0f simulated seconds", self.max_duration)
+                    break
+        wall_duration = time.time() - wall_driving
+        sim_minutes = (now - self._driving_since) / 60.0
+
+        planner_cpu_end = process_cpu_seconds(self.planner_node)
+        tracker_cpu_end = process_cpu_seconds(self.tracker_node)
+
+        def used(start, end):
+            return end - start if start is not None and end is not None else float('nan')
+
+        covered = self.progress * self.area
+        report = {
+            "map": self.map_name,
+            "time_to_first_plan": time_to_first_plan,
+            "plan_poses": len(result.path.poses),
+            "planner_cpu": used(planner_cpu_start, planner_cpu_end),
+            "tracker_cpu": used(tracker_cpu_start, tracker_cpu_end),
+            "simulated_minutes": sim_minutes,
+            "real_time_factor": sim_minutes * 60.0 / wall_duration,
+            "distance": self.robot.distance,
+            "covered_m2": covered,
+            "m2_per_minute": covered / sim_minutes if sim_minutes > 0 else 0.0,
+        }
+        columns = ["map", "time_to_first_plan", "plan_poses", "planner_cpu", "tracker_cpu", "simulated_minutes",
+                   "real_time_factor", "distance", "covered_m2", "m2_per_minute"]
+        line = ",".join(str(report[c]) if isinstance(report[c], (str, int)) else "%.3f" % report[c] for c in columns)
+        rospy.loginfo("Coverage benchmark %s: first plan in %.3f s (%d poses), planner CPU %.2f s, tracker CPU "
+                      "%.2f s, %.1f m2 in %.1f simulated minutes = %.2f m2/min (%.1fx real time)",
+                      self.map_name, time_to_first_plan, report["plan_poses"], report["planner_cpu"],
+                      report["tracker_cpu"], covered, sim_minutes, report["m2_per_minute"],
+                      report["real_time_factor"])
+        if self.report_file:
+            new_file = not os.path.exists(self.report_file)
+            with open(self.report_file, "a") as out:
+                if new_file:
+                    out.write(",".join(columns) + "\n")
+                out.write(line + "\n")
+        print(line)
+        rospy.signal_shutdown("benchmark finished")
+
+
+if __name__ == '__main__':
+    rospy.init_node("coverage_benchmark")
+    CoverageBenchmark().run()
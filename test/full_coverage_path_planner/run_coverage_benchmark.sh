@@ -0,0 +1,14 @@
+#!/bin/bash
+# Run the end-to-end coverage benchmark on the maps of this package, one line per map is appended to the report
+# Usage: run_coverage_benchmark.sh [report.csv] [extra roslaunch arguments]
+report=${1:-coverage_benchmark.csv}
+shift
+maps=$(rospack find full_coverage_path_planner)/maps
+
+roslaunch full_coverage_path_planner coverage_benchmark.launch map:="$maps/basement.yaml" map_name:=basement \
+    coverage_area_offset:="-24.025 -6.275 0 0 0 0" coverage_area_size_x:=30 coverage_area_size_y:=30 \
+    robot_radius:=0.5 tool_radius:=0.5 report_file:="$(realpath "$report")" "$@"
+roslaunch full_coverage_path_planner coverage_benchmark.launch map:="$maps/grid.yaml" map_name:=grid \
+    coverage_area_offset:="-5 -5 0 0 0 0" coverage_area_size_x:=15 coverage_area_size_y:=15 \
+    report_file:="$(realpath "$report")" "$@"
+cat "$report"
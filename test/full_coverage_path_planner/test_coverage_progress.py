@@ -0,0 +1,256 @@
+#!/usr/bin/env python
+"""Unit tests of the coverage bookkeeping of nodes/coverage_progress, without a ROS master: the node is created
+without its publishers, services and tf listener, its parameters come from a dict instead of the parameter server.
+"""
+
+import os
+import random
+import threading
+import unittest
+
+import numpy as np
+
+try:
+    from unittest import mock
+except ImportError:
+    import mock
+
+PKG = 'full_coverage_path_planner'
+NODE = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'nodes', 'coverage_progress')
+
+try:
+    from importlib.machinery import SourceFileLoader
+    from importlib.util import module_from_spec, spec_from_loader
+    _spec = spec_from_loader('coverage_progress', SourceFileLoader('coverage_progress', NODE))
+    coverage_progress = module_from_spec(_spec)
+    _spec.loader.exec_module(coverage_progress)
+except ImportError:
+    import imp
+    coverage_progress = imp.load_source('coverage_progress', NODE)
+
+# 160 x 100 cells of 5 cm: 3 x 2 tiles, the last column and row of tiles partial
+PARAMS = {
+    '~target_area/x': 8.0,
+    '~target_area/y': 5.0,
+    '~coverage_radius': 0.3,
+    '~coverage_resolution': 0.05,
+    '~coverage_frames': ['robot_0', 'robot_1'],
+}
+
+
+def get_param(name, *default):
+    if name in PARAMS:
+        return PARAMS[name]
+    if default:
+        return default[0]
+    raise KeyError(name)
+
+
+def random_rectangles(rng, width, height, count):
+    """Rectangles [x0, x1) x [y0, y1), some of them (partly) outside of the grid or empty"""
+    for _ in range(count):
+        x0, x1 = sorted(rng.randint(-10, width + 10) for _ in range(2))
+        y0, y1 = sorted(rng.randint(-10, height + 10) for _ in range(2))
+        yield x0, y0, x1, y1
+
+
+def brute_count(counts, x0, y0, x1, y1):
+    """Sum of [x0, x1) x [y0, y1) of a [y][x] array, clipped to it"""
+    height, width = counts.shape
+    return int(counts[max(y0, 0):max(min(y1, height), 0), max(x0, 0):max(min(x1, width), 0)].sum())
+
+
+class TestCoverageIndex(unittest.TestCase):
+
+    def test_random_marks(self):
+        """Rectangle sums equal the sums of a dense array after random marks"""
+        rng = random.Random(42)
+        width, height = 23, 17
+        index = coverage_progress.CoverageIndex(width, height)
+        counts = np.zeros((height, width), dtype=int)
+        for _ in range(300):
+            x, y, amount = rng.randrange(width), rng.randrange(height), rng.randint(1, 3)
+            index.add(x, y, amount)
+            counts[y, x] += amount
+        self.assertEqual(int(counts.sum()), index.count(0, 0, width, height))
+        for x0, y0, x1, y1 in random_rectangles(rng, width, height, 500):
+            self.assertEqual(brute_count(counts, x0, y0, x1, y1), index.count(x0, y0, x1, y1),
+                             (x0, y0, x1, y1))
+
+    def test_outside(self):
+        """Rectangles outside of the grid or empty count nothing"""
+        index = coverage_progress.CoverageIndex(4, 3)
+        for y in range(3):
+            for x in range(4):
+                index.add(x, y)
+        self.assertEqual(12, index.count(-5, -5, 10, 10))
+        self.assertEqual(0, index.count(4, 0, 8, 3))
+        self.assertEqual(0, index.count(-3, 0, 0, 3))
+        self.assertEqual(0, index.count(0, 3, 4, 6))
+        self.assertEqual(0, index.count(2, 1, 2, 3))
+        self.assertEqual(0, index.count(3, 2, 1, 1))
+
+
+class TestCoverageTiles(unittest.TestCase):
+
+    def test_random_covers(self):
+        """covered_count and rectangle counts equal those of a dense grid, also for cells covered more than once"""
+        rng = random.Random(7)
+        width, height, dirty = 150, 70, 100
+        coverage = coverage_progress.CoverageTiles(width, height, dirty)
+        values = np.full((height, width), dirty, dtype=int)
+        for _ in range(2000):
+            x, y, effectivity = rng.randrange(width), rng.randrange(height), rng.randint(1, 60)
+            became_covered = values[y, x] >= dirty
+            values[y, x] = max(0, values[y, x] - effectivity)
+            self.assertEqual(became_covered, coverage.cover(x, y, effectivity))
+        covered = (values < dirty).astype(int)
+        self.assertEqual(int(covered.sum()), coverage.covered_count)
+        for x0, y0, x1, y1 in random_rectangles(rng, width, height, 500):
+            self.assertEqual(brute_count(covered, x0, y0, x1, y1), coverage.count(x0, y0, x1, y1),
+                             (x0, y0, x1, y1))
+
+    def test_export(self):
+        """Every range of tiles exports the values of its cells, across tile boundaries and with the partial tiles at
+        the far borders
+        """
+        rng = random.Random(3)
+        width, height, dirty = 150, 70, 100
+        tile = coverage_progress.CoverageTiles.TILE
+        coverage = coverage_progress.CoverageTiles(width, height, dirty)
+        values = np.full((height, width), dirty, dtype=int)
+        # Covers along the tile boundaries and at the borders, and random ones, so some tiles stay unallocated
+        xs = (0, tile - 1, tile, 2 * tile - 1, 2 * tile, width - 1)
+        ys = (0, tile - 1, tile, height - 1)
+        cells = [(x, y) for x in xs for y in ys]
+        cells += [(rng.randrange(2 * tile), rng.randrange(tile)) for _ in range(300)]
+        for x, y in cells:
+            effectivity = rng.randint(1, 60)
+            values[y, x] = max(0, values[y, x] - effectivity)
+            coverage.cover(x, y, effectivity)
+        self.assertEqual((3, 2), (coverage.tiles_x, coverage.tiles_y))
+
+        for ty0 in range(coverage.tiles_y):
+            for ty1 in range(ty0 + 1, coverage.tiles_y + 1):
+                for tx0 in range(coverage.tiles_x):
+                    for tx1 in range(tx0 + 1, coverage.tiles_x + 1):
+                        window = values[ty0 * tile:min(ty1 * tile, height), tx0 * tile:min(tx1 * tile, width)]
+                        data = coverage.export(tx0, ty0, tx1, ty1)
+                        self.assertEqual(window.size, len(data), (tx0, ty0, tx1, ty1))
+                        self.assertEqual(window.ravel().tolist(), data.tolist(), (tx0, ty0, tx1, ty1))
+
+        # Beyond the grid the export is clipped
+        self.assertEqual(values.ravel().tolist(), coverage.export(0, 0, 5, 5).tolist())
+
+
+class TestCoverageProgressNode(unittest.TestCase):
+
+    def setUp(self):
+        patcher = mock.patch.object(coverage_progress.rospy, 'get_param', get_param)
+        patcher.start()
+        self.addCleanup(patcher.stop)
+        patcher = mock.patch.object(coverage_progress.rospy.Time, 'now', return_value=coverage_progress.rospy.Time())
+        patcher.start()
+        self.addCleanup(patcher.stop)
+
+        node = coverage_progress.CoverageProgressNode.__new__(coverage_progress.CoverageProgressNode)
+        node._lock = threading.Lock()
+        node.grid = node._initialize_map()
+        node.progress_pub = mock.Mock()
+        node.contributions_pub = mock.Mock()
+        node.grid_pub = mock.Mock()
+        node.grid_pub.get_num_connections.return_value = 0
+        self.node = node
+
+    def update(self, positions):
+        """One tick of the node with the robots at positions, list of (robot index, (x, y))"""
+        lookups = [(robot, (x, y, 0.0)) for robot, (x, y) in positions]
+        with mock.patch.object(self.node, '_lookup_positions', return_value=lookups):
+            self.node._update_callback(None)
+
+    def expected_cells(self, positions):
+        """Cells that the disks at positions cover, the parts outside of the grid left out"""
+        info = self.node.grid.info
+        cells = set()
+        for _, (x, y) in positions:
+            cx = int((x - info.origin.position.x) / info.resolution)
+            cy = int((y - info.origin.position.y) / info.resolution)
+            cells.update((cx + dx, cy + dy) for dx, dy in self.node._disk
+                         if 0 <= cx + dx < info.width and 0 <= cy + dy < info.height)
+        return cells
+
+    def test_out_of_bounds_poses(self):
+        """Disks that stick out of the grid only cover the cells inside of it, poses far outside cover nothing"""
+        info = self.node.grid.info
+        self.assertEqual((160, 100), (info.width, info.height))
+        positions = [(0, (-5.0, -5.0)), (1, (100.0, 2.0))]
+        self.update(positions)
+        self.assertEqual(0, self.node._coverage.covered_count)
+        self.node.progress_pub.publish.assert_called_with(0.0)
+
+        positions = [(0, (0.0, 0.0)), (1, (7.98, 4.98)), (0, (-0.1, 2.5)), (1, (4.0, 5.1))]
+        self.update(positions)
+        cells = self.expected_cells(positions)
+        self.assertTrue(cells)
+        coverage = self.node._coverage
+        self.assertEqual(len(cells), coverage.covered_count)
+        self.assertEqual(len(cells), coverage.count(-100, -100, 1000, 1000))
+        self.assertEqual(len(cells), sum(self.node._contributions))
+        self.node.progress_pub.publish.assert_called_with(float(len(cells)) / (info.width * info.height))
+        for x, y in cells:
+            self.assertEqual(1, coverage.count(x, y, x + 1, y + 1))
+
+    def test_get_coverage_tiles(self):
+        """The tiles that overlap a region are exported with their position, also when the region crosses tile
+        boundaries or sticks out of the grid
+        """
+        self.update([(0, (3.2, 3.2)), (1, (6.4, 1.0))])
+        info = self.node.grid.info
+        tile = coverage_progress.CoverageTiles.TILE
+        full_grid = np.array(self.node._coverage.export(0, 0, 3, 2)).reshape(info.height, info.width)
+        request = mock.Mock()
+        # Region across the boundaries of tile column 1 and 2 and tile row 0 and 1
+        request.min.x, request.min.y = 4.0, 3.0
+        request.max.x, request.max.y = 6.6, 3.3
+        grid = self.node.get_coverage_tiles(request).grid
+        self.assertEqual((info.width - tile, info.height), (grid.info.width, grid.info.height))
+        self.assertAlmostEqual(tile * info.resolution, grid.info.origin.position.x)
+        self.assertAlmostEqual(0.0, grid.info.origin.position.y)
+        self.assertEqual(full_grid[:, tile:].ravel().tolist(), list(grid.data))
+        self.assertTrue((np.array(grid.data) < coverage_progress.CoverageProgressNode.DIRTY).any())
+
+        # Sticking out of the grid, corners swapped
+        request.min.x, request.min.y = 2.0, 10.0
+        request.max.x, request.max.y = -1.0, 0.5
+        grid = self.node.get_coverage_tiles(request).grid
+        self.assertEqual((tile, info.height), (grid.info.width, grid.info.height))
+        self.assertEqual(full_grid[:, :tile].ravel().tolist(), list(grid.data))
+
+        # Outside of the grid
+        request.min.x, request.min.y = -3.0, -3.0
+        request.max.x, request.max.y = -1.0, -1.0
+        grid = self.node.get_coverage_tiles(request).grid
+        self.assertEqual((0, 0), (grid.info.width, grid.info.height))
+
+    def test_reset(self):
+        """After a reset nothing is covered, and covering starts over"""
+        positions = [(0, (1.0, 1.0)), (1, (6.5, 3.2))]
+        self.update(positions)
+        self.assertGreater(self.node._coverage.covered_count, 0)
+        self.node.reset(None)
+        coverage = self.node._coverage
+        self.assertEqual(0, coverage.covered_count)
+        self.assertEqual(0, coverage.count(0, 0, coverage.width, coverage.height))
+        self.assertEqual([0, 0], self.node._contributions)
+
+        self.update(positions[:1])
+        cells = self.expected_cells(positions[:1])
+        self.assertEqual(len(cells), self.node._coverage.covered_count)
+        self.assertEqual([len(cells), 0], self.node._contributions)
+
+
+if __name__ == '__main__':
+    import rosunit
+    rosunit.unitrun(PKG, 'test_coverage_progress', TestCoverageIndex)
+    rosunit.unitrun(PKG, 'test_coverage_progress', TestCoverageTiles)
+    rosunit.unitrun(PKG, 'test_coverage_progress', TestCoverageProgressNode)
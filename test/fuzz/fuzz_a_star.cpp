@@ -0,0 +1,37 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * libFuzzer/AFL++ target: searches for open space from the start of a grid built from the input (see fuzz_grid.h)
+ * and aborts when the search needs more expansions or time than the bounds scaled to the grid size, or returns an
+ * invalid path
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <full_coverage_path_planner/fuzz_grid.h>
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size)
+{
+  static AStarWorkspace workspace;
+  static std::vector<Point_t> open_space;
+  static std::vector<gridNode_t> pathNodes;
+  FuzzGrid fuzz;
+  if (!fuzzGridFromBytes(data, size, fuzz))
+  {
+    return 0;
+  }
+  std::string failure = checkAStar(fuzz, workspace, open_space, pathNodes);
+  if (!failure.empty())
+  {
+    std::cerr << failure << std::endl;
+    abort();
+  }
+  return 0;
+}
@@ -0,0 +1,35 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * libFuzzer/AFL++ target: plans a spiral on a grid built from the input (see fuzz_grid.h) and aborts when the plan
+ * needs more A* expansions or time than the bounds scaled to the grid size
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <full_coverage_path_planner/fuzz_grid.h>
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size)
+{
+  static full_coverage_path_planner::SpiralWorkspace workspace;
+  static std::vector<Point_t> path;
+  FuzzGrid fuzz;
+  if (!fuzzGridFromBytes(data, size, fuzz))
+  {
+    return 0;
+  }
+  std::string failure = checkSpiralStc(fuzz, workspace, path);
+  if (!failure.empty())
+  {
+    std::cerr << failure << std::endl;
+    abort();
+  }
+  return 0;
+}
@@ -0,0 +1,26 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <stddef.h>
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_ALLOCATION_COUNTER_H
+#define FULL_COVERAGE_PATH_PLANNER_ALLOCATION_COUNTER_H
+
+/**
+ * Counts the allocations between its construction and destruction. Link test/src/allocation_counter.cpp, which
+ * replaces the global operator new and delete of the test binary to count them. The replacements are in their own
+ * translation unit, so the compiler never sees a malloc paired with a delete expression
+ */
+class AllocationCounter
+{
+public:
+  AllocationCounter();
+  ~AllocationCounter();
+
+  /**
+   * Allocations since construction
+   */
+  size_t count() const;
+};
+
+#endif  // FULL_COVERAGE_PATH_PLANNER_ALLOCATION_COUNTER_H
@@ -0,0 +1,188 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <full_coverage_path_planner/common.h>
+#include <full_coverage_path_planner/spiral_stc.h>
+
+#ifndef FULL_COVERAGE_PATH_PLANNER_FUZZ_GRID_H
+#define FULL_COVERAGE_PATH_PLANNER_FUZZ_GRID_H
+
+/*
+ * Shared by the fuzz targets in test/fuzz and by test_fuzz_corpus, which replays their corpus as a performance
+ * regression suite. A run that needs more A* expansions or wall time than a bound scaled to the grid size is a
+ * failure, just like a crash.
+ *
+ * Input format: width - 1, height - 1, start x, start y (one byte each, taken modulo the maximum side and the grid
+ * size), followed by the obstacle bits of the grid, row-major and least significant bit first. Missing bits are
+ * free cells, the start cell is always free. The A* target reads a second bitmap after the first one, in which
+ * set bits mark the free cells that are open space (not yet visited).
+ */
+const int kFuzzMaxSide = 64;
+
+struct FuzzGrid
+{
+  std::vector<std::vector<bool> > grid;
+  std::vector<std::vector<bool> > visited;  ///< Only used by the A* target
+  Point_t start;
+};
+
+inline bool fuzzBit(uint8_t const* data, size_t size, size_t bit)
+{
+  return 4 + bit / 8 < size && (data[4 + bit / 8] >> (bit % 8)) & 1;
+}
+
+/**
+ * @return false when the input is too short to hold the header
+ */
+inline bool fuzzGridFromBytes(uint8_t const* data, size_t size, FuzzGrid& fuzz)
+{
+  if (size < 4)
+  {
+    return false;
+  }
+  int width = data[0] % kFuzzMaxSide + 1, height = data[1] % kFuzzMaxSide + 1;
+  size_t cells = static_cast<size_t>(width) * height;
+  size_t visited_offset = (cells + 7) / 8 * 8;
+  fuzz.start.x = data[2] % width;
+  fuzz.start.y = data[3] % height;
+  fuzz.grid.assign(height, std::vector<bool>(width, false));
+  fuzz.visited.assign(height, std::vector<bool>(width, true));
+  for (int y = 0; y < height; ++y)
+  {
+    for (int x = 0; x < width; ++x)
+    {
+      size_t bit = static_cast<size_t>(y) * width + x;
+      fuzz.grid[y][x] = fuzzBit(data, size, bit);
+      fuzz.visited[y][x] = fuzz.grid[y][x] || !fuzzBit(data, size, visited_offset + bit);
+    }
+  }
+  fuzz.grid[fuzz.start.y][fuzz.start.x] = false;
+  fuzz.visited[fuzz.start.y][fuzz.start.x] = true;
+  return true;
+}
+
+/**
+ * Largest acceptable number of A* expansions of a complete spiral_stc plan on a grid with the given number of cells.
+ * A single search expands every cell at most once, but a plan needs a search per pocket the spiral gets stuck in.
+ * The worst maps found so far need about a quarter of this bound on small grids and a tenth on large ones
+ */
+inline uint64_t spiralExpansionBound(size_t cells)
+{
+  return 64 + cells * static_cast<uint64_t>(std::sqrt(static_cast<double>(cells)));
+}
+
+/**
+ * Largest acceptable wall time [s] of a complete spiral_stc plan, every expansion computes the distance to all open
+ * cells. Generous enough for sanitizer builds
+ */
+inline double spiralTimeBound(size_t cells)
+{
+  return 0.1 + 2e-9 * cells * cells * std::sqrt(static_cast<double>(cells));
+}
+
+/**
+ * Largest acceptable number of expansions of a single a_star_to_open_space search: every cell is opened only once
+ */
+inline uint64_t aStarExpansionBound(size_t cells)
+{
+  return cells + 1;
+}
+
+/**
+ * Largest acceptable wall time [s] of a single a_star_to_open_space search, the open list is sorted per expansion
+ */
+inline double aStarTimeBound(size_t cells)
+{
+  return 0.1 + 1e-8 * cells * cells;
+}
+
+inline double fuzzNow()
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/**
+ * Plan a spiral on a fuzz grid and check the bounds
+ * @return empty when the plan is within the bounds, the violated bound otherwise
+ */
+inline std::string checkSpiralStc(FuzzGrid const& fuzz, full_coverage_path_planner::SpiralWorkspace& workspace,
+                                  std::vector<Point_t>& path)
+{
+  size_t cells = fuzz.grid.size() * fuzz.grid[0].size();
+  int multiple_pass_counter, visited_counter;
+  double start = fuzzNow();
+  full_coverage_path_planner::SpiralSTC::spiral_stc(fuzz.grid, fuzz.start, workspace, path, multiple_pass_counter,
+                                                    visited_counter);
+  double elapsed = fuzzNow() - start;
+
+  std::stringstream failure;
+  if (workspace.a_star.expansions > spiralExpansionBound(cells))
+  {
+    failure << "spiral_stc needed " << workspace.a_star.expansions << " A* expansions on " << cells
+            << " cells, more than " << spiralExpansionBound(cells);
+  }
+  else if (elapsed > spiralTimeBound(cells))
+  {
+    failure << "spiral_stc took " << elapsed << " s on " << cells << " cells, more than " << spiralTimeBound(cells);
+  }
+  return failure.str();
+}
+
+/**
+ * Search for open space on a fuzz grid and check the bounds and the path
+ * @return empty when the search is within the bounds, the violated bound otherwise
+ */
+inline std::string checkAStar(FuzzGrid const& fuzz, AStarWorkspace& workspace, std::vector<Point_t>& open_space,
+                              std::vector<gridNode_t>& pathNodes)
+{
+  size_t cells = fuzz.grid.size() * fuzz.grid[0].size();
+  map_2_goals(fuzz.visited, eNodeOpen, open_space);
+  gridNode_t init = { fuzz.start, 0, 0 };
+  pathNodes.assign(1, init);
+  workspace.expansions = 0;
+  double start = fuzzNow();
+  bool resign = a_star_to_open_space(fuzz.grid, init, 1, fuzz.visited, open_space, workspace, pathNodes);
+  double elapsed = fuzzNow() - start;
+
+  std::stringstream failure;
+  if (workspace.expansions > aStarExpansionBound(cells))
+  {
+    failure << "A* needed " << workspace.expansions << " expansions on " << cells << " cells, more than "
+            << aStarExpansionBound(cells);
+  }
+  else if (elapsed > aStarTimeBound(cells))
+  {
+    failure << "A* took " << elapsed << " s on " << cells << " cells, more than " << aStarTimeBound(cells);
+  }
+  else if (!resign)
+  {
+    // pathNodes is the initial node followed by a 4-connected path from init to open space
+    Point_t end = pathNodes.back().pos;
+    if (pathNodes.size() < 3 || fuzz.visited[end.y][end.x] != eNodeOpen)
+    {
+      failure << "A* path does not end in open space";
+    }
+    for (size_t i = 2; i < pathNodes.size() && failure.str().empty(); ++i)
+    {
+      Point_t a = pathNodes[i - 1].pos, b = pathNodes[i].pos;
+      if (std::abs(a.x - b.x) + std::abs(a.y - b.y) != 1 || fuzz.grid[b.y][b.x])
+      {
+        failure << "A* path is not connected through free cells at node " << i;
+      }
+    }
+  }
+  return failure.str();
+}
+#endif  // FULL_COVERAGE_PATH_PLANNER_FUZZ_GRID_H
@@ -0,0 +1,59 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <stdlib.h>
+
+#include <new>
+
+#include <full_coverage_path_planner/allocation_counter.h>
+
+namespace
+{
+bool count_allocations = false;
+size_t allocation_count = 0;
+}  // namespace
+
+AllocationCounter::AllocationCounter()
+{
+  allocation_count = 0;
+  count_allocations = true;
+}
+
+AllocationCounter::~AllocationCounter()
+{
+  count_allocations = false;
+}
+
+size_t AllocationCounter::count() const
+{
+  return allocation_count;
+}
+
+void* operator new(size_t size)
+{
+  if (count_allocations)
+  {
+    ++allocation_count;
+  }
+  void* p = malloc(size ? size : 1);
+  if (!p)
+  {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept
+{
+  free(p);
+}
+
+void* operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete[](void* p) noexcept
+{
+  operator delete(p);
+}
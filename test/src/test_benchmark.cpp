@@ -0,0 +1,226 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * Tests for the helpers of the quality-versus-runtime benchmark
+ */
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <list>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <full_coverage_path_planner/benchmark.h>
+#include <full_coverage_path_planner/perf_counters.h>
+
+using full_coverage_path_planner::BenchmarkConfig;
+using full_coverage_path_planner::BenchmarkResult;
+using full_coverage_path_planner::PerfCounts;
+using full_coverage_path_planner::Waypoint;
+
+BenchmarkResult makeResult(std::string const& map, std::string const& name, double wall_time, double length)
+{
+  BenchmarkResult result;
+  result.map = map;
+  result.config = full_coverage_path_planner::defaultBenchmarkConfigs(0.3, 0.3)[0];
+  result.config.name = name;
+  result.metrics.success = true;
+  result.metrics.wall_time_s = wall_time;
+  result.metrics.parse_time_s = 0.0;
+  result.metrics.peak_memory_kb = 1000;
+  result.metrics.path_length_m = length;
+  result.metrics.total_rotation_rad = 0.0;
+  result.metrics.turns = 10;
+  result.metrics.waypoint_count = 100;
+  result.metrics.multiple_pass_counter = 0;
+  result.metrics.accessible_counter = 50;
+  result.metrics.grid_cells = 100;
+  for (int p = 0; p < full_coverage_path_planner::ePhaseCount; ++p)
+  {
+    result.metrics.counts[p] = full_coverage_path_planner::noPerfCounts();
+  }
+  result.pareto = false;
+  return result;
+}
+
+/*
+ * Configurations are parsed from key=value lists, unknown keys and values are rejected
+ */
+TEST(TestBenchmark, testParseConfig)
+{
+  BenchmarkConfig config = full_coverage_path_planner::defaultBenchmarkConfigs(0.3, 0.3)[0];
+  config.name.clear();
+  ASSERT_TRUE(full_coverage_path_planner::parseBenchmarkConfig("tool_radius=0.5,join_style=mwm", config));
+  EXPECT_EQ("tool_radius=0.5,join_style=mwm", config.name);
+  EXPECT_DOUBLE_EQ(0.5, config.tool_radius);
+  EXPECT_DOUBLE_EQ(0.3, config.robot_radius);
+  EXPECT_EQ("mwm", config.join_style);
+  EXPECT_EQ("square", config.footprint_model);
+
+  ASSERT_TRUE(full_coverage_path_planner::parseBenchmarkConfig("name=round,footprint_model=circle", config));
+  EXPECT_EQ("round", config.name);
+  EXPECT_EQ("circle", config.footprint_model);
+
+  EXPECT_FALSE(full_coverage_path_planner::parseBenchmarkConfig("join_style=zigzag", config));
+  EXPECT_FALSE(full_coverage_path_planner::parseBenchmarkConfig("speed=1", config));
+  EXPECT_FALSE(full_coverage_path_planner::parseBenchmarkConfig("tool_radius", config));
+}
+
+/*
+ * Turns are direction changes of the walk, repeated tiles are ignored
+ */
+TEST(TestBenchmark, testCountTurns)
+{
+  std::list<Point_t> walk;
+  Point_t points[] = { { 0, 0 }, { 1, 0 }, { 2, 0 }, { 2, 0 }, { 2, 1 }, { 1, 1 }, { 0, 1 } };
+  walk.assign(points, points + 7);
+  EXPECT_EQ(2, full_coverage_path_planner::countTurns(walk));
+  EXPECT_EQ(0, full_coverage_path_planner::countTurns(std::list<Point_t>()));
+}
+
+/*
+ * Path length and rotation of an L-shaped plan
+ */
+TEST(TestBenchmark, testMeasurePlan)
+{
+  Waypoint points[] = { { 0.0, 0.0, 0.0 }, { 3.0, 0.0, 0.0 }, { 3.0, 4.0, M_PI / 2 } };
+  std::vector<Waypoint> plan(points, points + 3);
+  full_coverage_path_planner::BenchmarkMetrics metrics;
+  full_coverage_path_planner::measurePlan(plan, metrics);
+  EXPECT_DOUBLE_EQ(7.0, metrics.path_length_m);
+  EXPECT_DOUBLE_EQ(M_PI / 2, metrics.total_rotation_rad);
+  EXPECT_EQ(3, metrics.waypoint_count);
+}
+
+/*
+ * Only results that are not dominated on their own map are on the Pareto front
+ */
+TEST(TestBenchmark, testParetoFront)
+{
+  std::vector<BenchmarkResult> results;
+  results.push_back(makeResult("a", "fast", 1.0, 20.0));
+  results.push_back(makeResult("a", "short", 2.0, 10.0));
+  results.push_back(makeResult("a", "dominated", 2.0, 20.0));
+  results.push_back(makeResult("b", "slow", 5.0, 50.0));
+  results.push_back(makeResult("a", "failed", 0.0, 0.0));
+  results.back().metrics.success = false;
+  // Slower than fast, but it needs less memory
+  results.push_back(makeResult("a", "lean", 2.0, 20.0));
+  results.back().metrics.peak_memory_kb = 500;
+  full_coverage_path_planner::markParetoFront(results);
+  EXPECT_TRUE(results[0].pareto);
+  EXPECT_TRUE(results[1].pareto);
+  EXPECT_FALSE(results[2].pareto);
+  EXPECT_TRUE(results[3].pareto);
+  EXPECT_FALSE(results[4].pareto);
+  EXPECT_TRUE(results[5].pareto);
+}
+
+/*
+ * CSV has a header and a row per result, JSON an object per result
+ */
+TEST(TestBenchmark, testOutput)
+{
+  std::vector<BenchmarkResult> results;
+  results.push_back(makeResult("a", "fast", 1.0, 20.0));
+  results.push_back(makeResult("b", "quote\"d", 2.0, 10.0));
+
+  std::stringstream csv;
+  full_coverage_path_planner::writeCsv(csv, results);
+  std::string line;
+  int lines = 0;
+  while (std::getline(csv, line))
+  {
+    ++lines;
+  }
+  EXPECT_EQ(3, lines);
+
+  std::stringstream json;
+  full_coverage_path_planner::writeJson(json, results);
+  EXPECT_EQ(0u, json.str().find("[\n  {\"map\": \"a\""));
+  EXPECT_NE(std::string::npos, json.str().find("\"config\": \"quote\\\"d\""));
+}
+
+/*
+ * Counter columns are in the CSV of every result, -1 when not counted; JSON has null counters then
+ */
+TEST(TestBenchmark, testCounterOutput)
+{
+  std::vector<BenchmarkResult> results;
+  results.push_back(makeResult("a", "counted", 1.0, 20.0));
+  for (int p = 0; p < full_coverage_path_planner::ePhaseCount; ++p)
+  {
+    for (int e = 0; e < full_coverage_path_planner::ePerfEventCount; ++e)
+    {
+      results[0].metrics.counts[p].values[e] = 1000 * (p + 1) + e;
+    }
+  }
+  PerfCounts& a_star = results[0].metrics.counts[full_coverage_path_planner::ePhaseAStar];
+  a_star.values[full_coverage_path_planner::ePerfLlcMisses] = -1;
+  results.push_back(makeResult("a", "timed", 2.0, 10.0));
+
+  std::stringstream csv;
+  full_coverage_path_planner::writeCsv(csv, results);
+  std::string header, counted, timed;
+  std::getline(csv, header);
+  std::getline(csv, counted);
+  std::getline(csv, timed);
+  EXPECT_NE(std::string::npos, header.find(",a_star_branch_misses,"));
+  EXPECT_EQ(std::count(header.begin(), header.end(), ','), std::count(counted.begin(), counted.end(), ','));
+  EXPECT_EQ(std::count(header.begin(), header.end(), ','), std::count(timed.begin(), timed.end(), ','));
+  EXPECT_NE(std::string::npos, counted.find(",100,1000,1001,"));
+  EXPECT_NE(std::string::npos, timed.find(",100,-1,-1,"));
+
+  std::stringstream json;
+  full_coverage_path_planner::writeJson(json, results);
+  EXPECT_NE(std::string::npos, json.str().find("\"a_star\": {\"cycles\": 3000, \"instructions\": 3001, "
+                                               "\"l1d_misses\": 3002, \"llc_misses\": null"));
+  EXPECT_NE(std::string::npos, json.str().find("\"counters\": null"));
+
+  // Per cell, and only for the result that has counters
+  std::stringstream summary;
+  full_coverage_path_planner::writeCounterSummary(summary, results);
+  EXPECT_NE(std::string::npos, summary.str().find("  parse: 10 cycles, 10.01 instructions"));
+  EXPECT_NE(std::string::npos, summary.str().find("n/a llc_misses"));
+  EXPECT_EQ(std::string::npos, summary.str().find("timed"));
+}
+
+/*
+ * Counts only go up and a known loop takes at least one instruction per iteration. Skipped without hardware
+ * counters (e.g. in a virtual machine or with a high perf_event_paranoid)
+ */
+TEST(TestBenchmark, testPerfCounters)
+{
+  full_coverage_path_planner::PerfCounters counters;
+  if (!counters.open())
+  {
+    std::cerr << "Hardware counters not available, skipping" << std::endl;
+    return;
+  }
+  PerfCounts before, after;
+  ASSERT_TRUE(counters.read(before));
+  volatile int64_t sum = 0;
+  for (int i = 0; i < 1000000; ++i)
+  {
+    sum += i;
+  }
+  ASSERT_TRUE(counters.read(after));
+  PerfCounts difference = full_coverage_path_planner::perfDifference(before, after);
+  EXPECT_GT(difference.values[full_coverage_path_planner::ePerfCycles], 0);
+  EXPECT_GE(difference.values[full_coverage_path_planner::ePerfInstructions], 1000000);
+  for (int e = 0; e < full_coverage_path_planner::ePerfEventCount; ++e)
+  {
+    EXPECT_GE(difference.values[e], before.values[e] < 0 ? -1 : 0) << full_coverage_path_planner::perfEventName(e);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
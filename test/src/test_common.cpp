@@ -280,6 +280,80 @@ TEST(TestMap_2_goals, testCoordinateOrder)
   ASSERT_EQ(corner0.y, goals.front().y);
 }
 
+/*
+ * Cells with their center inside an axis aligned rectangle stay open, all others are blocked
+ */
+TEST(TestMaskOutsidePolygon, testRectangle)
+{
+  /* Polygon from (1, 1) to (3, 4) in a 5x5 grid, so the centers of columns 1..2 and rows 1..3 are inside
+   * [1 1 1 1 1]
+   * [1 0 0 1 1]
+   * [1 0 0 1 1]
+   * [1 0 0 1 1]
+   * [1 1 1 1 1]
+   */
+  std::vector<std::vector<bool> > grid = makeTestGrid(5, 5, false);
+  std::vector<fPoint_t> polygon;
+  polygon.push_back({1.0f, 1.0f});  // NOLINT
+  polygon.push_back({3.0f, 1.0f});  // NOLINT
+  polygon.push_back({3.0f, 4.0f});  // NOLINT
+  polygon.push_back({1.0f, 4.0f});  // NOLINT
+
+  maskOutsidePolygon(grid, polygon);
+
+  ASSERT_EQ(2 * 3, map_2_goals(grid, false).size());
+  for (int y = 0; y < 5; ++y)
+  {
+    for (int x = 0; x < 5; ++x)
+    {
+      bool inside = x >= 1 && x <= 2 && y >= 1 && y <= 3;
+      ASSERT_EQ(!inside, grid[y][x]) << "(" << x << ", " << y << ")";
+    }
+  }
+}
+
+/*
+ * Obstacles inside the polygon stay obstacles
+ */
+TEST(TestMaskOutsidePolygon, testTriangleKeepsObstacles)
+{
+  /* Triangle (0, 0), (4, 0), (0, 4): the cells with x + y < 3 have their center inside
+   * [1 1 1 1]
+   * [0 1 1 1]
+   * [0 1 1 1]
+   * [0 0 0 1]
+   */
+  std::vector<std::vector<bool> > grid = makeTestGrid(4, 4, false);
+  grid[1][1] = true;
+  std::vector<fPoint_t> polygon;
+  polygon.push_back({0.0f, 0.0f});  // NOLINT
+  polygon.push_back({4.0f, 0.0f});  // NOLINT
+  polygon.push_back({0.0f, 4.0f});  // NOLINT
+
+  maskOutsidePolygon(grid, polygon);
+
+  ASSERT_TRUE(grid[1][1]);
+  ASSERT_FALSE(grid[0][2]);
+  ASSERT_TRUE(grid[0][3]);
+  ASSERT_EQ(6 - 1, map_2_goals(grid, false).size());
+}
+
+/*
+ * A polygon that extends beyond the grid is clipped to the grid
+ */
+TEST(TestMaskOutsidePolygon, testLargePolygon)
+{
+  std::vector<std::vector<bool> > grid = makeTestGrid(4, 3, false);
+  std::vector<fPoint_t> polygon;
+  polygon.push_back({-10.0f, -10.0f});  // NOLINT
+  polygon.push_back({20.0f, -10.0f});  // NOLINT
+  polygon.push_back({-10.0f, 20.0f});  // NOLINT
+
+  maskOutsidePolygon(grid, polygon);
+
+  ASSERT_EQ(4 * 3, map_2_goals(grid, false).size());
+}
+
 /* LEGENDA
  * Note: in tests for the A* path finding algorithm, use this legend for the maps:
  * s: start
@@ -0,0 +1,147 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * Tests for the run-length encoded compact coverage plan
+ */
+#include <cmath>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <full_coverage_path_planner/common.h>
+#include <full_coverage_path_planner/compact_plan.h>
+
+using full_coverage_path_planner::CompactPlanDecoder;
+using full_coverage_path_planner::CompactPose;
+
+std::list<Point_t> makeWalk(int const coordinates[][2], int n)
+{
+  std::list<Point_t> walk;
+  for (int i = 0; i < n; ++i)
+  {
+    Point_t p = { coordinates[i][0], coordinates[i][1] };
+    walk.push_back(p);
+  }
+  return walk;
+}
+
+/*
+ * Runs of equal steps are merged, repeated tiles are skipped
+ */
+TEST(TestCompactPlan, testEncode)
+{
+  int coordinates[][2] = { { 0, 0 }, { 1, 0 }, { 2, 0 }, { 2, 0 }, { 2, 1 }, { 1, 1 }, { 0, 1 } };  // NOLINT
+  std::list<Point_t> walk = makeWalk(coordinates, 7);
+  EXPECT_EQ("R2U1L2", full_coverage_path_planner::encodeDirections(walk.begin(), walk.end()));
+  EXPECT_EQ(6, CompactPlanDecoder::tileCount("R2U1L2"));
+
+  std::list<Point_t> single(1, walk.front());
+  EXPECT_EQ("", full_coverage_path_planner::encodeDirections(single.begin(), single.end()));
+}
+
+/*
+ * Decoding a tile walk gives a pose at the center of every tile, heading along the walk
+ */
+TEST(TestCompactPlan, testDecodePerTile)
+{
+  int coordinates[][2] = { { 3, 4 }, { 4, 4 }, { 5, 4 }, { 5, 5 }, { 4, 5 } };  // NOLINT
+  std::list<Point_t> walk = makeWalk(coordinates, 5);
+  std::string directions = full_coverage_path_planner::encodeDirections(walk.begin(), walk.end());
+
+  CompactPlanDecoder decoder(10.0, 20.0, 0.5, 3, 4, directions);
+  std::vector<CompactPose> poses;
+  decoder.expand(poses);
+
+  EXPECT_TRUE(decoder.valid());
+  ASSERT_EQ(walk.size(), poses.size());
+  std::list<Point_t>::const_iterator it = walk.begin();
+  for (unsigned int i = 0; i < poses.size(); ++i, ++it)
+  {
+    EXPECT_DOUBLE_EQ(10.0 + it->x * 0.5 + 0.25, poses[i].x);
+    EXPECT_DOUBLE_EQ(20.0 + it->y * 0.5 + 0.25, poses[i].y);
+  }
+  EXPECT_DOUBLE_EQ(0.0, poses[0].yaw);
+  EXPECT_DOUBLE_EQ(M_PI / 2, poses[3].yaw);
+  EXPECT_DOUBLE_EQ(M_PI, poses[4].yaw);
+}
+
+/*
+ * In corner mode, like the Path plan, corners are emitted twice: with the incoming and with the outgoing heading
+ */
+TEST(TestCompactPlan, testDecodeCorners)
+{
+  CompactPlanDecoder decoder(0.0, 0.0, 1.0, 0, 0, "R2U1", CompactPlanDecoder::ePosesAtCorners);
+  std::vector<CompactPose> poses;
+  decoder.expand(poses);
+
+  ASSERT_EQ(4, poses.size());
+  EXPECT_DOUBLE_EQ(0.5, poses[0].x);
+  EXPECT_DOUBLE_EQ(2.5, poses[1].x);
+  EXPECT_DOUBLE_EQ(0.0, poses[1].yaw);
+  EXPECT_DOUBLE_EQ(2.5, poses[2].x);
+  EXPECT_DOUBLE_EQ(M_PI / 2, poses[2].yaw);
+  EXPECT_DOUBLE_EQ(1.5, poses[3].y);
+  EXPECT_DOUBLE_EQ(M_PI / 2, poses[3].yaw);
+}
+
+/*
+ * Decoding stops at a malformed run
+ */
+TEST(TestCompactPlan, testMalformed)
+{
+  CompactPlanDecoder decoder(0.0, 0.0, 1.0, 0, 0, "R2X3");
+  std::vector<CompactPose> poses;
+  decoder.expand(poses);
+  EXPECT_FALSE(decoder.valid());
+  EXPECT_EQ(3, poses.size());
+
+  EXPECT_EQ(0, CompactPlanDecoder::tileCount("R"));
+  EXPECT_EQ(0, CompactPlanDecoder::tileCount("R0"));
+  EXPECT_EQ(0, CompactPlanDecoder::tileCount("U99999999999"));
+}
+
+/*
+ * A random walk survives encoding and decoding and its encoding is much smaller than the walk
+ */
+TEST(TestCompactPlan, testRoundTrip)
+{
+  std::list<Point_t> walk;
+  Point_t p = { 0, 0 };
+  walk.push_back(p);
+  srand(42);
+  for (int i = 0; i < 1000; ++i)
+  {
+    int direction = rand() % 4;  // NOLINT
+    int steps = 1 + rand() % 20;  // NOLINT
+    for (int k = 0; k < steps; ++k)
+    {
+      p.x += direction == 0 ? 1 : direction == 2 ? -1 : 0;
+      p.y += direction == 1 ? 1 : direction == 3 ? -1 : 0;
+      walk.push_back(p);
+    }
+  }
+  std::string directions = full_coverage_path_planner::encodeDirections(walk.begin(), walk.end());
+  EXPECT_LT(directions.size() * 3, walk.size());
+
+  CompactPlanDecoder decoder(0.0, 0.0, 1.0, 0, 0, directions);
+  CompactPose pose;
+  for (std::list<Point_t>::const_iterator it = walk.begin(); it != walk.end(); ++it)
+  {
+    ASSERT_TRUE(decoder.next(pose));
+    EXPECT_DOUBLE_EQ(it->x + 0.5, pose.x);
+    EXPECT_DOUBLE_EQ(it->y + 0.5, pose.y);
+  }
+  EXPECT_FALSE(decoder.next(pose));
+  EXPECT_TRUE(decoder.valid());
+}
+
+// Run all the tests that were declared with TEST()
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,167 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <stdlib.h>
+
+#include <cstdlib>
+#include <list>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <full_coverage_path_planner/common.h>
+#include <full_coverage_path_planner/contour_coverage.h>
+#include <full_coverage_path_planner/util.h>
+
+using full_coverage_path_planner::ContourWorkspace;
+
+namespace
+{
+/*
+ * Number of free tiles that can be reached from start, by flood fill
+ */
+int reachableCount(std::vector<std::vector<bool> > const& grid, Point_t start)
+{
+  std::vector<std::vector<bool> > seen = grid;
+  std::list<Point_t> queue(1, start);
+  seen[start.y][start.x] = true;
+  int count = 0;
+  while (!queue.empty())
+  {
+    Point_t p = queue.front();
+    queue.pop_front();
+    ++count;
+    Point_t neighbours[4] = { { p.x + 1, p.y }, { p.x - 1, p.y }, { p.x, p.y + 1 }, { p.x, p.y - 1 } };
+    for (int i = 0; i < 4; ++i)
+    {
+      Point_t n = neighbours[i];
+      if (n.x >= 0 && n.x < static_cast<int>(grid[0].size()) && n.y >= 0 && n.y < static_cast<int>(grid.size()) &&
+          !seen[n.y][n.x])
+      {
+        seen[n.y][n.x] = true;
+        queue.push_back(n);
+      }
+    }
+  }
+  return count;
+}
+
+/*
+ * The walk starts at start, is 4-connected over free tiles and covers every reachable tile.
+ * The counters match the walk
+ */
+void expectCompleteWalk(std::vector<std::vector<bool> > const& grid, Point_t start, std::vector<Point_t> const& path,
+                        int multiple_pass_counter, int visited_counter)
+{
+  ASSERT_FALSE(path.empty());
+  EXPECT_EQ(start, path.front());
+  std::vector<std::vector<bool> > covered(grid.size(), std::vector<bool>(grid[0].size(), false));
+  int covered_count = 0;
+  for (size_t i = 0; i < path.size(); ++i)
+  {
+    Point_t p = path[i];
+    ASSERT_FALSE(grid[p.y][p.x]) << "tile " << i << " is blocked";
+    if (i > 0)
+    {
+      ASSERT_EQ(1, std::abs(p.x - path[i - 1].x) + std::abs(p.y - path[i - 1].y)) << "step " << i;
+    }
+    covered_count += !covered[p.y][p.x];
+    covered[p.y][p.x] = true;
+  }
+  EXPECT_EQ(reachableCount(grid, start), covered_count);
+  EXPECT_EQ(static_cast<int>(path.size()), visited_counter);
+  EXPECT_EQ(visited_counter - covered_count, multiple_pass_counter);
+}
+}  // namespace
+
+/*
+ * Layers of an empty grid are the rings from the border inwards, an obstacle starts new rings around it
+ */
+TEST(TestContourCoverage, testLayers)
+{
+  std::vector<std::vector<bool> > grid = makeTestGrid(5, 5, false);
+  std::vector<int> layers;
+  full_coverage_path_planner::contourLayers(grid, layers);
+  int expected[25] =
+  {
+    1, 1, 1, 1, 1,
+    1, 2, 2, 2, 1,
+    1, 2, 3, 2, 1,
+    1, 2, 2, 2, 1,
+    1, 1, 1, 1, 1,
+  };
+  EXPECT_EQ(std::vector<int>(expected, expected + 25), layers);
+
+  grid = makeTestGrid(7, 5, false);
+  grid[2][5] = true;
+  full_coverage_path_planner::contourLayers(grid, layers);
+  int expected_obstacle[35] =
+  {
+    1, 1, 1, 1, 1, 1, 1,
+    1, 2, 2, 2, 1, 1, 1,
+    1, 2, 3, 2, 1, 0, 1,
+    1, 2, 2, 2, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1,
+  };
+  EXPECT_EQ(std::vector<int>(expected_obstacle, expected_obstacle + 35), layers);
+}
+
+/*
+ * An empty rectangle is covered by concentric loops, stepping inwards without any connector
+ */
+TEST(TestContourCoverage, testConcentricLoops)
+{
+  ContourWorkspace workspace;
+  std::vector<Point_t> path;
+  int sizes[][2] = { { 5, 5 }, { 8, 6 }, { 12, 7 }, { 3, 9 } };
+  for (int i = 0; i < 4; ++i)
+  {
+    std::vector<std::vector<bool> > grid = makeTestGrid(sizes[i][0], sizes[i][1], false);
+    Point_t start = { 0, 0 };
+    int multiple_pass_counter, visited_counter;
+    full_coverage_path_planner::contourCoverage(grid, start, workspace, path, multiple_pass_counter,
+                                                visited_counter);
+    expectCompleteWalk(grid, start, path, multiple_pass_counter, visited_counter);
+    EXPECT_EQ(0, multiple_pass_counter) << sizes[i][0] << "x" << sizes[i][1];
+
+    // The first loop follows the border counter-clockwise
+    ASSERT_GT(path.size(), 1u);
+    Point_t second = { 1, 0 };
+    EXPECT_EQ(second, path[1]);
+  }
+}
+
+/*
+ * Grids with obstacles and walls are covered completely, also from a start in a different room
+ */
+TEST(TestContourCoverage, testRandomGrids)
+{
+  ContourWorkspace workspace;
+  std::vector<Point_t> path;
+  for (unsigned int seed = 1; seed <= 20; ++seed)
+  {
+    unsigned int s = seed;
+    int width = 10 + seed, height = 30 - seed;
+    std::vector<std::vector<bool> > grid = makeTestGrid(width, height, false);
+    for (int i = 0; i < width * height / 5; ++i)
+    {
+      grid[rand_r(&s) % height][rand_r(&s) % width] = true;
+    }
+    for (int y = 0; y < height - 3; ++y)
+    {
+      grid[y][width / 2] = true;
+    }
+    Point_t start = { width - 1, 0 };
+    grid[start.y][start.x] = false;
+    int multiple_pass_counter, visited_counter;
+    full_coverage_path_planner::contourCoverage(grid, start, workspace, path, multiple_pass_counter,
+                                                visited_counter);
+    expectCompleteWalk(grid, start, path, multiple_pass_counter, visited_counter);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,124 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * Tests for the conversion of a costmap into the tile grid of the Nav2 plugin
+ */
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <full_coverage_path_planner/costmap_grid.h>
+
+using full_coverage_path_planner::TileGeometry;
+using full_coverage_path_planner::eFootprintSquare;
+
+namespace
+{
+// Costs of nav2_costmap_2d/cost_values.hpp
+const unsigned char kFreeSpace = 0;
+const unsigned char kInscribedObstacle = 253;
+const unsigned char kLethalObstacle = 254;
+const unsigned char kNoInformation = 255;
+}  // namespace
+
+/*
+ * Only the lethal cost is an obstacle, the inscribed and unknown costs are free like every other cost
+ */
+TEST(TestCostmapGrid, testLethalThreshold)
+{
+  unsigned char costs[] = { kFreeSpace, 1, 128, 252, kInscribedObstacle, kLethalObstacle, kNoInformation };
+  std::vector<int8_t> occupancy(20, 42);
+  full_coverage_path_planner::costsToOccupancy(costs, 7, kLethalObstacle, occupancy);
+  int8_t expected[] = { 0, 0, 0, 0, 0, 100, 0 };
+  EXPECT_EQ(std::vector<int8_t>(expected, expected + 7), occupancy);
+  EXPECT_GT(occupancy[5], full_coverage_path_planner::kOccupiedThreshold);
+}
+
+/*
+ * Only the tile of the lethal cell is blocked, a square footprint as large as a tile does not reach its neighbours
+ */
+TEST(TestCostmapGrid, testTiles)
+{
+  // 20 x 10 cells of 10 cm, a tile is 4 x 4 cells, the footprint too
+  int width = 20, height = 10;
+  std::vector<unsigned char> costs(width * height, kFreeSpace);
+  costs[5 * width + 9] = kLethalObstacle;
+  costs[1 * width + 1] = kInscribedObstacle;
+  costs[8 * width + 17] = kNoInformation;
+  std::vector<int8_t> occupancy;
+  full_coverage_path_planner::costsToOccupancy(costs.data(), costs.size(), kLethalObstacle, occupancy);
+
+  TileGeometry geometry;
+  std::vector<std::vector<bool> > grid(7, std::vector<bool>(2, true));
+  ASSERT_TRUE(full_coverage_path_planner::occupancyToTiles(occupancy.data(), width, height, 0.1, -1.0, 2.0, 0.2, 0.2,
+                                                           eFootprintSquare, geometry, grid));
+  EXPECT_DOUBLE_EQ(0.4, geometry.tile_size);
+  EXPECT_DOUBLE_EQ(-1.0, geometry.origin_x);
+  EXPECT_DOUBLE_EQ(2.0, geometry.origin_y);
+  EXPECT_EQ(5, geometry.columns);
+  EXPECT_EQ(3, geometry.rows);
+  ASSERT_EQ(3u, grid.size());
+  for (int y = 0; y < 3; ++y)
+  {
+    ASSERT_EQ(5u, grid[y].size());
+    for (int x = 0; x < 5; ++x)
+    {
+      EXPECT_EQ(x == 2 && y == 1, grid[y][x]) << x << ", " << y;
+    }
+  }
+
+  EXPECT_FALSE(full_coverage_path_planner::occupancyToTiles(occupancy.data(), 0, height, 0.1, 0.0, 0.0, 0.2, 0.2,
+                                                            eFootprintSquare, geometry, grid));
+}
+
+/*
+ * Positions map to the tile that contains them, clamped to the grid, and tiles back to their centers
+ */
+TEST(TestCostmapGrid, testTransforms)
+{
+  TileGeometry geometry = { 0.4, -1.0, 2.0, 5, 3 };
+  Point_t tile = full_coverage_path_planner::worldToTile(geometry, -0.9, 2.1);
+  EXPECT_EQ(0, tile.x);
+  EXPECT_EQ(0, tile.y);
+  tile = full_coverage_path_planner::worldToTile(geometry, 0.0, 2.5);
+  EXPECT_EQ(2, tile.x);
+  EXPECT_EQ(1, tile.y);
+  tile = full_coverage_path_planner::worldToTile(geometry, -0.61, 3.19);
+  EXPECT_EQ(0, tile.x);
+  EXPECT_EQ(2, tile.y);
+
+  // Outside of the grid
+  tile = full_coverage_path_planner::worldToTile(geometry, -1.3, 1.5);
+  EXPECT_EQ(0, tile.x);
+  EXPECT_EQ(0, tile.y);
+  tile = full_coverage_path_planner::worldToTile(geometry, 5.0, 10.0);
+  EXPECT_EQ(4, tile.x);
+  EXPECT_EQ(2, tile.y);
+
+  double x, y;
+  Point_t corner = { 4, 2 };
+  full_coverage_path_planner::tileToWorld(geometry, corner, x, y);
+  EXPECT_DOUBLE_EQ(0.8, x);
+  EXPECT_DOUBLE_EQ(3.0, y);
+
+  // Round trip
+  for (int ty = 0; ty < geometry.rows; ++ty)
+  {
+    for (int tx = 0; tx < geometry.columns; ++tx)
+    {
+      Point_t p = { tx, ty };
+      full_coverage_path_planner::tileToWorld(geometry, p, x, y);
+      Point_t back = full_coverage_path_planner::worldToTile(geometry, x, y);
+      EXPECT_EQ(tx, back.x);
+      EXPECT_EQ(ty, back.y);
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
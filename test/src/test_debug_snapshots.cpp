@@ -0,0 +1,187 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * Tests for the debug snapshots of the spiral_stc search
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <full_coverage_path_planner/debug_snapshots.h>
+#include <full_coverage_path_planner/interval_grid.h>
+#include <full_coverage_path_planner/spiral_coverage.h>
+#include <full_coverage_path_planner/util.h>
+
+using full_coverage_path_planner::AsyncSnapshotWriter;
+using full_coverage_path_planner::DebugSnapshot;
+using full_coverage_path_planner::IntervalGrid;
+using full_coverage_path_planner::IntervalSpiralWorkspace;
+using full_coverage_path_planner::SpiralWorkspace;
+
+namespace
+{
+std::string testDirectory(std::string const& name)
+{
+  std::stringstream directory;
+  directory << "/tmp/test_debug_snapshots_" << name << "_" << getpid();
+  return directory.str();
+}
+
+/*
+ * Grid with a pseudo-random fraction of obstacles, the start tile (0, 0) is free
+ */
+std::vector<std::vector<bool> > makeGrid(int width, int height, unsigned int seed)
+{
+  std::vector<std::vector<bool> > grid = makeTestGrid(width, height, false);
+  for (int i = 0; i < width * height / 5; ++i)
+  {
+    grid[rand_r(&seed) % height][rand_r(&seed) % width] = true;
+  }
+  grid[0][0] = false;
+  return grid;
+}
+
+/*
+ * Plan on the grid with snapshots in the log format and read them back
+ */
+std::vector<DebugSnapshot> planWithSnapshots(std::vector<std::vector<bool> > const& grid, bool sparse,
+                                             std::string const& directory)
+{
+  AsyncSnapshotWriter writer;
+  EXPECT_TRUE(writer.open(directory, AsyncSnapshotWriter::eLog, 256));
+  writer.setEnabled(true);
+  Point_t start = { 0, 0 };
+  std::vector<Point_t> path;
+  int multiple_pass_counter, visited_counter;
+  if (sparse)
+  {
+    IntervalGrid intervals;
+    intervals.assign(grid);
+    IntervalSpiralWorkspace workspace;
+    workspace.snapshots = &writer;
+    spiralCoverage(intervals, start, workspace, path, multiple_pass_counter, visited_counter);
+  }
+  else
+  {
+    SpiralWorkspace workspace;
+    workspace.snapshots = &writer;
+    spiralCoverage(grid, start, workspace, path, multiple_pass_counter, visited_counter);
+  }
+  writer.close();
+  EXPECT_EQ(0u, writer.dropped());
+
+  std::vector<DebugSnapshot> snapshots;
+  EXPECT_TRUE(full_coverage_path_planner::readSnapshotLog(directory + "/snapshots.fcppsnap", snapshots));
+  unlink((directory + "/snapshots.fcppsnap").c_str());
+  rmdir(directory.c_str());
+  return snapshots;
+}
+}  // namespace
+
+/*
+ * The log holds the start, then a spiral after the start and after every escape, all numbered in order.
+ * The buffers are plenty for this grid, so nothing is dropped
+ */
+TEST(TestDebugSnapshots, testLogStages)
+{
+  std::vector<std::vector<bool> > grid = makeGrid(30, 20, 7);
+  std::vector<DebugSnapshot> snapshots = planWithSnapshots(grid, false, testDirectory("stages"));
+  ASSERT_GE(snapshots.size(), 2u);
+  for (size_t i = 0; i < snapshots.size(); ++i)
+  {
+    EXPECT_EQ(1u, snapshots[i].header.plan);
+    EXPECT_EQ(i, snapshots[i].header.sequence);
+    EXPECT_EQ(30u, snapshots[i].header.width);
+    EXPECT_EQ(20u, snapshots[i].header.height);
+    int expected = i == 0 ? full_coverage_path_planner::eSnapshotStart :
+                   i % 2 ? full_coverage_path_planner::eSnapshotSpiral : full_coverage_path_planner::eSnapshotEscape;
+    EXPECT_EQ(expected, snapshots[i].header.stage) << "snapshot " << i;
+    EXPECT_EQ(snapshots[i].header.segment_count, snapshots[i].segment.size());
+  }
+  ASSERT_EQ(1u, snapshots[0].segment.size());
+  EXPECT_EQ(0, snapshots[0].segment[0].x);
+  EXPECT_EQ(0, snapshots[0].segment[0].y);
+
+  // The obstacles are in every snapshot and the visited tiles only grow
+  for (size_t i = 0; i < snapshots.size(); ++i)
+  {
+    for (int y = 0; y < 20; ++y)
+    {
+      for (int x = 0; x < 30; ++x)
+      {
+        uint8_t tile = snapshots[i].tiles[y * 30 + x];
+        EXPECT_EQ(grid[y][x], tile == full_coverage_path_planner::eSnapshotBlocked);
+        if (i > 0 && snapshots[i - 1].tiles[y * 30 + x] == full_coverage_path_planner::eSnapshotVisited)
+        {
+          EXPECT_EQ(full_coverage_path_planner::eSnapshotVisited, tile);
+        }
+      }
+    }
+  }
+}
+
+/*
+ * The interval grid search takes the same snapshots as the dense one
+ */
+TEST(TestDebugSnapshots, testIntervalSameAsDense)
+{
+  std::vector<std::vector<bool> > grid = makeGrid(25, 25, 3);
+  std::vector<DebugSnapshot> dense = planWithSnapshots(grid, false, testDirectory("dense"));
+  std::vector<DebugSnapshot> sparse = planWithSnapshots(grid, true, testDirectory("sparse"));
+  ASSERT_EQ(dense.size(), sparse.size());
+  for (size_t i = 0; i < dense.size(); ++i)
+  {
+    EXPECT_EQ(dense[i].header.stage, sparse[i].header.stage);
+    EXPECT_EQ(dense[i].header.goals, sparse[i].header.goals);
+    EXPECT_TRUE(dense[i].tiles == sparse[i].tiles) << "snapshot " << i;
+    EXPECT_TRUE(dense[i].segment == sparse[i].segment) << "snapshot " << i;
+  }
+}
+
+/*
+ * Nothing is captured until the writer is enabled, then one PNG per snapshot
+ */
+TEST(TestDebugSnapshots, testPng)
+{
+  std::string directory = testDirectory("png");
+  AsyncSnapshotWriter writer;
+  ASSERT_TRUE(writer.open(directory, AsyncSnapshotWriter::ePng, 256));
+  EXPECT_FALSE(writer.enabled());
+
+  std::vector<std::vector<bool> > grid = makeGrid(10, 8, 5);
+  SpiralWorkspace workspace;
+  workspace.snapshots = &writer;
+  Point_t start = { 0, 0 };
+  std::vector<Point_t> path;
+  int multiple_pass_counter, visited_counter;
+  spiralCoverage(grid, start, workspace, path, multiple_pass_counter, visited_counter);
+  writer.flush();
+  std::string first = directory + "/plan1_0000_start.png";
+  EXPECT_NE(0, access(first.c_str(), F_OK));
+
+  writer.setEnabled(true);
+  spiralCoverage(grid, start, workspace, path, multiple_pass_counter, visited_counter);
+  writer.flush();
+  EXPECT_EQ(0, access(first.c_str(), F_OK));
+  std::string spiral = directory + "/plan1_0001_spiral.png";
+  EXPECT_EQ(0, access(spiral.c_str(), F_OK));
+  EXPECT_EQ(0u, writer.dropped());
+  writer.close();
+
+  std::string command = "rm -r " + directory;
+  EXPECT_EQ(0, system(command.c_str()));
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,180 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * The fixed-capacity planner must give the same plan as spiralCoverage and must not allocate at all. Allocations are
+ * counted with AllocationCounter.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <new>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <full_coverage_path_planner/allocation_counter.h>
+#include <full_coverage_path_planner/fixed_spiral_coverage.h>
+#include <full_coverage_path_planner/spiral_coverage.h>
+#include <full_coverage_path_planner/util.h>
+
+typedef full_coverage_path_planner::FixedSpiralPlanner<48, 40> Planner;
+
+namespace
+{
+// Too large for the stack
+Planner planner;
+
+/*
+ * Grid with a pseudo-random fraction of obstacles and some walls, so the spiral needs A* to get out
+ */
+std::vector<std::vector<bool> > makeObstacleGrid(int width, int height, unsigned int seed)
+{
+  std::vector<std::vector<bool> > grid = makeTestGrid(width, height, false);
+  for (int i = 0; i < width * height / 5; ++i)
+  {
+    grid[rand_r(&seed) % height][rand_r(&seed) % width] = true;
+  }
+  for (int y = 0; y < height - 3; ++y)
+  {
+    grid[y][width / 3] = true;
+    grid[height - 1 - y][2 * width / 3] = true;
+  }
+  grid[0][0] = false;
+  return grid;
+}
+
+void copyGrid(std::vector<std::vector<bool> > const& grid, Planner& fixed)
+{
+  ASSERT_TRUE(fixed.resize(grid[0].size(), grid.size()));
+  for (size_t y = 0; y < grid.size(); ++y)
+  {
+    for (size_t x = 0; x < grid[y].size(); ++x)
+    {
+      fixed.setBlocked(x, y, grid[y][x]);
+    }
+  }
+}
+}  // namespace
+
+/*
+ * Same path, counters and A* expansions as spiralCoverage, also with a start that is not in a corner and on grids
+ * where part of the free tiles can't be reached
+ */
+TEST(TestFixedSpiralCoverage, testSameAsSpiralCoverage)
+{
+  full_coverage_path_planner::SpiralWorkspace workspace;
+  std::vector<Point_t> path;
+  for (unsigned int seed = 1; seed <= 30; ++seed)
+  {
+    std::vector<std::vector<bool> > grid = makeObstacleGrid(18 + seed, 40 - seed, seed);
+    Point_t start = { 0, 0 };
+    if (seed % 3 == 0)
+    {
+      start.x = (seed * 7) % grid[0].size();
+      start.y = (seed * 5) % grid.size();
+      grid[start.y][start.x] = false;
+    }
+    int multiple_pass_counter, visited_counter;
+    full_coverage_path_planner::spiralCoverage(grid, start, workspace, path, multiple_pass_counter, visited_counter);
+
+    copyGrid(grid, planner);
+    int fixed_multiple_pass_counter, fixed_visited_counter;
+    ASSERT_TRUE(planner.plan(start, fixed_multiple_pass_counter, fixed_visited_counter));
+    ASSERT_EQ(path.size(), planner.pathLength()) << "seed " << seed;
+    EXPECT_TRUE(std::equal(path.begin(), path.end(), planner.path())) << "seed " << seed;
+    EXPECT_EQ(multiple_pass_counter, fixed_multiple_pass_counter) << "seed " << seed;
+    EXPECT_EQ(visited_counter, fixed_visited_counter) << "seed " << seed;
+    EXPECT_EQ(workspace.a_star.expansions, planner.expansions()) << "seed " << seed;
+  }
+}
+
+/*
+ * Planning never allocates, not even the first time
+ */
+TEST(TestFixedSpiralCoverage, testNoAllocations)
+{
+  std::vector<std::vector<bool> > grid = makeObstacleGrid(48, 40, 42);
+  copyGrid(grid, planner);
+  Point_t start = { 0, 0 };
+  int multiple_pass_counter, visited_counter;
+
+  AllocationCounter counter;
+  bool planned = planner.plan(start, multiple_pass_counter, visited_counter);
+  EXPECT_TRUE(planned);
+  EXPECT_EQ(0u, counter.count());
+  EXPECT_GT(multiple_pass_counter, 0);  // A* was needed
+}
+
+/*
+ * A planner that is not in zero-initialized static storage, e.g. placed in a reused buffer, plans the same as one that
+ * is: nothing is left over from the memory it was constructed in
+ */
+TEST(TestFixedSpiralCoverage, testDirtyMemory)
+{
+  typedef full_coverage_path_planner::FixedSpiralPlanner<16, 16> SmallPlanner;
+  // Every word 1, the generation of the first search of a new planner
+  static uint32_t buffer[sizeof(SmallPlanner) / sizeof(uint32_t) + 1];
+  std::fill(buffer, buffer + sizeof(buffer) / sizeof(uint32_t), 1);
+  SmallPlanner* dirty = new (buffer) SmallPlanner();
+
+  std::vector<std::vector<bool> > grid = makeTestGrid(16, 16, false);
+  for (int y = 0; y < 13; ++y)
+  {
+    grid[y][8] = true;
+  }
+  Point_t start = { 0, 0 };
+  full_coverage_path_planner::SpiralWorkspace workspace;
+  std::vector<Point_t> path;
+  int multiple_pass_counter, visited_counter;
+  full_coverage_path_planner::spiralCoverage(grid, start, workspace, path, multiple_pass_counter, visited_counter);
+
+  ASSERT_TRUE(dirty->resize(16, 16));
+  for (int y = 0; y < 16; ++y)
+  {
+    for (int x = 0; x < 16; ++x)
+    {
+      dirty->setBlocked(x, y, grid[y][x]);
+    }
+  }
+  int fixed_multiple_pass_counter, fixed_visited_counter;
+  ASSERT_TRUE(dirty->plan(start, fixed_multiple_pass_counter, fixed_visited_counter));
+  ASSERT_EQ(path.size(), dirty->pathLength());
+  EXPECT_TRUE(std::equal(path.begin(), path.end(), dirty->path()));
+  EXPECT_EQ(multiple_pass_counter, fixed_multiple_pass_counter);
+  EXPECT_EQ(visited_counter, fixed_visited_counter);
+  dirty->~SmallPlanner();
+}
+
+/*
+ * Grids and plans beyond the capacity are refused
+ */
+TEST(TestFixedSpiralCoverage, testCapacity)
+{
+  EXPECT_FALSE(planner.resize(49, 10));
+  EXPECT_FALSE(planner.resize(10, 41));
+  EXPECT_FALSE(planner.resize(0, 10));
+  ASSERT_TRUE(planner.resize(48, 40));
+
+  Point_t start = { 48, 0 };
+  int multiple_pass_counter, visited_counter;
+  EXPECT_FALSE(planner.plan(start, multiple_pass_counter, visited_counter));
+
+  // A path buffer shorter than the plan keeps the part that fits
+  static full_coverage_path_planner::FixedSpiralPlanner<10, 10, 50> small;
+  ASSERT_TRUE(small.resize(10, 10));
+  start.x = 0;
+  EXPECT_FALSE(small.plan(start, multiple_pass_counter, visited_counter));
+  EXPECT_EQ(50u, small.pathLength());
+  ASSERT_TRUE(small.resize(7, 7));
+  EXPECT_TRUE(small.plan(start, multiple_pass_counter, visited_counter));
+  EXPECT_EQ(49u, small.pathLength());
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,86 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * Performance regression suite: replays the corpus of the fuzz targets in test/fuzz and checks every input against
+ * the same expansion and time bounds as the fuzzers
+ */
+#include <dirent.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <full_coverage_path_planner/fuzz_grid.h>
+
+/*
+ * Contents of all files in a corpus directory, sorted by name
+ */
+std::vector<std::pair<std::string, std::vector<uint8_t> > > readCorpus(std::string const& name)
+{
+  std::string directory = std::string(FUZZ_CORPUS_DIR) + "/" + name;
+  std::vector<std::string> files;
+  DIR* dir = opendir(directory.c_str());
+  for (struct dirent* entry = dir ? readdir(dir) : NULL; entry != NULL; entry = readdir(dir))
+  {
+    if (entry->d_name[0] != '.')
+    {
+      files.push_back(entry->d_name);
+    }
+  }
+  if (dir)
+  {
+    closedir(dir);
+  }
+  std::sort(files.begin(), files.end());
+
+  std::vector<std::pair<std::string, std::vector<uint8_t> > > corpus;
+  for (unsigned int i = 0; i < files.size(); ++i)
+  {
+    std::ifstream in((directory + "/" + files[i]).c_str(), std::ios::binary);
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    corpus.push_back(std::make_pair(files[i], data));
+  }
+  return corpus;
+}
+
+TEST(TestFuzzCorpus, testSpiralStc)
+{
+  std::vector<std::pair<std::string, std::vector<uint8_t> > > corpus = readCorpus("spiral_stc");
+  ASSERT_FALSE(corpus.empty());
+  full_coverage_path_planner::SpiralWorkspace workspace;
+  std::vector<Point_t> path;
+  for (unsigned int i = 0; i < corpus.size(); ++i)
+  {
+    FuzzGrid fuzz;
+    ASSERT_TRUE(fuzzGridFromBytes(corpus[i].second.data(), corpus[i].second.size(), fuzz)) << corpus[i].first;
+    EXPECT_EQ("", checkSpiralStc(fuzz, workspace, path)) << corpus[i].first;
+  }
+}
+
+TEST(TestFuzzCorpus, testAStar)
+{
+  std::vector<std::pair<std::string, std::vector<uint8_t> > > corpus = readCorpus("a_star");
+  ASSERT_FALSE(corpus.empty());
+  AStarWorkspace workspace;
+  std::vector<Point_t> open_space;
+  std::vector<gridNode_t> pathNodes;
+  for (unsigned int i = 0; i < corpus.size(); ++i)
+  {
+    FuzzGrid fuzz;
+    ASSERT_TRUE(fuzzGridFromBytes(corpus[i].second.data(), corpus[i].second.size(), fuzz)) << corpus[i].first;
+    EXPECT_EQ("", checkAStar(fuzz, workspace, open_space, pathNodes)) << corpus[i].first;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,287 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * Tests for the inflation of obstacles into the tile grid.
+ * The fast implementations are compared against a brute force evaluation of the same definition.
+ */
+#include <stdlib.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <full_coverage_path_planner/grid_inflation.h>
+#include <full_coverage_path_planner/util.h>
+
+using full_coverage_path_planner::TileFootprint;
+
+/**
+ * Create a row-major occupancy map with a fraction of random obstacles (value 100), the rest is free (value 0)
+ */
+std::vector<int8_t> makeRandomOccupancy(int width, int height, int obstacle_percentage, unsigned int seed)
+{
+  std::vector<int8_t> data(width * height, 0);
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    if (static_cast<int>(rand_r(&seed) % 100) < obstacle_percentage)
+    {
+      data[i] = 100;
+    }
+  }
+  return data;
+}
+
+/*
+ * The squared distance transform must match the brute force minimum over all obstacles
+ */
+TEST(TestDistanceTransform, testAgainstBruteForce)
+{
+  int width = 23, height = 17;
+  std::vector<int8_t> data = makeRandomOccupancy(width, height, 5, 42);
+  std::vector<uint8_t> obstacles(width * height);
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    obstacles[i] = data[i] > full_coverage_path_planner::kOccupiedThreshold;
+  }
+
+  std::vector<float> dist2;
+  full_coverage_path_planner::distanceTransform(obstacles, width, height, dist2);
+  ASSERT_EQ(width * height, dist2.size());
+
+  for (int y = 0; y < height; ++y)
+  {
+    for (int x = 0; x < width; ++x)
+    {
+      int best = width * width + height * height;
+      for (int oy = 0; oy < height; ++oy)
+      {
+        for (int ox = 0; ox < width; ++ox)
+        {
+          if (obstacles[oy * width + ox])
+          {
+            best = std::min(best, (ox - x) * (ox - x) + (oy - y) * (oy - y));
+          }
+        }
+      }
+      ASSERT_FLOAT_EQ(best, dist2[y * width + x]) << "at (" << x << ", " << y << ")";
+    }
+  }
+}
+
+/*
+ * Square footprint: a tile is blocked when the footprint_size window centered on the tile contains an obstacle
+ */
+TEST(TestInflateTiles, testSquareAgainstBruteForce)
+{
+  int width = 40, height = 31;
+  std::vector<int8_t> data = makeRandomOccupancy(width, height, 2, 7);
+
+  for (int node_size = 1; node_size <= 3; ++node_size)
+  {
+    for (int footprint_size = 1; footprint_size <= 7; ++footprint_size)
+    {
+      TileFootprint footprint = { full_coverage_path_planner::eFootprintSquare, node_size, footprint_size, 0.0f };
+      int tiles_x = full_coverage_path_planner::tileCount(width, node_size);
+      int tiles_y = full_coverage_path_planner::tileCount(height, node_size);
+      std::vector<std::vector<bool> > grid = makeTestGrid(tiles_x, tiles_y);
+      full_coverage_path_planner::inflateTiles(&data[0], width, height, footprint, 0, 0, tiles_x, tiles_y, grid);
+
+      int offset = static_cast<int>(std::ceil((footprint_size - node_size) / 2.0));
+      for (int ty = 0; ty < tiles_y; ++ty)
+      {
+        for (int tx = 0; tx < tiles_x; ++tx)
+        {
+          bool blocked = false;
+          for (int y = ty * node_size - offset; y < ty * node_size - offset + footprint_size; ++y)
+          {
+            for (int x = tx * node_size - offset; x < tx * node_size - offset + footprint_size; ++x)
+            {
+              if (x >= 0 && x < width && y >= 0 && y < height && data[y * width + x] > 65)
+              {
+                blocked = true;
+              }
+            }
+          }
+          ASSERT_EQ(blocked, grid[ty][tx]) << "tile (" << tx << ", " << ty << "), node_size " << node_size
+                                           << ", footprint_size " << footprint_size;
+        }
+      }
+    }
+  }
+}
+
+/*
+ * Circle footprint: on a map with a single obstacle, exactly the tiles whose center is closer than the radius
+ * to that obstacle are blocked
+ */
+TEST(TestInflateTiles, testCircleAroundSingleObstacle)
+{
+  /*
+   * 11x11 map, tile = 1 cell, obstacle in the middle and a radius of 2.5 cells:
+   * all tiles within distance 2.5 from (5, 5) are blocked
+   */
+  int width = 11, height = 11;
+  std::vector<int8_t> data(width * height, 0);
+  data[5 * width + 5] = 100;
+
+  TileFootprint footprint = { full_coverage_path_planner::eFootprintCircle, 1, 1, 2.5f };
+  std::vector<std::vector<bool> > grid = makeTestGrid(width, height);
+  full_coverage_path_planner::inflateTiles(&data[0], width, height, footprint, 0, 0, width, height, grid);
+
+  for (int y = 0; y < height; ++y)
+  {
+    for (int x = 0; x < width; ++x)
+    {
+      bool expected = (x - 5) * (x - 5) + (y - 5) * (y - 5) < 2.5 * 2.5;
+      ASSERT_EQ(expected, grid[y][x]) << "tile (" << x << ", " << y << ")";
+    }
+  }
+}
+
+/*
+ * Even a very small radius must block the tile that contains an obstacle at its center
+ */
+TEST(TestInflateTiles, testCircleTinyRadius)
+{
+  std::vector<int8_t> data(3 * 3, 0);
+  data[1 * 3 + 1] = 100;
+
+  TileFootprint footprint = { full_coverage_path_planner::eFootprintInscribed, 1, 1, 0.0f };
+  std::vector<std::vector<bool> > grid = makeTestGrid(3, 3);
+  full_coverage_path_planner::inflateTiles(&data[0], 3, 3, footprint, 0, 0, 3, 3, grid);
+
+  ASSERT_TRUE(grid[1][1]);
+  ASSERT_EQ(1, map_2_goals(grid, true).size());
+}
+
+/*
+ * Computing only a part of the tiles gives the same result for that part and leaves the others untouched
+ */
+TEST(TestInflateTiles, testSubRange)
+{
+  int width = 30, height = 30;
+  std::vector<int8_t> data = makeRandomOccupancy(width, height, 3, 3);
+  TileFootprint footprints[] =
+  {
+    { full_coverage_path_planner::eFootprintSquare, 2, 5, 0.0f },
+    { full_coverage_path_planner::eFootprintCircle, 2, 5, 2.5f },
+  };
+
+  for (int i = 0; i < 2; ++i)
+  {
+    std::vector<std::vector<bool> > full = makeTestGrid(15, 15);
+    full_coverage_path_planner::inflateTiles(&data[0], width, height, footprints[i], 0, 0, 15, 15, full);
+
+    std::vector<std::vector<bool> > part = makeTestGrid(15, 15);
+    full_coverage_path_planner::inflateTiles(&data[0], width, height, footprints[i], 4, 3, 9, 12, part);
+    for (int ty = 0; ty < 15; ++ty)
+    {
+      for (int tx = 0; tx < 15; ++tx)
+      {
+        bool inside = tx >= 4 && tx < 9 && ty >= 3 && ty < 12;
+        ASSERT_EQ(inside ? full[ty][tx] : false, part[ty][tx]);
+      }
+    }
+  }
+}
+
+/*
+ * Updating the grid after a change in a window of the map gives the same grid as inflating the whole map again, and
+ * reports exactly the tiles that changed
+ */
+TEST(TestInflateTiles, testUpdateTiles)
+{
+  int width = 47, height = 39;  // Partial tiles at the border
+  TileFootprint footprints[] =
+  {
+    { full_coverage_path_planner::eFootprintSquare, 3, 7, 0.0f },
+    { full_coverage_path_planner::eFootprintSquare, 4, 2, 0.0f },
+    { full_coverage_path_planner::eFootprintCircle, 3, 7, 3.5f },
+    { full_coverage_path_planner::eFootprintCircle, 2, 1, 0.3f },
+  };
+  unsigned int seed = 11;
+  for (int i = 0; i < 4; ++i)
+  {
+    TileFootprint const& footprint = footprints[i];
+    int nTileCols = full_coverage_path_planner::tileCount(width, footprint.node_size);
+    int nTileRows = full_coverage_path_planner::tileCount(height, footprint.node_size);
+    std::vector<int8_t> data = makeRandomOccupancy(width, height, 2, i);
+    std::vector<std::vector<bool> > grid = makeTestGrid(nTileCols, nTileRows);
+    full_coverage_path_planner::inflateTiles(&data[0], width, height, footprint, 0, 0, nTileCols, nTileRows, grid);
+
+    for (int change = 0; change < 20; ++change)
+    {
+      // Add or clear obstacles in a random window, also at the border of the map
+      int cx0 = rand_r(&seed) % width, cy0 = rand_r(&seed) % height;
+      int cx1 = std::min(width, cx0 + 1 + static_cast<int>(rand_r(&seed) % 8));
+      int cy1 = std::min(height, cy0 + 1 + static_cast<int>(rand_r(&seed) % 8));
+      for (int y = cy0; y < cy1; ++y)
+      {
+        for (int x = cx0; x < cx1; ++x)
+        {
+          data[y * width + x] = rand_r(&seed) % 4 == 0 ? 100 : 0;
+        }
+      }
+      std::vector<std::vector<bool> > before = grid;
+      std::vector<Point_t> changed;
+      full_coverage_path_planner::updateTiles(&data[0], width, height, footprint, cx0, cy0, cx1, cy1, grid, 0, 0,
+                                              NULL, changed);
+
+      std::vector<std::vector<bool> > expected = makeTestGrid(nTileCols, nTileRows);
+      full_coverage_path_planner::inflateTiles(&data[0], width, height, footprint, 0, 0, nTileCols, nTileRows,
+                                               expected);
+      ASSERT_EQ(expected, grid) << "footprint " << i << ", change " << change;
+      size_t differences = 0;
+      for (int ty = 0; ty < nTileRows; ++ty)
+      {
+        for (int tx = 0; tx < nTileCols; ++tx)
+        {
+          differences += before[ty][tx] != grid[ty][tx];
+        }
+      }
+      ASSERT_EQ(differences, changed.size());
+      for (size_t c = 0; c < changed.size(); ++c)
+      {
+        EXPECT_NE(before[changed[c].y][changed[c].x], grid[changed[c].y][changed[c].x]);
+      }
+    }
+  }
+}
+
+/*
+ * On a grid that covers part of the map, only its own tiles are updated and blocked tiles stay blocked
+ */
+TEST(TestInflateTiles, testUpdateTilesCropped)
+{
+  int width = 30, height = 30;
+  TileFootprint footprint = { full_coverage_path_planner::eFootprintSquare, 2, 3, 0.0f };
+  std::vector<int8_t> data(width * height, 100);
+  std::vector<std::vector<bool> > grid = makeTestGrid(6, 5);
+  full_coverage_path_planner::inflateTiles(&data[0], width, height, footprint, 4, 3, 10, 8, grid, 4, 3);
+  std::vector<std::vector<bool> > blocked = makeTestGrid(6, 5);
+  blocked[2][2] = true;
+
+  // Clear the whole map
+  data.assign(width * height, 0);
+  std::vector<Point_t> changed;
+  full_coverage_path_planner::updateTiles(&data[0], width, height, footprint, 0, 0, width, height, grid, 4, 3,
+                                          &blocked, changed);
+  EXPECT_EQ(29u, changed.size());
+  for (int ty = 0; ty < 5; ++ty)
+  {
+    for (int tx = 0; tx < 6; ++tx)
+    {
+      EXPECT_EQ(tx == 2 && ty == 2, grid[ty][tx]);
+    }
+  }
+}
+
+// Run all the tests that were declared with TEST()
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,232 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+#include <stdlib.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <full_coverage_path_planner/common.h>
+#include <full_coverage_path_planner/interval_grid.h>
+#include <full_coverage_path_planner/spiral_stc.h>
+#include <full_coverage_path_planner/util.h>
+
+using full_coverage_path_planner::FreeInterval;
+using full_coverage_path_planner::IntervalGrid;
+using full_coverage_path_planner::SpiralSTC;
+
+namespace
+{
+/*
+ * Mostly blocked grid: a few winding free strips and some free blobs, like a path network on an outdoor map
+ */
+std::vector<std::vector<bool> > makeSparseGrid(int width, int height, unsigned int seed)
+{
+  std::vector<std::vector<bool> > grid = makeTestGrid(width, height, true);
+  int x = 0, y = 0;
+  for (int i = 0; i < width * height / 4; ++i)
+  {
+    grid[y][x] = false;
+    int direction = rand_r(&seed) % 4;
+    x = std::max(0, std::min(width - 1, x + (direction == 0) - (direction == 1)));
+    y = std::max(0, std::min(height - 1, y + (direction == 2) - (direction == 3)));
+  }
+  for (int i = 0; i < 3; ++i)
+  {
+    int bx = rand_r(&seed) % width, by = rand_r(&seed) % height;
+    for (int dy = 0; dy < 4 && by + dy < height; ++dy)
+    {
+      for (int dx = 0; dx < 5 && bx + dx < width; ++dx)
+      {
+        grid[by + dy][bx + dx] = false;
+      }
+    }
+  }
+  return grid;
+}
+
+/*
+ * Grid with a pseudo-random fraction of obstacles
+ */
+std::vector<std::vector<bool> > makeDenseGrid(int width, int height, unsigned int seed)
+{
+  std::vector<std::vector<bool> > grid = makeTestGrid(width, height, false);
+  for (int i = 0; i < width * height / 4; ++i)
+  {
+    grid[rand_r(&seed) % height][rand_r(&seed) % width] = true;
+  }
+  return grid;
+}
+
+Point_t firstFreeTile(std::vector<std::vector<bool> > const& grid)
+{
+  for (int y = 0; y < static_cast<int>(grid.size()); ++y)
+  {
+    for (int x = 0; x < static_cast<int>(grid[y].size()); ++x)
+    {
+      if (!grid[y][x])
+      {
+        Point_t p = { x, y };
+        return p;
+      }
+    }
+  }
+  Point_t p = { 0, 0 };
+  return p;
+}
+
+void expectSameAsDense(std::vector<std::vector<bool> > const& grid, Point_t start, unsigned int seed)
+{
+  full_coverage_path_planner::SpiralWorkspace workspace;
+  full_coverage_path_planner::IntervalSpiralWorkspace interval_workspace;
+  std::vector<Point_t> expected, path;
+  int multiple_pass_counter, visited_counter, interval_multiple_pass_counter, interval_visited_counter;
+  SpiralSTC::spiral_stc(grid, start, workspace, expected, multiple_pass_counter, visited_counter);
+  IntervalGrid intervals(grid);
+  SpiralSTC::spiral_stc(intervals, start, interval_workspace, path, interval_multiple_pass_counter,
+                        interval_visited_counter);
+  ASSERT_EQ(expected.size(), path.size()) << "seed " << seed;
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), path.begin())) << "seed " << seed;
+  EXPECT_EQ(multiple_pass_counter, interval_multiple_pass_counter) << "seed " << seed;
+  EXPECT_EQ(visited_counter, interval_visited_counter) << "seed " << seed;
+  EXPECT_EQ(workspace.a_star.expansions, interval_workspace.a_star.expansions) << "seed " << seed;
+}
+}  // namespace
+
+/*
+ * Runs, their offsets and the index lookup of a small grid
+ */
+TEST(TestIntervalGrid, testRuns)
+{
+  // x: 0123456
+  //    .##..#.   row 0
+  //    #######   row 1
+  //    .......   row 2
+  bool const cells[3][7] =
+  {
+    { false, true, true, false, false, true, false },
+    { true, true, true, true, true, true, true },
+    { false, false, false, false, false, false, false },
+  };
+  std::vector<std::vector<bool> > grid(3, std::vector<bool>(7));
+  for (int y = 0; y < 3; ++y)
+  {
+    grid[y].assign(cells[y], cells[y] + 7);
+  }
+  IntervalGrid intervals(grid);
+  EXPECT_EQ(7, intervals.width());
+  EXPECT_EQ(3, intervals.height());
+  EXPECT_EQ(11, intervals.freeCount());
+  EXPECT_EQ(4, intervals.intervalCount());
+
+  ASSERT_EQ(3, intervals.rowEnd(0) - intervals.rowBegin(0));
+  EXPECT_EQ(0, intervals.rowEnd(1) - intervals.rowBegin(1));
+  FreeInterval const* run = intervals.rowBegin(0);
+  EXPECT_EQ(0, run[0].start);
+  EXPECT_EQ(1, run[0].end);
+  EXPECT_EQ(3, run[1].start);
+  EXPECT_EQ(5, run[1].end);
+  EXPECT_EQ(1, run[1].offset);
+  EXPECT_EQ(6, run[2].start);
+  EXPECT_EQ(3, run[2].offset);
+  EXPECT_EQ(4, intervals.rowBegin(2)->offset);
+
+  EXPECT_EQ(0, intervals.index(0, 0));
+  EXPECT_EQ(-1, intervals.index(1, 0));
+  EXPECT_EQ(2, intervals.index(4, 0));
+  EXPECT_EQ(-1, intervals.index(5, 0));
+  EXPECT_EQ(3, intervals.index(6, 0));
+  EXPECT_EQ(-1, intervals.index(3, 1));
+  EXPECT_EQ(10, intervals.index(6, 2));
+  EXPECT_EQ(-1, intervals.index(7, 2));
+  EXPECT_EQ(-1, intervals.index(-1, 2));
+  EXPECT_EQ(-1, intervals.index(0, 3));
+
+  std::vector<std::vector<bool> > back;
+  intervals.toGrid(back);
+  EXPECT_EQ(grid, back);
+}
+
+/*
+ * Every free tile gets a unique index and map_2_goals lists the same tiles as on the dense grid
+ */
+TEST(TestIntervalGrid, testIndexAndGoals)
+{
+  for (unsigned int seed = 1; seed <= 10; ++seed)
+  {
+    std::vector<std::vector<bool> > grid = makeSparseGrid(40, 30, seed);
+    IntervalGrid intervals(grid);
+    std::vector<bool> visited(intervals.freeCount(), false);
+    int expected_index = 0;
+    for (int y = 0; y < 30; ++y)
+    {
+      for (int x = 0; x < 40; ++x)
+      {
+        if (grid[y][x])
+        {
+          EXPECT_EQ(-1, intervals.index(x, y));
+        }
+        else
+        {
+          EXPECT_EQ(expected_index, intervals.index(x, y));
+          // Mark every third free tile visited, in both representations
+          visited[expected_index] = expected_index % 3 == 0;
+          grid[y][x] = visited[expected_index];
+          ++expected_index;
+        }
+      }
+    }
+    EXPECT_EQ(expected_index, intervals.freeCount());
+
+    std::vector<Point_t> expected, goals;
+    map_2_goals(grid, eNodeOpen, expected);
+    map_2_goals(intervals, visited, goals);
+    ASSERT_EQ(expected.size(), goals.size()) << "seed " << seed;
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), goals.begin())) << "seed " << seed;
+  }
+}
+
+/*
+ * spiral_stc on the interval grid finds the same path, counters and number of A* expansions as on the dense grid
+ */
+TEST(TestIntervalGrid, testSameAsDenseSpiralStc)
+{
+  for (unsigned int seed = 1; seed <= 10; ++seed)
+  {
+    std::vector<std::vector<bool> > grid = makeSparseGrid(30 + seed, 40 - seed, seed);
+    expectSameAsDense(grid, firstFreeTile(grid), seed);
+  }
+  for (unsigned int seed = 1; seed <= 10; ++seed)
+  {
+    std::vector<std::vector<bool> > grid = makeDenseGrid(10 + seed, 25 - seed, seed);
+    expectSameAsDense(grid, firstFreeTile(grid), seed);
+  }
+}
+
+/*
+ * A blocked start is handled like on the dense grid: it counts as visited
+ */
+TEST(TestIntervalGrid, testBlockedStart)
+{
+  std::vector<std::vector<bool> > grid = makeSparseGrid(20, 20, 7);
+  for (int y = 0; y < 20; ++y)
+  {
+    for (int x = 0; x < 20; ++x)
+    {
+      if (grid[y][x])
+      {
+        Point_t start = { x, y };
+        expectSameAsDense(grid, start, 7);
+        return;
+      }
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
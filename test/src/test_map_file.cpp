@@ -0,0 +1,130 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * Tests for planning on a map file that is loaded straight into tiles
+ */
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <full_coverage_path_planner/full_coverage_path_planner.h>
+#include <full_coverage_path_planner/map_loader.h>
+
+using full_coverage_path_planner::FootprintModel;
+using full_coverage_path_planner::FullCoveragePathPlanner;
+using full_coverage_path_planner::eFootprintCircle;
+using full_coverage_path_planner::eFootprintSquare;
+
+namespace
+{
+/*
+ * Planner with the map handling of SpiralSTC, without ROS
+ */
+class MapFilePlanner : public FullCoveragePathPlanner
+{
+public:
+  MapFilePlanner(FootprintModel model, std::vector<fPoint_t> const& roi)
+  {
+    robot_radius_ = 0.25;
+    tool_radius_ = 0.15;
+    footprint_model_ = model;
+    roi_ = roi;
+  }
+
+  bool makePlan(const geometry_msgs::PoseStamped& /*start*/, const geometry_msgs::PoseStamped& /*goal*/,
+                std::vector<geometry_msgs::PoseStamped>& /*plan*/)
+  {
+    return false;  // Not used
+  }
+
+  bool parseMap(nav_msgs::OccupancyGrid const& map, geometry_msgs::PoseStamped const& start,
+                std::vector<std::vector<bool> >& grid, Point_t& startPoint)
+  {
+    return parseGrid(map, grid, robot_radius_ * 2, tool_radius_ * 2, start, startPoint);
+  }
+
+  bool parseFile(std::string const& map_file, geometry_msgs::PoseStamped const& start,
+                 std::vector<std::vector<bool> >& grid, Point_t& startPoint)
+  {
+    map_file_ = map_file;
+    return planningGrid(start, grid, startPoint);
+  }
+
+  fPoint_t origin() const
+  {
+    return grid_origin_;
+  }
+
+  float tileSize() const
+  {
+    return tile_size_;
+  }
+};
+
+/*
+ * The grid, origin and start tile of planning on the map file equal those of parsing the map
+ */
+void expectSameGrid(std::string const& name, FootprintModel model, std::vector<fPoint_t> const& roi, double x,
+                    double y)
+{
+  std::string yaml = std::string(MAPS_DIR) + "/" + name;
+  nav_msgs::OccupancyGrid map;
+  ASSERT_TRUE(full_coverage_path_planner::loadMap(yaml, map));
+  geometry_msgs::PoseStamped start;
+  start.pose.position.x = x;
+  start.pose.position.y = y;
+  start.pose.orientation.w = 1.0;
+
+  MapFilePlanner expected_planner(model, roi), planner(model, roi);
+  std::vector<std::vector<bool> > expected, grid;
+  Point_t expectedStart, startPoint;
+  ASSERT_TRUE(expected_planner.parseMap(map, start, expected, expectedStart));
+  // Twice: the tiles of the file are loaded once and cropped for every plan
+  for (int i = 0; i < 2; ++i)
+  {
+    ASSERT_TRUE(planner.parseFile(yaml, start, grid, startPoint));
+    EXPECT_EQ(expected, grid);
+    EXPECT_EQ(expectedStart.x, startPoint.x);
+    EXPECT_EQ(expectedStart.y, startPoint.y);
+    EXPECT_FLOAT_EQ(expected_planner.tileSize(), planner.tileSize());
+    EXPECT_FLOAT_EQ(expected_planner.origin().x, planner.origin().x);
+    EXPECT_FLOAT_EQ(expected_planner.origin().y, planner.origin().y);
+  }
+}
+}  // namespace
+
+TEST(TestMapFile, testWholeMap)
+{
+  expectSameGrid("grid.yaml", eFootprintSquare, std::vector<fPoint_t>(), 1.0, 1.0);
+  expectSameGrid("basement.yaml", eFootprintSquare, std::vector<fPoint_t>(), 1.0, 1.0);
+  expectSameGrid("basement.yaml", eFootprintCircle, std::vector<fPoint_t>(), 1.0, 1.0);
+}
+
+/*
+ * The crop to the region of interest does not change the tiles
+ */
+TEST(TestMapFile, testRegionOfInterest)
+{
+  fPoint_t corners[] = { { 0.3f, 0.4f }, { 3.1f, 0.7f }, { 2.6f, 3.3f } };
+  std::vector<fPoint_t> roi(corners, corners + 3);
+  expectSameGrid("grid.yaml", eFootprintSquare, roi, -1.0, -1.0);
+  expectSameGrid("basement.yaml", eFootprintSquare, roi, 2.0, 1.0);
+  expectSameGrid("basement.yaml", eFootprintCircle, roi, 2.0, 1.0);
+}
+
+TEST(TestMapFile, testMissingFile)
+{
+  MapFilePlanner planner(eFootprintSquare, std::vector<fPoint_t>());
+  std::vector<std::vector<bool> > grid;
+  Point_t startPoint;
+  EXPECT_FALSE(planner.parseFile("/nonexistent.yaml", geometry_msgs::PoseStamped(), grid, startPoint));
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,249 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * Tests for loading map_server maps without a running map_server
+ */
+#include <png.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <full_coverage_path_planner/grid_inflation.h>
+#include <full_coverage_path_planner/map_loader.h>
+
+std::string testFile(std::string const& extension)
+{
+  std::stringstream name;
+  name << "/tmp/test_map_loader_" << getpid() << "." << extension;
+  return name.str();
+}
+
+std::string writeYaml(std::string const& image, double yaw = 0.0)
+{
+  std::string yaml = testFile("yaml");
+  std::ofstream out(yaml.c_str());
+  out << "image: " << image.substr(image.rfind('/') + 1) << "\n"
+      << "resolution: 0.05  # m/cell\n"
+      << "origin: [-5.0, -2.5, " << yaw << "]\n"
+      << "negate: 0\n"
+      << "occupied_thresh: 0.65\n"
+      << "free_thresh: 0.196\n";
+  return yaml;
+}
+
+/*
+ * 3x2 image, top row: black, white, grey; bottom row: white, white, black
+ */
+std::vector<uint8_t> testPixels()
+{
+  uint8_t pixels[] = { 0, 255, 128, 255, 255, 0 };
+  return std::vector<uint8_t>(pixels, pixels + 6);
+}
+
+void expectTestMap(nav_msgs::OccupancyGrid const& map)
+{
+  ASSERT_EQ(3u, map.info.width);
+  ASSERT_EQ(2u, map.info.height);
+  EXPECT_FLOAT_EQ(0.05, map.info.resolution);
+  EXPECT_DOUBLE_EQ(-5.0, map.info.origin.position.x);
+  EXPECT_DOUBLE_EQ(-2.5, map.info.origin.position.y);
+  // Bottom row of the image first
+  int8_t expected[] = { 0, 0, 100, 100, 0, -1 };
+  for (int i = 0; i < 6; ++i)
+  {
+    EXPECT_EQ(expected[i], map.data[i]) << "cell " << i;
+  }
+}
+
+TEST(TestMapLoader, testMetadata)
+{
+  std::string yaml = writeYaml("map.pgm");
+  full_coverage_path_planner::MapMetadata metadata;
+  ASSERT_TRUE(full_coverage_path_planner::readMapMetadata(yaml, metadata));
+  EXPECT_EQ("/tmp/map.pgm", metadata.image);
+  EXPECT_DOUBLE_EQ(0.05, metadata.resolution);
+  EXPECT_DOUBLE_EQ(-5.0, metadata.origin_x);
+  EXPECT_DOUBLE_EQ(-2.5, metadata.origin_y);
+  EXPECT_FALSE(metadata.negate);
+  remove(yaml.c_str());
+
+  EXPECT_FALSE(full_coverage_path_planner::readMapMetadata("/nonexistent.yaml", metadata));
+}
+
+TEST(TestMapLoader, testPgm)
+{
+  std::string image = testFile("pgm");
+  std::vector<uint8_t> pixels = testPixels();
+  {
+    std::ofstream out(image.c_str(), std::ios::binary);
+    out << "P5\n# test map\n3 2\n255\n";
+    out.write(reinterpret_cast<char const*>(pixels.data()), pixels.size());
+  }
+  std::string yaml = writeYaml(image);
+  nav_msgs::OccupancyGrid map;
+  ASSERT_TRUE(full_coverage_path_planner::loadMap(yaml, map));
+  expectTestMap(map);
+  remove(image.c_str());
+  remove(yaml.c_str());
+}
+
+TEST(TestMapLoader, testPng)
+{
+  std::string image = testFile("png");
+  std::vector<uint8_t> pixels = testPixels();
+  png_image png;
+  memset(&png, 0, sizeof(png));
+  png.version = PNG_IMAGE_VERSION;
+  png.width = 3;
+  png.height = 2;
+  png.format = PNG_FORMAT_GRAY;
+  ASSERT_TRUE(png_image_write_to_file(&png, image.c_str(), 0, pixels.data(), 0, NULL));
+  std::string yaml = writeYaml(image);
+  nav_msgs::OccupancyGrid map;
+  ASSERT_TRUE(full_coverage_path_planner::loadMap(yaml, map));
+  expectTestMap(map);
+  remove(image.c_str());
+  remove(yaml.c_str());
+}
+
+/*
+ * The tiles are aligned with the map frame, so rotated maps are refused
+ */
+TEST(TestMapLoader, testRotatedMap)
+{
+  std::string image = testFile("pgm");
+  std::vector<uint8_t> pixels = testPixels();
+  {
+    std::ofstream out(image.c_str(), std::ios::binary);
+    out << "P5\n3 2\n255\n";
+    out.write(reinterpret_cast<char const*>(pixels.data()), pixels.size());
+  }
+  std::string yaml = writeYaml(image, 0.5);
+  full_coverage_path_planner::MapMetadata metadata;
+  ASSERT_TRUE(full_coverage_path_planner::readMapMetadata(yaml, metadata));
+  EXPECT_DOUBLE_EQ(0.5, metadata.origin_yaw);
+  nav_msgs::OccupancyGrid map;
+  EXPECT_FALSE(full_coverage_path_planner::loadMap(yaml, map));
+  std::vector<std::vector<bool> > grid;
+  full_coverage_path_planner::TileFootprint footprint = { full_coverage_path_planner::eFootprintSquare, 2, 2, 0.0f };
+  EXPECT_FALSE(full_coverage_path_planner::loadTileGrid(yaml, footprint, metadata, grid));
+  remove(image.c_str());
+  remove(yaml.c_str());
+}
+
+/*
+ * Free, unknown and occupied pixels, with obstacles up to the borders so that partial tiles and clamped windows matter
+ */
+std::vector<uint8_t> obstaclePixels(int width, int height)
+{
+  std::vector<uint8_t> pixels(width * height, 255);
+  for (int i = 0; i < width * height; ++i)
+  {
+    int x = i % width, y = i / width;
+    if ((x * 7 + y * 13) % 41 == 0 || (x == width - 1 && y % 5 == 0) || (y == 0 && x % 9 == 4))
+    {
+      pixels[i] = 0;
+    }
+    else if ((x + y) % 17 == 0)
+    {
+      pixels[i] = 128;
+    }
+  }
+  return pixels;
+}
+
+/*
+ * Streaming the image into tiles gives the grid of inflating the whole map, for all footprint models, keeping only the
+ * rows of one footprint window
+ */
+void expectTileGrid(std::string const& yaml)
+{
+  nav_msgs::OccupancyGrid map;
+  ASSERT_TRUE(full_coverage_path_planner::loadMap(yaml, map));
+  int width = map.info.width, height = map.info.height;
+
+  full_coverage_path_planner::TileFootprint footprints[] = {
+    { full_coverage_path_planner::eFootprintSquare, 1, 1, 0.0f },
+    { full_coverage_path_planner::eFootprintSquare, 3, 5, 0.0f },
+    { full_coverage_path_planner::eFootprintSquare, 4, 2, 0.0f },
+    { full_coverage_path_planner::eFootprintCircle, 3, 0, 2.5f },
+    { full_coverage_path_planner::eFootprintCircle, 6, 0, 1.0f },
+    { full_coverage_path_planner::eFootprintInscribed, 2, 0, 4.2f },
+  };
+  for (size_t f = 0; f < sizeof(footprints) / sizeof(footprints[0]); ++f)
+  {
+    full_coverage_path_planner::TileFootprint const& footprint = footprints[f];
+    int n = footprint.node_size;
+    std::vector<std::vector<bool> > expected(full_coverage_path_planner::tileCount(height, n),
+                                             std::vector<bool>(full_coverage_path_planner::tileCount(width, n)));
+    full_coverage_path_planner::inflateTiles(map.data.data(), width, height, footprint, 0, 0, expected[0].size(),
+                                             expected.size(), expected);
+
+    full_coverage_path_planner::MapMetadata metadata;
+    std::vector<std::vector<bool> > grid;
+    int band_rows = 0;
+    ASSERT_TRUE(full_coverage_path_planner::loadTileGrid(yaml, footprint, metadata, grid, &band_rows));
+    EXPECT_DOUBLE_EQ(0.05, metadata.resolution);
+    EXPECT_EQ(expected, grid) << "footprint " << f;
+
+    int window = footprint.model == full_coverage_path_planner::eFootprintSquare ?
+                 footprint.footprint_size : 2 * static_cast<int>(std::ceil(footprint.radius)) + 3;
+    EXPECT_LE(band_rows, window) << "footprint " << f;
+  }
+}
+
+TEST(TestMapLoader, testTileGridPgm)
+{
+  std::string image = testFile("pgm");
+  int width = 37, height = 29;
+  std::vector<uint8_t> pixels = obstaclePixels(width, height);
+  {
+    std::ofstream out(image.c_str(), std::ios::binary);
+    out << "P5\n" << width << " " << height << "\n255\n";
+    out.write(reinterpret_cast<char const*>(pixels.data()), pixels.size());
+  }
+  std::string yaml = writeYaml(image);
+  expectTileGrid(yaml);
+  remove(image.c_str());
+  remove(yaml.c_str());
+}
+
+TEST(TestMapLoader, testTileGridPng)
+{
+  std::string image = testFile("png");
+  int width = 40, height = 31;
+  std::vector<uint8_t> pixels = obstaclePixels(width, height);
+  png_image png;
+  memset(&png, 0, sizeof(png));
+  png.version = PNG_IMAGE_VERSION;
+  png.width = width;
+  png.height = height;
+  png.format = PNG_FORMAT_GRAY;
+  ASSERT_TRUE(png_image_write_to_file(&png, image.c_str(), 0, pixels.data(), 0, NULL));
+  std::string yaml = writeYaml(image);
+  expectTileGrid(yaml);
+
+  // Missing images are an error
+  remove(image.c_str());
+  full_coverage_path_planner::MapMetadata metadata;
+  std::vector<std::vector<bool> > grid;
+  full_coverage_path_planner::TileFootprint footprint = { full_coverage_path_planner::eFootprintSquare, 2, 2, 0.0f };
+  EXPECT_FALSE(full_coverage_path_planner::loadTileGrid(yaml, footprint, metadata, grid));
+  remove(yaml.c_str());
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,254 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * Tests for the grid that the planner keeps between plans with map updates
+ */
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <full_coverage_path_planner/full_coverage_path_planner.h>
+
+using full_coverage_path_planner::FullCoveragePathPlanner;
+
+namespace
+{
+/*
+ * Planner with the map and grid handling of SpiralSTC, without ROS
+ */
+class MapUpdatePlanner : public FullCoveragePathPlanner
+{
+public:
+  explicit MapUpdatePlanner(bool map_updates)
+  {
+    robot_radius_ = 0.2;
+    tool_radius_ = 0.2;
+    map_updates_ = map_updates;
+  }
+
+  bool makePlan(const geometry_msgs::PoseStamped& /*start*/, const geometry_msgs::PoseStamped& /*goal*/,
+                std::vector<geometry_msgs::PoseStamped>& /*plan*/)
+  {
+    return false;  // Not used
+  }
+
+  bool gridValid()
+  {
+    return grid_valid_;
+  }
+
+  void setRoi(std::vector<fPoint_t> const& roi)
+  {
+    roi_ = roi;
+  }
+
+  /**
+   * Grid and start tile of a plan on map, parsed from scratch
+   */
+  bool parse(nav_msgs::OccupancyGrid const& map, geometry_msgs::PoseStamped const& start,
+             std::vector<std::vector<bool> >& grid, Point_t& startPoint)
+  {
+    return parseGrid(map, grid, robot_radius_ * 2, tool_radius_ * 2, start, startPoint);
+  }
+
+  using FullCoveragePathPlanner::applyMapUpdate;
+  using FullCoveragePathPlanner::planningGrid;
+  using FullCoveragePathPlanner::setMap;
+  using FullCoveragePathPlanner::updateGrid;
+};
+
+/*
+ * 40 x 30 cells of 5 cm, with a wall and a pillar. Tiles are 8 x 8 cells
+ */
+nav_msgs::OccupancyGrid testMap()
+{
+  nav_msgs::OccupancyGrid map;
+  map.info.width = 40;
+  map.info.height = 30;
+  map.info.resolution = 0.05;
+  map.info.origin.position.x = -1.0;
+  map.info.origin.position.y = 0.5;
+  map.data.assign(40 * 30, 0);
+  for (int y = 0; y < 30; ++y)
+  {
+    map.data[y * 40 + 2] = 100;
+  }
+  map.data[20 * 40 + 30] = 100;
+  return map;
+}
+
+/*
+ * Update that sets the cells [x, x + width) x [y, y + height) to value, and the same on map
+ */
+map_msgs::OccupancyGridUpdate makeUpdate(nav_msgs::OccupancyGrid& map, int x, int y, int width, int height,
+                                         int8_t value)
+{
+  map_msgs::OccupancyGridUpdate update;
+  update.x = x;
+  update.y = y;
+  update.width = width;
+  update.height = height;
+  update.data.assign(width * height, value);
+  for (int cy = y; cy < y + height; ++cy)
+  {
+    for (int cx = x; cx < x + width; ++cx)
+    {
+      map.data[cy * map.info.width + cx] = value;
+    }
+  }
+  return update;
+}
+
+geometry_msgs::PoseStamped makeStart(double x, double y)
+{
+  geometry_msgs::PoseStamped start;
+  start.pose.position.x = x;
+  start.pose.position.y = y;
+  start.pose.orientation.w = 1.0;
+  return start;
+}
+
+/*
+ * The grid and start tile of the planner equal those of parsing map from scratch
+ */
+void expectParsed(MapUpdatePlanner& planner, nav_msgs::OccupancyGrid const& map,
+                  geometry_msgs::PoseStamped const& start, std::vector<fPoint_t> const& roi)
+{
+  std::vector<std::vector<bool> > grid, expected;
+  Point_t startPoint, expectedStart;
+  ASSERT_TRUE(planner.planningGrid(start, grid, startPoint));
+  MapUpdatePlanner reference(false);
+  reference.setRoi(roi);
+  ASSERT_TRUE(reference.parse(map, start, expected, expectedStart));
+  EXPECT_EQ(expected, grid);
+  EXPECT_EQ(expectedStart.x, startPoint.x);
+  EXPECT_EQ(expectedStart.y, startPoint.y);
+}
+}  // namespace
+
+/*
+ * Map updates are applied to the grid of the previous plan, which the next plan reuses
+ */
+TEST(TestMapUpdates, testUpdatedGridIsReused)
+{
+  nav_msgs::OccupancyGrid map = testMap();
+  geometry_msgs::PoseStamped start = makeStart(0.3, 1.2);
+  MapUpdatePlanner planner(true);
+  planner.setMap(map);
+  EXPECT_FALSE(planner.gridValid());
+  expectParsed(planner, map, start, std::vector<fPoint_t>());
+  EXPECT_TRUE(planner.gridValid());
+
+  // Block a tile
+  std::vector<Point_t> changed;
+  ASSERT_TRUE(planner.applyMapUpdate(makeUpdate(map, 20, 10, 4, 3, 100), changed));
+  EXPECT_FALSE(changed.empty());
+  EXPECT_TRUE(planner.gridValid());
+  expectParsed(planner, map, start, std::vector<fPoint_t>());
+  EXPECT_TRUE(planner.gridValid());
+
+  // Clear it again
+  ASSERT_TRUE(planner.applyMapUpdate(makeUpdate(map, 20, 10, 4, 3, 0), changed));
+  EXPECT_FALSE(changed.empty());
+  expectParsed(planner, map, start, std::vector<fPoint_t>());
+
+  // An update that changes no tiles
+  ASSERT_TRUE(planner.applyMapUpdate(makeUpdate(map, 2, 5, 1, 1, 100), changed));
+  EXPECT_TRUE(changed.empty());
+  expectParsed(planner, map, start, std::vector<fPoint_t>());
+}
+
+/*
+ * With a region of interest, tiles outside of it stay blocked and a start outside of it moves into it
+ */
+TEST(TestMapUpdates, testRegionOfInterest)
+{
+  fPoint_t corners[] = { { -0.6f, 0.6f }, { 0.6f, 0.6f }, { 0.6f, 1.6f }, { -0.6f, 1.6f } };
+  std::vector<fPoint_t> roi(corners, corners + 4);
+  nav_msgs::OccupancyGrid map = testMap();
+  geometry_msgs::PoseStamped start = makeStart(0.9, 1.9);
+  MapUpdatePlanner planner(true);
+  planner.setRoi(roi);
+  planner.setMap(map);
+  expectParsed(planner, map, start, roi);
+
+  std::vector<Point_t> changed;
+  ASSERT_TRUE(planner.applyMapUpdate(makeUpdate(map, 8, 8, 30, 22, 100), changed));
+  EXPECT_FALSE(changed.empty());
+  expectParsed(planner, map, start, roi);
+}
+
+/*
+ * Updates that can not be applied to the grid make the next plan parse the map again
+ */
+TEST(TestMapUpdates, testInvalidatedGrid)
+{
+  nav_msgs::OccupancyGrid map = testMap();
+  geometry_msgs::PoseStamped start = makeStart(0.3, 1.2);
+  MapUpdatePlanner planner(true);
+  std::vector<Point_t> changed;
+  EXPECT_FALSE(planner.applyMapUpdate(makeUpdate(map, 0, 0, 1, 1, 0), changed));
+
+  // Before the first plan the update is only applied to the map
+  planner.setMap(testMap());
+  EXPECT_FALSE(planner.applyMapUpdate(makeUpdate(map, 20, 10, 4, 3, 100), changed));
+  EXPECT_FALSE(planner.gridValid());
+  expectParsed(planner, map, start, std::vector<fPoint_t>());
+  EXPECT_TRUE(planner.gridValid());
+
+  // An update outside of the map
+  map_msgs::OccupancyGridUpdate update;
+  update.x = 38;
+  update.y = 0;
+  update.width = 4;
+  update.height = 1;
+  update.data.assign(4, 100);
+  EXPECT_FALSE(planner.applyMapUpdate(update, changed));
+  EXPECT_FALSE(planner.gridValid());
+
+  // A new map
+  planner.setMap(map);
+  expectParsed(planner, map, start, std::vector<fPoint_t>());
+  map.data.assign(map.data.size(), 0);
+  planner.setMap(map);
+  EXPECT_FALSE(planner.gridValid());
+  expectParsed(planner, map, start, std::vector<fPoint_t>());
+}
+
+/*
+ * The grid is updated on a map whose origin differs in the last bits from the parsed one, not on a moved map
+ */
+TEST(TestMapUpdates, testOriginTolerance)
+{
+  nav_msgs::OccupancyGrid map = testMap();
+  geometry_msgs::PoseStamped start = makeStart(0.3, 1.2);
+  MapUpdatePlanner planner(false);
+  std::vector<std::vector<bool> > grid;
+  Point_t startPoint;
+  ASSERT_TRUE(planner.parse(map, start, grid, startPoint));
+
+  std::vector<Point_t> changed;
+  nav_msgs::OccupancyGrid updated = map;
+  makeUpdate(updated, 20, 10, 4, 3, 100);
+  updated.info.origin.position.x += 1e-9;
+  updated.info.origin.position.y -= 1e-9;
+  ASSERT_TRUE(planner.updateGrid(updated, 20, 10, 24, 13, grid, changed));
+  EXPECT_FALSE(changed.empty());
+  std::vector<std::vector<bool> > expected;
+  ASSERT_TRUE(planner.parse(updated, start, expected, startPoint));
+  EXPECT_EQ(expected, grid);
+
+  updated.info.origin.position.x = map.info.origin.position.x + map.info.resolution;
+  EXPECT_FALSE(planner.updateGrid(updated, 20, 10, 24, 13, grid, changed));
+  updated.info.origin.position.x = map.info.origin.position.x;
+  updated.info.origin.position.y = map.info.origin.position.y - 0.1 * map.info.resolution;
+  EXPECT_FALSE(planner.updateGrid(updated, 20, 10, 24, 13, grid, changed));
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
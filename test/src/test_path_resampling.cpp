@@ -0,0 +1,113 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * Tests for resampling a plan and computing its curvature and speed limit profile
+ */
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <full_coverage_path_planner/path_resampling.h>
+
+using full_coverage_path_planner::PathProfile;
+using full_coverage_path_planner::ResamplingParams;
+using full_coverage_path_planner::Waypoint;
+
+ResamplingParams makeParams()
+{
+  ResamplingParams params;
+  params.spacing = 0.1;
+  params.max_velocity = 1.0;
+  params.max_acceleration = 0.5;
+  params.max_lateral_acceleration = 0.2;
+  return params;
+}
+
+/*
+ * A straight line is divided in parts of at most the spacing, with zero curvature and a trapezoidal speed limit
+ */
+TEST(TestPathResampling, testStraightLine)
+{
+  std::vector<Waypoint> path;
+  Waypoint start = { 0.0, 0.0, 0.0 }, end = { 10.0, 0.0, 0.0 };
+  path.push_back(start);
+  path.push_back(end);
+
+  PathProfile profile;
+  full_coverage_path_planner::resamplePath(path, makeParams(), profile);
+
+  ASSERT_EQ(101, profile.poses.size());
+  ASSERT_EQ(profile.poses.size(), profile.arc_length.size());
+  ASSERT_EQ(profile.poses.size(), profile.curvature.size());
+  ASSERT_EQ(profile.poses.size(), profile.max_velocity.size());
+  EXPECT_DOUBLE_EQ(10.0, profile.arc_length.back());
+  for (unsigned int i = 0; i < profile.poses.size(); ++i)
+  {
+    EXPECT_NEAR(0.1 * i, profile.arc_length[i], 1e-9);
+    EXPECT_DOUBLE_EQ(0.0, profile.curvature[i]);
+  }
+
+  // Standstill at both ends, v^2 = 2 * a * s while accelerating and the maximum velocity in the middle
+  EXPECT_DOUBLE_EQ(0.0, profile.max_velocity.front());
+  EXPECT_DOUBLE_EQ(0.0, profile.max_velocity.back());
+  EXPECT_NEAR(std::sqrt(2 * 0.5 * 0.5), profile.max_velocity[5], 1e-9);
+  EXPECT_DOUBLE_EQ(1.0, profile.max_velocity[50]);
+}
+
+/*
+ * A corner with a turn on the spot (two poses at the same position) is kept and requires standing still
+ */
+TEST(TestPathResampling, testTurnOnTheSpot)
+{
+  std::vector<Waypoint> path;
+  Waypoint a = { 0.0, 0.0, 0.0 }, b = { 5.0, 0.0, 0.0 }, b_turned = { 5.0, 0.0, M_PI / 2 }, c = { 5.0, 5.0, M_PI / 2 };
+  path.push_back(a);
+  path.push_back(b);
+  path.push_back(b_turned);
+  path.push_back(c);
+
+  PathProfile profile;
+  full_coverage_path_planner::resamplePath(path, makeParams(), profile);
+
+  ASSERT_EQ(102, profile.poses.size());
+  EXPECT_DOUBLE_EQ(5.0, profile.poses[50].x);
+  EXPECT_DOUBLE_EQ(0.0, profile.poses[50].yaw);
+  EXPECT_DOUBLE_EQ(5.0, profile.poses[51].x);
+  EXPECT_DOUBLE_EQ(M_PI / 2, profile.poses[51].yaw);
+  EXPECT_DOUBLE_EQ(profile.arc_length[50], profile.arc_length[51]);
+  EXPECT_DOUBLE_EQ(0.0, profile.max_velocity[50]);
+  EXPECT_DOUBLE_EQ(0.0, profile.max_velocity[51]);
+  EXPECT_GT(profile.curvature[50], 1e3);
+}
+
+/*
+ * On a circle, the curvature is 1 / radius and the speed is limited by the lateral acceleration
+ */
+TEST(TestPathResampling, testCircle)
+{
+  double radius = 2.0;
+  std::vector<Waypoint> path;
+  for (int i = 0; i <= 360; ++i)
+  {
+    double t = i * M_PI / 180.0;
+    Waypoint w = { radius * std::cos(t), radius * std::sin(t), t + M_PI / 2 };
+    path.push_back(w);
+  }
+
+  PathProfile profile;
+  full_coverage_path_planner::resamplePath(path, makeParams(), profile);
+
+  size_t middle = profile.poses.size() / 2;
+  EXPECT_NEAR(1.0 / radius, profile.curvature[middle], 1e-3);
+  EXPECT_NEAR(std::sqrt(0.2 * radius), profile.max_velocity[middle], 1e-3);
+}
+
+// Run all the tests that were declared with TEST()
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
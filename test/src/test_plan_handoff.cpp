@@ -0,0 +1,191 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * Tests for handing plans off to consumers in the same process
+ */
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <full_coverage_path_planner/plan_handoff.h>
+
+using full_coverage_path_planner::HandoffPlan;
+using full_coverage_path_planner::PlanHandoff;
+using full_coverage_path_planner::Waypoint;
+
+/*
+ * Poses on the walk get the tile they are on, also where the walk passes a tile twice; poses beside the walk keep the
+ * previous tile
+ */
+TEST(TestPlanHandoff, testMapPosesToTiles)
+{
+  // Right along row 0, up, left along row 1 and back over the start of row 1 after an escape
+  Point_t walk[] = { { 0, 0 }, { 1, 0 }, { 2, 0 }, { 3, 0 }, { 3, 1 }, { 2, 1 }, { 1, 1 }, { 1, 1 }, { 2, 1 } };
+  std::vector<Point_t> tiles(walk, walk + 9);
+  double tile_size = 0.5, origin_x = -1.0, origin_y = 2.0;
+  Waypoint points[] = { { -1.2, 2.25, 0.0 },   // Beside the walk, driving to the start
+                        { -0.75, 2.25, 0.0 },  // Tile 0
+                        { 0.75, 2.25, 0.0 },   // Tile 3, corners only
+                        { 0.75, 2.75, 0.0 },   // Tile 4
+                        { 0.9, 2.9, 0.0 },     // Still tile 4
+                        { -0.25, 2.75, 0.0 },  // Tile 6
+                        { 0.25, 2.75, 0.0 } };  // Tile 2, passed again at index 8
+  std::vector<Waypoint> poses(points, points + 7);
+  std::vector<uint32_t> pose_tiles;
+  full_coverage_path_planner::mapPosesToTiles(poses, tiles, origin_x, origin_y, tile_size, pose_tiles);
+  uint32_t expected[] = { 0, 0, 3, 4, 4, 6, 8 };
+  ASSERT_EQ(7u, pose_tiles.size());
+  for (size_t i = 0; i < 7; ++i)
+  {
+    EXPECT_EQ(expected[i], pose_tiles[i]) << "pose " << i;
+  }
+}
+
+/*
+ * After poses beside the walk, the walk is searched as far ahead as those poses went, not only as far as the next
+ * pose is from the last tile that was found
+ */
+TEST(TestPlanHandoff, testMapPosesToTilesAfterPoseBesideWalk)
+{
+  // Up column 0 and back down column 1
+  std::vector<Point_t> tiles;
+  for (int y = 0; y < 10; ++y)
+  {
+    Point_t tile = { 0, y };
+    tiles.push_back(tile);
+  }
+  for (int y = 9; y >= 0; --y)
+  {
+    Point_t tile = { 1, y };
+    tiles.push_back(tile);
+  }
+  Waypoint points[] = { { 1.5, 0.5, 0.0 },   // Start, offset into tile 19
+                        { 0.5, 0.5, 0.0 },   // Tile 0
+                        { 0.5, 10.5, 0.0 },  // Smoothed corner, beyond the top of the walk
+                        { 1.5, 0.5, 0.0 },   // Tile 19 after the long stroke down, next to tile 0
+                        { 1.5, 0.6, 0.0 } };  // Still tile 19
+  std::vector<Waypoint> poses(points, points + 5);
+  std::vector<uint32_t> pose_tiles;
+  full_coverage_path_planner::mapPosesToTiles(poses, tiles, 0.0, 0.0, 1.0, pose_tiles);
+  uint32_t expected[] = { 0, 0, 0, 19, 19 };
+  ASSERT_EQ(5u, pose_tiles.size());
+  for (size_t i = 0; i < 5; ++i)
+  {
+    EXPECT_EQ(expected[i], pose_tiles[i]) << "pose " << i;
+  }
+}
+
+/*
+ * The plan before the current one is reused once no reader holds it
+ */
+TEST(TestPlanHandoff, testDoubleBuffer)
+{
+  PlanHandoff handoff;
+  EXPECT_EQ(0u, handoff.sequence());
+  EXPECT_FALSE(handoff.latest());
+
+  std::shared_ptr<HandoffPlan> first = handoff.beginWrite();
+  first->poses.resize(10);
+  handoff.commit(first);
+  EXPECT_EQ(1u, handoff.sequence());
+  std::shared_ptr<HandoffPlan const> held = handoff.latest();
+  EXPECT_EQ(first.get(), held.get());
+  EXPECT_EQ(1u, held->sequence);
+
+  std::shared_ptr<HandoffPlan> second = handoff.beginWrite();
+  EXPECT_NE(first.get(), second.get());
+  handoff.commit(second);
+  first.reset();
+
+  // A reader still holds the first plan, so it can't be reused yet
+  std::shared_ptr<HandoffPlan> third = handoff.beginWrite();
+  EXPECT_NE(held.get(), third.get());
+  EXPECT_NE(second.get(), third.get());
+  EXPECT_EQ(10u, held->poses.size());
+  EXPECT_EQ(1u, held->sequence);
+  handoff.commit(third);
+  held.reset();
+
+  // Nobody holds the second plan anymore
+  HandoffPlan const* second_address = second.get();
+  second.reset();
+  std::shared_ptr<HandoffPlan> fourth = handoff.beginWrite();
+  EXPECT_EQ(second_address, fourth.get());
+  handoff.commit(fourth);
+  EXPECT_EQ(4u, handoff.latest()->sequence);
+}
+
+/*
+ * The same name gives the same handoff point
+ */
+TEST(TestPlanHandoff, testRegistry)
+{
+  PlanHandoff& a = full_coverage_path_planner::planHandoff("a");
+  EXPECT_EQ(&a, &full_coverage_path_planner::planHandoff("a"));
+  EXPECT_NE(&a, &full_coverage_path_planner::planHandoff("b"));
+}
+
+/*
+ * Readers only ever see complete plans, in order, while the writer keeps publishing
+ */
+TEST(TestPlanHandoff, testConcurrentReaders)
+{
+  PlanHandoff handoff;
+  std::atomic<bool> done(false);
+  std::atomic<int> inconsistent(0);
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 4; ++r)
+  {
+    readers.push_back(std::thread([&handoff, &done, &inconsistent]()
+    {
+      uint64_t last = 0;
+      while (!done.load())
+      {
+        std::shared_ptr<HandoffPlan const> plan = handoff.latest();
+        if (!plan)
+        {
+          continue;
+        }
+        // Every plan holds its sequence in all of its poses and tiles
+        bool ok = plan->sequence >= last && plan->poses.size() == plan->sequence % 50 + 1 &&
+                  plan->pose_tiles.size() == plan->poses.size();
+        for (size_t i = 0; ok && i < plan->poses.size(); ++i)
+        {
+          ok = plan->poses[i].x == plan->sequence && plan->pose_tiles[i] == plan->sequence;
+        }
+        if (!ok)
+        {
+          ++inconsistent;
+        }
+        last = plan->sequence;
+      }
+    }));
+  }
+
+  for (uint64_t sequence = 1; sequence <= 5000; ++sequence)
+  {
+    std::shared_ptr<HandoffPlan> plan = handoff.beginWrite();
+    Waypoint pose = { static_cast<double>(sequence), 0.0, 0.0 };
+    plan->poses.assign(sequence % 50 + 1, pose);
+    plan->pose_tiles.assign(plan->poses.size(), sequence);
+    handoff.commit(plan);
+  }
+  done = true;
+  for (size_t r = 0; r < readers.size(); ++r)
+  {
+    readers[r].join();
+  }
+  EXPECT_EQ(0, inconsistent.load());
+  EXPECT_EQ(5000u, handoff.sequence());
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,156 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * Tests for splitting a coverage walk into segments that fit a battery budget
+ */
+#include <math.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <full_coverage_path_planner/plan_segmentation.h>
+#include <full_coverage_path_planner/util.h>
+
+using full_coverage_path_planner::PathCostTable;
+using full_coverage_path_planner::PlanSegment;
+using full_coverage_path_planner::SegmentationParams;
+
+namespace
+{
+/*
+ * Back and forth over the rows of an empty grid, starting at (0, 0)
+ */
+std::vector<Point_t> boustrophedon(int width, int height)
+{
+  std::vector<Point_t> path;
+  for (int y = 0; y < height; ++y)
+  {
+    for (int i = 0; i < width; ++i)
+    {
+      Point_t p = { y % 2 ? width - 1 - i : i, y };
+      path.push_back(p);
+    }
+  }
+  return path;
+}
+
+/*
+ * Cost of a segment computed directly from the walk, for comparison with the prefix sums
+ */
+double bruteForceCost(std::vector<Point_t> const& path, std::vector<int> const& distance, int width,
+                      double tile_size, SegmentationParams const& params, size_t begin, size_t end, int approach)
+{
+  double length = 0.0, turn = 0.0;
+  for (size_t i = begin + 1; i <= end; ++i)
+  {
+    length += hypot(path[i].x - path[i - 1].x, path[i].y - path[i - 1].y);
+    if (i < end)
+    {
+      double a = atan2(path[i].y - path[i - 1].y, path[i].x - path[i - 1].x);
+      double b = atan2(path[i + 1].y - path[i].y, path[i + 1].x - path[i].x);
+      turn += fabs(remainder(b - a, 2 * M_PI));
+    }
+  }
+  int retreat = distance[path[end].y * width + path[end].x];
+  return (approach + length + retreat) * tile_size * params.cost_per_meter + turn * params.cost_per_radian;
+}
+}  // namespace
+
+TEST(TestPlanSegmentation, testCostTable)
+{
+  Point_t points[] = { { 0, 0 }, { 1, 0 }, { 2, 0 }, { 2, 1 }, { 1, 1 }, { 1, 1 } };
+  std::vector<Point_t> path(points, points + 6);
+  PathCostTable table;
+  table.assign(path);
+  ASSERT_EQ(6u, table.size());
+  EXPECT_DOUBLE_EQ(2.0, table.length(0, 2));
+  EXPECT_DOUBLE_EQ(0.0, table.turn(0, 2));
+  EXPECT_DOUBLE_EQ(M_PI / 2, table.turn(0, 3));
+  EXPECT_DOUBLE_EQ(M_PI, table.turn(1, 4));
+  EXPECT_DOUBLE_EQ(0.0, table.turn(3, 3));
+  EXPECT_DOUBLE_EQ(4.0, table.length(0, 5));  // Standing still adds neither length nor a turn
+  EXPECT_DOUBLE_EQ(M_PI, table.turn(0, 5));
+}
+
+/*
+ * Distances follow the free tiles around a wall, tiles behind a closed wall are unreachable
+ */
+TEST(TestPlanSegmentation, testDockDistanceField)
+{
+  std::vector<std::vector<bool> > grid = makeTestGrid(5, 4, false);
+  grid[0][1] = grid[1][1] = grid[2][1] = true;  // Wall with a gap at the top
+  grid[0][3] = grid[1][3] = grid[2][3] = grid[3][3] = true;  // Closed wall
+  std::vector<int> distance;
+  Point_t dock = { 0, 0 };
+  full_coverage_path_planner::dockDistanceField(grid, dock, distance);
+  ASSERT_EQ(20u, distance.size());
+  EXPECT_EQ(0, distance[0]);
+  EXPECT_EQ(3, distance[3 * 5 + 0]);
+  EXPECT_EQ(4, distance[3 * 5 + 1]);
+  EXPECT_EQ(8, distance[0 * 5 + 2]);
+  EXPECT_EQ(-1, distance[1 * 5 + 1]);  // Blocked
+  EXPECT_EQ(-1, distance[2 * 5 + 4]);  // Behind the closed wall
+
+  // A dock in the inflation of a wall still reaches the free tiles next to it
+  grid[0][0] = true;
+  full_coverage_path_planner::dockDistanceField(grid, dock, distance);
+  EXPECT_EQ(0, distance[0]);
+  EXPECT_EQ(1, distance[1 * 5 + 0]);
+}
+
+/*
+ * The segments cover the walk without gaps, each fits the budget and none could be longer
+ */
+TEST(TestPlanSegmentation, testSegments)
+{
+  int width = 12, height = 9;
+  std::vector<std::vector<bool> > grid = makeTestGrid(width, height, false);
+  std::vector<Point_t> path = boustrophedon(width, height);
+  std::vector<int> distance;
+  Point_t dock = { 0, 0 };
+  full_coverage_path_planner::dockDistanceField(grid, dock, distance);
+  PathCostTable table;
+  table.assign(path);
+  SegmentationParams params = { 60.0, 2.0, 0.5 };
+  double tile_size = 0.5;
+  std::vector<PlanSegment> segments;
+  ASSERT_TRUE(full_coverage_path_planner::segmentPath(path, table, distance, width, tile_size, params, segments));
+  ASSERT_GT(segments.size(), 1u);
+  EXPECT_EQ(0u, segments.front().begin);
+  EXPECT_EQ(0, segments.front().approach);
+  EXPECT_EQ(path.size() - 1, segments.back().end);
+  for (size_t s = 0; s < segments.size(); ++s)
+  {
+    PlanSegment const& segment = segments[s];
+    if (s > 0)
+    {
+      EXPECT_EQ(segments[s - 1].end, segment.begin);
+      EXPECT_EQ(segments[s - 1].retreat, segment.approach);
+    }
+    EXPECT_LE(segment.cost, params.budget);
+    EXPECT_NEAR(bruteForceCost(path, distance, width, tile_size, params, segment.begin, segment.end,
+                               segment.approach), segment.cost, 1e-9);
+    for (size_t end = segment.end + 1; end < path.size() && s + 1 < segments.size(); ++end)
+    {
+      EXPECT_GT(bruteForceCost(path, distance, width, tile_size, params, segment.begin, end, segment.approach),
+                params.budget) << "segment " << s << " could end at " << end;
+    }
+  }
+
+  // A budget that covers everything gives one segment, one that does not reach the far end fails
+  params.budget = 1000.0;
+  ASSERT_TRUE(full_coverage_path_planner::segmentPath(path, table, distance, width, tile_size, params, segments));
+  EXPECT_EQ(1u, segments.size());
+  params.budget = 10.0;
+  EXPECT_FALSE(full_coverage_path_planner::segmentPath(path, table, distance, width, tile_size, params, segments));
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,193 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * Tests for building, storing and stitching plans from a planning atlas
+ */
+#include <stdio.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <list>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <full_coverage_path_planner/planning_atlas.h>
+
+using full_coverage_path_planner::AtlasContent;
+using full_coverage_path_planner::PlanningAtlas;
+
+std::string testAtlasFile()
+{
+  std::stringstream name;
+  name << "/tmp/test_planning_atlas_" << getpid() << ".atlas";
+  return name.str();
+}
+
+/*
+ * Boustrophedon walk over all tiles of a rectangle [x0, x1) x [y0, y1)
+ */
+std::list<Point_t> rectangleWalk(int x0, int y0, int x1, int y1)
+{
+  std::list<Point_t> walk;
+  for (int y = y0; y < y1; ++y)
+  {
+    for (int i = 0; i < x1 - x0; ++i)
+    {
+      Point_t p = { (y - y0) % 2 == 0 ? x0 + i : x1 - 1 - i, y };
+      walk.push_back(p);
+    }
+  }
+  return walk;
+}
+
+/*
+ * 10 x 10 tiles with a wall at x = 5 that has a gap at y = 9, a zone left and right of the wall, a dock in each
+ */
+AtlasContent makeContent(std::vector<std::vector<bool> >& grid)
+{
+  grid.assign(10, std::vector<bool>(10, false));
+  for (int y = 0; y < 9; ++y)
+  {
+    grid[y][5] = true;
+  }
+  AtlasContent content;
+  content.origin_x = -1.0;
+  content.origin_y = 2.0;
+  content.tile_size = 0.5;
+  content.width = 10;
+  content.height = 10;
+  Point_t dock_left = { 0, 0 }, dock_right = { 9, 0 };
+  content.docks.push_back(dock_left);
+  content.docks.push_back(dock_right);
+  content.zones.push_back(rectangleWalk(0, 0, 5, 5));
+  content.zones.push_back(rectangleWalk(6, 0, 10, 5));
+  content.zones.push_back(std::list<Point_t>());  // Zone without accessible tiles
+  full_coverage_path_planner::connectAtlas(grid, content);
+  return content;
+}
+
+void expectContinuousWalk(std::list<Point_t> const& walk, std::vector<std::vector<bool> > const& grid)
+{
+  for (std::list<Point_t>::const_iterator it = walk.begin(); it != walk.end(); ++it)
+  {
+    std::list<Point_t>::const_iterator next = it;
+    if (++next == walk.end())
+    {
+      break;
+    }
+    EXPECT_EQ(1, std::abs(next->x - it->x) + std::abs(next->y - it->y));
+    EXPECT_FALSE(grid[next->y][next->x]);
+  }
+}
+
+/*
+ * Shortest walks go around obstacles and are empty for unreachable targets
+ */
+TEST(TestPlanningAtlas, testShortestWalks)
+{
+  std::vector<std::vector<bool> > grid;
+  makeContent(grid);
+  grid[9][5] = true;  // Close the gap
+
+  Point_t source = { 0, 9 }, left = { 4, 0 }, right = { 6, 9 };
+  std::vector<Point_t> targets;
+  targets.push_back(left);
+  targets.push_back(right);
+  std::vector<std::list<Point_t> > walks;
+  full_coverage_path_planner::shortestWalks(grid, source, targets, walks);
+
+  ASSERT_EQ(2, walks.size());
+  EXPECT_EQ(14, walks[0].size());  // Manhattan distance 13, plus the source
+  EXPECT_TRUE(walks[1].empty());
+  expectContinuousWalk(walks[0], grid);
+}
+
+/*
+ * Plans are stitched from the file: dock to the first zone, the zones and the connectors in between
+ */
+TEST(TestPlanningAtlas, testWriteAndAssemble)
+{
+  std::vector<std::vector<bool> > grid;
+  AtlasContent content = makeContent(grid);
+  ASSERT_TRUE(full_coverage_path_planner::writeAtlas(testAtlasFile(), content));
+
+  PlanningAtlas atlas;
+  ASSERT_TRUE(atlas.open(testAtlasFile()));
+  EXPECT_EQ(2, atlas.header().dock_count);
+  EXPECT_EQ(3, atlas.header().zone_count);
+  EXPECT_DOUBLE_EQ(0.5, atlas.header().tile_size);
+
+  Point_t near_right = { 8, 1 };
+  int distance_squared;
+  EXPECT_EQ(1, atlas.nearestDock(near_right, distance_squared));
+  EXPECT_EQ(2, distance_squared);
+
+  std::vector<int> zones;
+  zones.push_back(1);
+  zones.push_back(0);
+  std::list<Point_t> walk;
+  ASSERT_TRUE(atlas.assemble(1, zones, walk));
+  EXPECT_EQ(9, walk.front().x);
+  EXPECT_EQ(0, walk.front().y);
+  expectContinuousWalk(walk, grid);
+
+  // Every tile of both zones is covered
+  std::vector<std::vector<bool> > covered(10, std::vector<bool>(10, false));
+  for (std::list<Point_t>::const_iterator it = walk.begin(); it != walk.end(); ++it)
+  {
+    covered[it->y][it->x] = true;
+  }
+  for (int y = 0; y < 5; ++y)
+  {
+    for (int x = 0; x < 10; ++x)
+    {
+      EXPECT_EQ(x != 5, covered[y][x]);
+    }
+  }
+
+  // Invalid requests
+  EXPECT_FALSE(atlas.assemble(2, zones, walk));
+  zones.push_back(2);
+  EXPECT_FALSE(atlas.assemble(0, zones, walk));
+  zones[2] = 3;
+  EXPECT_FALSE(atlas.assemble(0, zones, walk));
+  remove(testAtlasFile().c_str());
+}
+
+/*
+ * Truncated or foreign files are rejected
+ */
+TEST(TestPlanningAtlas, testInvalidFile)
+{
+  std::vector<std::vector<bool> > grid;
+  AtlasContent content = makeContent(grid);
+  ASSERT_TRUE(full_coverage_path_planner::writeAtlas(testAtlasFile(), content));
+  std::string data;
+  {
+    std::ifstream in(testAtlasFile().c_str(), std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+  {
+    std::ofstream out(testAtlasFile().c_str(), std::ios::binary | std::ios::trunc);
+    out.write(data.data(), data.size() - 8);
+  }
+
+  PlanningAtlas atlas;
+  EXPECT_FALSE(atlas.open(testAtlasFile()));
+  EXPECT_FALSE(atlas.isOpen());
+  EXPECT_FALSE(atlas.open("/nonexistent/file.atlas"));
+  remove(testAtlasFile().c_str());
+}
+
+// Run all the tests that were declared with TEST()
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,136 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * Tests for recording planning requests and reading them back for replay
+ */
+#include <stdio.h>
+#include <unistd.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <full_coverage_path_planner/request_recorder.h>
+
+using full_coverage_path_planner::RecordedRequest;
+using full_coverage_path_planner::RequestRecorder;
+
+std::string testDirectory()
+{
+  std::stringstream name;
+  name << "/tmp/test_request_recorder_" << getpid();
+  return name.str();
+}
+
+nav_msgs::OccupancyGrid testMap()
+{
+  nav_msgs::OccupancyGrid map;
+  map.info.width = 5;
+  map.info.height = 3;
+  map.info.resolution = 0.1;
+  map.info.origin.position.x = -1.0;
+  map.info.origin.position.y = 2.0;
+  int8_t data[] = { 0, 100, -1, 66, 65, 0, 0, 0, 0, 0, 100, 100, 100, 100, 100 };
+  map.data.assign(data, data + 15);
+  return map;
+}
+
+RecordedRequest testRequest()
+{
+  RecordedRequest request = RecordedRequest();
+  request.header.start_x = 1.5;
+  request.header.start_y = -0.5;
+  request.header.start_yaw = 0.25;
+  request.header.robot_radius = 0.3;
+  request.header.tool_radius = 0.2;
+  request.header.join_style = full_coverage_path_planner::eJoinMwm;
+  request.header.coverage_engine = full_coverage_path_planner::eRecordedContour;
+  request.header.sparse_grid = 1;
+  fPoint_t roi[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f } };
+  request.roi.assign(roi, roi + 3);
+  full_coverage_path_planner::packMap(testMap(), request);
+  return request;
+}
+
+/*
+ * Only obstacles survive packing, unknown and low-occupancy cells become free
+ */
+TEST(TestRequestRecorder, testPackMap)
+{
+  RecordedRequest request = testRequest();
+  EXPECT_EQ(2u, request.obstacles.size());
+  nav_msgs::OccupancyGrid map;
+  full_coverage_path_planner::unpackMap(request, map);
+  EXPECT_EQ(5u, map.info.width);
+  EXPECT_EQ(3u, map.info.height);
+  EXPECT_FLOAT_EQ(0.1, map.info.resolution);
+  EXPECT_DOUBLE_EQ(-1.0, map.info.origin.position.x);
+  EXPECT_DOUBLE_EQ(2.0, map.info.origin.position.y);
+  int8_t expected[] = { 0, 100, 0, 100, 0, 0, 0, 0, 0, 0, 100, 100, 100, 100, 100 };
+  ASSERT_EQ(15u, map.data.size());
+  for (int i = 0; i < 15; ++i)
+  {
+    EXPECT_EQ(expected[i], map.data[i]) << "cell " << i;
+  }
+}
+
+TEST(TestRequestRecorder, testWriteRead)
+{
+  std::string file = testDirectory() + ".fcppreq";
+  RecordedRequest written = testRequest();
+  ASSERT_TRUE(full_coverage_path_planner::writeRequest(file, written));
+
+  RecordedRequest read;
+  ASSERT_TRUE(full_coverage_path_planner::readRequest(file, read));
+  EXPECT_DOUBLE_EQ(1.5, read.header.start_x);
+  EXPECT_DOUBLE_EQ(-0.5, read.header.start_y);
+  EXPECT_DOUBLE_EQ(0.25, read.header.start_yaw);
+  EXPECT_DOUBLE_EQ(0.2, read.header.tool_radius);
+  EXPECT_EQ(full_coverage_path_planner::eJoinMwm, read.header.join_style);
+  EXPECT_EQ(full_coverage_path_planner::eRecordedContour, read.header.coverage_engine);
+  EXPECT_EQ(1, read.header.sparse_grid);
+  ASSERT_EQ(3u, read.roi.size());
+  EXPECT_FLOAT_EQ(1.0f, read.roi[2].y);
+  EXPECT_EQ(written.obstacles, read.obstacles);
+  remove(file.c_str());
+
+  EXPECT_FALSE(full_coverage_path_planner::readRequest("/nonexistent.fcppreq", read));
+}
+
+/*
+ * The recorder overwrites the oldest request, also after it is reopened
+ */
+TEST(TestRequestRecorder, testRollingBuffer)
+{
+  std::string directory = testDirectory();
+  RequestRecorder recorder;
+  EXPECT_FALSE(recorder.isOpen());
+  ASSERT_TRUE(recorder.open(directory, 3));
+  RecordedRequest request = testRequest();
+  EXPECT_EQ(directory + "/request_0.fcppreq", recorder.record(request));
+  EXPECT_EQ(directory + "/request_1.fcppreq", recorder.record(request));
+  EXPECT_EQ(directory + "/request_2.fcppreq", recorder.record(request));
+  EXPECT_EQ(directory + "/request_0.fcppreq", recorder.record(request));
+
+  RequestRecorder reopened;
+  ASSERT_TRUE(reopened.open(directory, 3));
+  EXPECT_EQ(directory + "/request_1.fcppreq", reopened.record(request));
+
+  for (int i = 0; i < 3; ++i)
+  {
+    std::stringstream file;
+    file << directory << "/request_" << i << ".fcppreq";
+    remove(file.str().c_str());
+  }
+  rmdir(directory.c_str());
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
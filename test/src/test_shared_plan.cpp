@@ -0,0 +1,130 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * Tests for the shared-memory plan transport
+ */
+#include <unistd.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <full_coverage_path_planner/shared_plan.h>
+
+using full_coverage_path_planner::SharedPlanPose;
+using full_coverage_path_planner::SharedPlanReader;
+using full_coverage_path_planner::SharedPlanSlotRef;
+using full_coverage_path_planner::SharedPlanWriter;
+
+std::string testShmName()
+{
+  std::stringstream name;
+  name << "/test_shared_plan_" << getpid();
+  return name.str();
+}
+
+SharedPlanSlotRef writePlan(SharedPlanWriter& writer, uint32_t pose_count, double offset)
+{
+  SharedPlanSlotRef ref;
+  SharedPlanPose* poses = writer.beginWrite(pose_count, ref);
+  EXPECT_TRUE(poses != NULL);
+  for (uint32_t i = 0; i < pose_count; ++i)
+  {
+    poses[i].x = offset + i;
+    poses[i].y = -offset;
+    poses[i].yaw = 0.5;
+  }
+  writer.commit(ref);
+  return ref;
+}
+
+/*
+ * A plan written by the writer can be read in place by a reader that maps the same segment
+ */
+TEST(TestSharedPlan, testWriteRead)
+{
+  SharedPlanWriter writer;
+  ASSERT_TRUE(writer.open(testShmName(), 2, 100));
+  SharedPlanReader reader;
+  ASSERT_TRUE(reader.open(testShmName()));
+
+  SharedPlanSlotRef latest;
+  EXPECT_FALSE(reader.latest(latest));  // Nothing written yet
+
+  SharedPlanSlotRef ref = writePlan(writer, 100, 10.0);
+  SharedPlanPose const* poses = reader.poses(ref);
+  ASSERT_TRUE(poses != NULL);
+  EXPECT_DOUBLE_EQ(10.0, poses[0].x);
+  EXPECT_DOUBLE_EQ(109.0, poses[99].x);
+  EXPECT_DOUBLE_EQ(-10.0, poses[99].y);
+  EXPECT_TRUE(reader.valid(ref));
+
+  ASSERT_TRUE(reader.latest(latest));
+  EXPECT_EQ(ref.slot, latest.slot);
+  EXPECT_EQ(ref.sequence, latest.sequence);
+  EXPECT_EQ(100, latest.pose_count);
+
+  std::vector<SharedPlanPose> copy;
+  ASSERT_TRUE(reader.copy(ref, copy));
+  EXPECT_EQ(100, copy.size());
+}
+
+/*
+ * A plan stays readable until slot_count newer plans have been written
+ */
+TEST(TestSharedPlan, testRingBufferOverwrite)
+{
+  SharedPlanWriter writer;
+  ASSERT_TRUE(writer.open(testShmName(), 2, 10));
+  SharedPlanReader reader;
+  ASSERT_TRUE(reader.open(testShmName()));
+
+  SharedPlanSlotRef first = writePlan(writer, 5, 1.0);
+  SharedPlanSlotRef second = writePlan(writer, 5, 2.0);
+  EXPECT_NE(first.slot, second.slot);
+  EXPECT_TRUE(reader.valid(first));
+  EXPECT_TRUE(reader.valid(second));
+
+  writePlan(writer, 5, 3.0);
+  EXPECT_FALSE(reader.valid(first));
+  EXPECT_TRUE(reader.poses(first) == NULL);
+  EXPECT_TRUE(reader.valid(second));
+  EXPECT_DOUBLE_EQ(2.0, reader.poses(second)[0].x);
+}
+
+/*
+ * Plans larger than a slot are refused, so the planner can fall back to the topic
+ */
+TEST(TestSharedPlan, testPlanTooLarge)
+{
+  SharedPlanWriter writer;
+  ASSERT_TRUE(writer.open(testShmName(), 2, 10));
+  SharedPlanSlotRef ref;
+  EXPECT_TRUE(writer.beginWrite(11, ref) == NULL);
+  EXPECT_TRUE(writer.beginWrite(10, ref) != NULL);
+}
+
+/*
+ * Readers cannot open a segment that does not exist (anymore)
+ */
+TEST(TestSharedPlan, testSegmentRemovedOnClose)
+{
+  {
+    SharedPlanWriter writer;
+    ASSERT_TRUE(writer.open(testShmName(), 1, 10));
+  }
+  SharedPlanReader reader;
+  EXPECT_FALSE(reader.open(testShmName()));
+  EXPECT_FALSE(reader.isOpen());
+}
+
+// Run all the tests that were declared with TEST()
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
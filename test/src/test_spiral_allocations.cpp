@@ -0,0 +1,113 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * Planning with a reused workspace must give the same path as the plain spiral_stc and must not allocate once the
+ * workspace has grown to the grid. Allocations are counted with AllocationCounter.
+ */
+#include <stdlib.h>
+
+#include <list>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <full_coverage_path_planner/allocation_counter.h>
+#include <full_coverage_path_planner/common.h>
+#include <full_coverage_path_planner/spiral_stc.h>
+#include <full_coverage_path_planner/util.h>
+
+namespace
+{
+/*
+ * Grid with a fixed pseudo-random fraction of obstacles and some walls, so the spiral needs A* to get out
+ */
+std::vector<std::vector<bool> > makeObstacleGrid(int width, int height, unsigned int seed)
+{
+  std::vector<std::vector<bool> > grid = makeTestGrid(width, height, false);
+  for (int i = 0; i < width * height / 5; ++i)
+  {
+    grid[rand_r(&seed) % height][rand_r(&seed) % width] = true;
+  }
+  for (int y = 0; y < height - 3; ++y)
+  {
+    grid[y][width / 3] = true;
+    grid[height - 1 - y][2 * width / 3] = true;
+  }
+  grid[0][0] = false;
+  return grid;
+}
+}  // namespace
+
+/*
+ * The counter sees allocations at all
+ */
+TEST(TestSpiralAllocations, testCounter)
+{
+  AllocationCounter counter;
+  std::list<int> values(3, 0);
+  EXPECT_EQ(3u, counter.count());
+}
+
+/*
+ * The workspace version finds exactly the same path and counters as the plain version
+ */
+TEST(TestSpiralAllocations, testSameAsSpiralStc)
+{
+  full_coverage_path_planner::SpiralWorkspace workspace;
+  std::vector<Point_t> path;
+  for (unsigned int seed = 1; seed <= 20; ++seed)
+  {
+    std::vector<std::vector<bool> > grid = makeObstacleGrid(10 + seed, 30 - seed, seed);
+    Point_t start = { 0, 0 };
+    int multiple_pass_counter, visited_counter;
+    std::list<Point_t> expected = full_coverage_path_planner::SpiralSTC::spiral_stc(grid, start,
+                                                                                    multiple_pass_counter,
+                                                                                    visited_counter);
+    int workspace_multiple_pass_counter, workspace_visited_counter;
+    full_coverage_path_planner::SpiralSTC::spiral_stc(grid, start, workspace, path, workspace_multiple_pass_counter,
+                                                      workspace_visited_counter);
+    ASSERT_EQ(expected.size(), path.size()) << "seed " << seed;
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), path.begin())) << "seed " << seed;
+    EXPECT_EQ(multiple_pass_counter, workspace_multiple_pass_counter) << "seed " << seed;
+    EXPECT_EQ(visited_counter, workspace_visited_counter) << "seed " << seed;
+  }
+}
+
+/*
+ * After a warm-up run, planning again on the same grid does not allocate
+ */
+TEST(TestSpiralAllocations, testNoAllocationsAfterWarmUp)
+{
+  std::vector<std::vector<bool> > grid = makeObstacleGrid(60, 40, 42);
+  Point_t start = { 0, 0 };
+  full_coverage_path_planner::SpiralWorkspace workspace;
+  std::vector<Point_t> path;
+  int multiple_pass_counter, visited_counter;
+  full_coverage_path_planner::SpiralSTC::spiral_stc(grid, start, workspace, path, multiple_pass_counter,
+                                                    visited_counter);
+  size_t warm_up_size = path.size();
+  EXPECT_GT(multiple_pass_counter, 0);  // A* was needed
+
+  for (int i = 0; i < 3; ++i)
+  {
+    AllocationCounter counter;
+    full_coverage_path_planner::SpiralSTC::spiral_stc(grid, start, workspace, path, multiple_pass_counter,
+                                                      visited_counter);
+    EXPECT_EQ(0u, counter.count());
+  }
+  EXPECT_EQ(warm_up_size, path.size());
+
+  // The plain version allocates per node
+  AllocationCounter counter;
+  std::list<Point_t> listPath = full_coverage_path_planner::SpiralSTC::spiral_stc(grid, start, multiple_pass_counter,
+                                                                                  visited_counter);
+  EXPECT_GT(counter.count(), listPath.size());
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
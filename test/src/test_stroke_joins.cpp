@@ -0,0 +1,155 @@
+//
+// Copyright [2020] Nobleo Technology"  [legal/copyright]
+//
+
+/*
+ * Tests for the smoothing of the joins between the strokes of a coverage plan
+ */
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <full_coverage_path_planner/stroke_joins.h>
+
+using full_coverage_path_planner::StrokeJoinParams;
+using full_coverage_path_planner::Waypoint;
+
+StrokeJoinParams makeParams(full_coverage_path_planner::JoinStyle style)
+{
+  StrokeJoinParams params;
+  params.style = style;
+  params.turn_radius = 0.5;
+  params.u_turn_width = 1.0;
+  params.spacing = 0.1;
+  params.v_depth = 1.0;
+  params.v_bottom_off_center = 0.0;
+  return params;
+}
+
+std::vector<Waypoint> makePath(double const coordinates[][2], int n)
+{
+  std::vector<Waypoint> path;
+  for (int i = 0; i < n; ++i)
+  {
+    Waypoint w = { coordinates[i][0], coordinates[i][1], 0.0 };
+    path.push_back(w);
+  }
+  return path;
+}
+
+/*
+ * Without joins, every corner is emitted twice: once with the incoming and once with the outgoing heading
+ */
+TEST(TestStrokeJoins, testNoJoinsKeepsCorners)
+{
+  double coordinates[][2] = { { 0, 0 }, { 0, 2 }, { 0, 2 }, { 2, 2 } };  // NOLINT
+  std::vector<Waypoint> path = makePath(coordinates, 4);
+  path[0].yaw = M_PI;  // Robot starts facing backwards
+
+  std::vector<Waypoint> smoothed = smoothStrokeJoins(path, makeParams(full_coverage_path_planner::eJoinNone));
+
+  ASSERT_EQ(5, smoothed.size());
+  EXPECT_DOUBLE_EQ(M_PI, smoothed[0].yaw);  // Start heading is kept
+  EXPECT_DOUBLE_EQ(M_PI / 2, smoothed[1].yaw);  // Turn towards the first stroke
+  EXPECT_DOUBLE_EQ(2.0, smoothed[2].y);
+  EXPECT_DOUBLE_EQ(M_PI / 2, smoothed[2].yaw);
+  EXPECT_DOUBLE_EQ(2.0, smoothed[3].y);
+  EXPECT_DOUBLE_EQ(0.0, smoothed[3].yaw);
+  EXPECT_DOUBLE_EQ(2.0, smoothed[4].x);
+}
+
+/*
+ * A 90 degree corner is replaced by a fillet: all poses in between lie on a circle around the fillet center
+ */
+TEST(TestStrokeJoins, testFillet)
+{
+  double coordinates[][2] = { { 0, 0 }, { 0, 2 }, { 2, 2 } };  // NOLINT
+  std::vector<Waypoint> smoothed = smoothStrokeJoins(makePath(coordinates, 3),
+                                                     makeParams(full_coverage_path_planner::eJoinHalfCircle));
+
+  ASSERT_GT(smoothed.size(), 5);
+  EXPECT_DOUBLE_EQ(2.0, smoothed.back().x);
+  EXPECT_DOUBLE_EQ(2.0, smoothed.back().y);
+  for (unsigned int i = 2; i + 1 < smoothed.size(); ++i)
+  {
+    // Arc of radius 0.5 around (0.5, 1.5) and never through the corner itself
+    double r = std::hypot(smoothed[i].x - 0.5, smoothed[i].y - 1.5);
+    EXPECT_NEAR(0.5, r, 1e-9);
+    EXPECT_GT(std::hypot(smoothed[i].x, smoothed[i].y - 2.0), 0.1);
+    // Consecutive poses on the arc are not further apart than the spacing
+    if (i > 2)
+    {
+      EXPECT_LE(std::hypot(smoothed[i].x - smoothed[i - 1].x, smoothed[i].y - smoothed[i - 1].y), 0.1 + 1e-9);
+    }
+  }
+}
+
+/*
+ * Two 90 degree turns one stroke width apart form a 180 degree turn that is replaced by a half circle
+ */
+TEST(TestStrokeJoins, testHalfCircle)
+{
+  double coordinates[][2] = { { 0, 0 }, { 0, 2 }, { 1, 2 }, { 1, 0 } };  // NOLINT
+  std::vector<Waypoint> smoothed = smoothStrokeJoins(makePath(coordinates, 4),
+                                                     makeParams(full_coverage_path_planner::eJoinHalfCircle));
+
+  double max_y = 0.0;
+  for (unsigned int i = 0; i < smoothed.size(); ++i)
+  {
+    if (smoothed[i].y > 2.0 - 1e-9)
+    {
+      EXPECT_NEAR(0.5, std::hypot(smoothed[i].x - 0.5, smoothed[i].y - 2.0), 1e-9);
+    }
+    max_y = std::max(max_y, smoothed[i].y);
+  }
+  EXPECT_NEAR(2.5, max_y, 1e-9);  // Top of the half circle
+  EXPECT_DOUBLE_EQ(1.0, smoothed.back().x);
+  EXPECT_DOUBLE_EQ(0.0, smoothed.back().y);
+  EXPECT_NEAR(-M_PI / 2, smoothed.back().yaw, 1e-9);
+}
+
+/*
+ * An M/W join puts the bottom of a V between the strokes, pointing back along the strokes
+ */
+TEST(TestStrokeJoins, testMwm)
+{
+  double coordinates[][2] = { { 0, 0 }, { 0, 2 }, { 1, 2 }, { 1, 0 } };  // NOLINT
+  std::vector<Waypoint> smoothed = smoothStrokeJoins(makePath(coordinates, 4),
+                                                     makeParams(full_coverage_path_planner::eJoinMwm));
+
+  bool found_v = false;
+  for (unsigned int i = 0; i < smoothed.size(); ++i)
+  {
+    if (std::fabs(smoothed[i].x - 0.5) < 1e-9 && std::fabs(smoothed[i].y - 1.0) < 1e-9)
+    {
+      found_v = true;
+    }
+  }
+  EXPECT_TRUE(found_v);
+  EXPECT_DOUBLE_EQ(1.0, smoothed.back().x);
+  EXPECT_DOUBLE_EQ(0.0, smoothed.back().y);
+}
+
+/*
+ * Strokes that are further apart than the U-turn width get two fillets instead of a half circle
+ */
+TEST(TestStrokeJoins, testWideTurnUsesFillets)
+{
+  double coordinates[][2] = { { 0, 0 }, { 0, 2 }, { 3, 2 }, { 3, 0 } };  // NOLINT
+  std::vector<Waypoint> smoothed = smoothStrokeJoins(makePath(coordinates, 4),
+                                                     makeParams(full_coverage_path_planner::eJoinHalfCircle));
+
+  for (unsigned int i = 0; i < smoothed.size(); ++i)
+  {
+    EXPECT_LE(smoothed[i].y, 2.0 + 1e-9);
+  }
+}
+
+// Run all the tests that were declared with TEST()
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}